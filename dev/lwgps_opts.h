@@ -40,5 +40,29 @@
  * Open "include/lwgps/lwgps_opt.h" and
  * copy & replace here settings you want to change values
  */
+#define LWGPS_CFG_STATUS          1
+#define LWGPS_CFG_ODOMETER        1
+#define LWGPS_CFG_REPORT_FILTER   1
+#define LWGPS_CFG_SIMPLIFY        1
+#define LWGPS_CFG_HISTORY         1
+#define LWGPS_CFG_UBX             1
+#define LWGPS_CFG_DEMUX           1
+#define LWGPS_CFG_AIS             1
+#define LWGPS_CFG_TAG             1
+#define LWGPS_CFG_CUSTOM          1
+#define LWGPS_CFG_FIELD_MASK      1
+#define LWGPS_CFG_LATENCY         1
+#define LWGPS_CFG_CHECKPOINT      1
+#define LWGPS_CFG_RUNTIME_MASK    1
+
+/* Test tick advances on every read, to get deterministic latencies */
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+extern uint32_t lwgps_dev_tick;
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#define LWGPS_CFG_LATENCY_GET_TICK() (++lwgps_dev_tick)
 
 #endif /* LWGPS_HDR_OPTS_H */
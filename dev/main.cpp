@@ -10,6 +10,7 @@
 
 /* External function */
 extern "C" void run_tests();
+void run_tests_cpp();
 
 Lwgps::Lwgps gps;
 
@@ -17,6 +18,7 @@ int
 main() {
     lwgps_float_t distance, bearing;
     run_tests();
+    run_tests_cpp();
 
     /* Calculate distance and bearing */
     lwgps_distance_bearing(40.6, -73.7, 48.3, 11.7, &distance, &bearing);
@@ -34,7 +34,8 @@ static void uart_irqhandler(void);
 
 int
 main() {
-    uint8_t rx;
+    lwgps_iovec_t iov[2];
+    size_t full;
 
     /* Init GPS */
     lwgps_init(&hgps);
@@ -48,11 +49,14 @@ main() {
         uart_irqhandler();
 
         /* Process all input data */
-        /* Read from buffer byte-by-byte and call processing function */
-        if (lwrb_get_full(&hgps_buff)) {        /* Check if anything in buffer now */
-            while (lwrb_read(&hgps_buff, &rx, 1) == 1) {
-                lwgps_process(&hgps, &rx, 1);   /* Process byte-by-byte */
-            }
+        /* Parse data in place, ring buffer holds it in up to 2 linear regions */
+        if ((full = lwrb_get_full(&hgps_buff)) > 0) { /* Check if anything in buffer now */
+            iov[0].data = lwrb_get_linear_block_read_address(&hgps_buff);
+            iov[0].len = lwrb_get_linear_block_read_length(&hgps_buff);
+            iov[1].data = hgps_buff_data;   /* Second region wraps to the beginning */
+            iov[1].len = full - iov[0].len;
+            lwgps_processv(&hgps, iov, 2);  /* Process both regions with single call */
+            lwrb_skip(&hgps_buff, full);    /* Release processed data */
         } else {
             /* Print all data after successful processing */
             printf("Latitude: %f degrees\r\n", hgps.latitude);
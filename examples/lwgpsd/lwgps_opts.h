@@ -0,0 +1,12 @@
+/**
+ * \file            lwgps_opts.h
+ * \brief           LwGPS configuration of Linux ingestion daemon
+ */
+#ifndef LWGPS_HDR_OPTS_H
+#define LWGPS_HDR_OPTS_H
+
+#define LWGPS_CFG_FIELD_MASK 1 /* Publish only when fix related fields change */
+#define LWGPS_CFG_TAG        1 /* Route datagrams by TAG block source */
+#define LWGPS_CFG_CHECKPOINT 1 /* Save and restore fix state on restart */
+
+#endif /* LWGPS_HDR_OPTS_H */
@@ -0,0 +1,453 @@
+/*
+ * Linux ingestion daemon for LwGPS
+ *
+ * Opens many serial ports, pseudo terminals and line framed UNIX or TCP sockets,
+ * reads them with non-blocking epoll into per-source buffers
+ * and feeds each source to its own GPS handle with one call per read.
+ * New fixes are published to standard output, one JSON object per line.
+ *
+ * Usage:   lwgpsd [-u] [-q] [-b baudrate] [-i idle] [-s shm] [-c checkpoint] source [source ...]
+ * Sources: /dev/ttyUSB0             serial port or pseudo terminal, set to raw mode
+ *          unix:/run/gps.sock       UNIX stream socket
+ *          tcp:127.0.0.1:2947       TCP stream socket
+ *          udp:127.0.0.1:4001       UDP socket, bound to local address
+ *          file:capture.nmea        capture file, only with io_uring backend
+ *          tcp-listen:0.0.0.0:10110 TCP listener, handle per connection
+ *          udp-listen:0.0.0.0:10110 UDP listener, handle per sender or TAG source
+ *
+ * Option -u selects io_uring backend instead of epoll, see lwgpsd_uring.c
+ * Option -i sets idle timeout in seconds of listener handles, see lwgpsd_net.c
+ * Option -s publishes fixes to shared memory fleet table, such as /lwgpsd, see lwgpsd_shm.c
+ * Option -q disables publishing to standard output
+ * Option -c restores fixes from checkpoint file on start and saves them every minute and on exit,
+ *           see lwgpsd_ckpt.c
+ *
+ * Test with pseudo terminal pair, such as:
+ *          socat pty,link=/tmp/gps0,raw - < capture.nmea
+ *          lwgpsd /tmp/gps0
+ */
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include "lwgpsd.h"
+
+#define CKPT_INTERVAL 60 /* Checkpoint interval in units of seconds */
+
+/* Fields, which trigger publishing of new fix */
+#define FIX_FIELDS                                                                                                     \
+    (LWGPS_FIELD_LATITUDE | LWGPS_FIELD_LONGITUDE | LWGPS_FIELD_TIME | LWGPS_FIELD_SPEED | LWGPS_FIELD_IS_VALID)
+
+static lwgpsd_source_t* sources[LWGPSD_MAX_SOURCES];
+static size_t sources_cnt;
+static volatile sig_atomic_t running = 1;
+static int quiet;
+static const char* ckpt;
+static time_t ckpt_time;
+
+/**
+ * \brief           Signal handler to stop the main loop
+ * \param[in]       sig: Signal number
+ */
+static void
+stop_handler(int sig) {
+    (void)sig;
+    running = 0;
+}
+
+/**
+ * \brief           Get termios speed from numeric baudrate
+ * \param[in]       baud: Baudrate
+ * \return          Speed constant, `B0` if not supported
+ */
+static speed_t
+baud_to_speed(long baud) {
+    switch (baud) {
+        case 4800: return B4800;
+        case 9600: return B9600;
+        case 19200: return B19200;
+        case 38400: return B38400;
+        case 57600: return B57600;
+        case 115200: return B115200;
+        case 230400: return B230400;
+        case 460800: return B460800;
+        case 921600: return B921600;
+        default: return B0;
+    }
+}
+
+/**
+ * \brief           Open serial port or pseudo terminal in raw, non-blocking mode
+ * \param[in]       path: Device path
+ * \param[in]       speed: Speed to set, `B0` to keep current one
+ * \return          File descriptor on success, `-1` otherwise
+ */
+static int
+open_tty(const char* path, speed_t speed) {
+    struct termios tio;
+    int fd;
+
+    if ((fd = open(path, O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC)) < 0) {
+        return -1;
+    }
+    if (tcgetattr(fd, &tio) == 0) {
+        cfmakeraw(&tio);
+        tio.c_cflag |= CLOCAL | CREAD;
+        if (speed != B0) {
+            cfsetispeed(&tio, speed);
+            cfsetospeed(&tio, speed);
+        }
+        tcsetattr(fd, TCSANOW, &tio);
+    }
+    return fd;
+}
+
+/**
+ * \brief           Connect to UNIX stream socket
+ * \param[in]       path: Socket path
+ * \return          File descriptor on success, `-1` otherwise
+ */
+static int
+open_unix(const char* path) {
+    struct sockaddr_un addr;
+    int fd;
+
+    if (strlen(path) >= sizeof(addr.sun_path)
+        || (fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0)) < 0) {
+        return -1;
+    }
+    memset(&addr, 0x00, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path);
+    if (connect(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0 && errno != EINPROGRESS) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/**
+ * \brief           Connect or bind TCP or UDP socket
+ * \param[in]       spec: Host and port, separated by last colon
+ * \param[in]       type: Socket type, `SOCK_STREAM` or `SOCK_DGRAM`
+ * \param[in]       passive: Set to `1` to bind, and listen for stream socket, `0` to connect
+ * \return          File descriptor on success, `-1` otherwise
+ */
+static int
+open_inet(const char* spec, int type, int passive) {
+    struct addrinfo hints, *res;
+    char host[256];
+    const char* port;
+    int fd = -1, on = 1, rcvbuf = 4 << 20;
+
+    if ((port = strrchr(spec, ':')) == NULL || (size_t)(port - spec) >= sizeof(host)) {
+        return -1;
+    }
+    memcpy(host, spec, (size_t)(port - spec));
+    host[port - spec] = '\0';
+    memset(&hints, 0x00, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = type;
+    hints.ai_flags = passive ? AI_PASSIVE : 0;
+    if (getaddrinfo(host, port + 1, &hints, &res) != 0) {
+        return -1;
+    }
+    if ((fd = socket(res->ai_family, type | SOCK_NONBLOCK | SOCK_CLOEXEC, 0)) >= 0) {
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+        if (type == SOCK_DGRAM) {
+            setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf)); /* Absorb bursts of many senders */
+        }
+        if (passive ? (bind(fd, res->ai_addr, res->ai_addrlen) < 0
+                       || (type == SOCK_STREAM && listen(fd, SOMAXCONN) < 0))
+                    : (connect(fd, res->ai_addr, res->ai_addrlen) < 0 && errno != EINPROGRESS)) {
+            close(fd);
+            fd = -1;
+        }
+    }
+    freeaddrinfo(res);
+    return fd;
+}
+
+/**
+ * \brief           Create and open source from command line specification
+ * \param[in]       spec: Source specification
+ * \param[in]       speed: Serial port speed
+ * \return          Source on success, `NULL` otherwise
+ */
+static lwgpsd_source_t*
+source_open(const char* spec, speed_t speed) {
+    lwgpsd_source_t* src;
+
+    if (sources_cnt >= LWGPSD_MAX_SOURCES || (src = calloc(1, sizeof(*src))) == NULL) {
+        return NULL;
+    }
+    if (!strncmp(spec, "unix:", 5)) {
+        src->type = LWGPSD_SRC_UNIX;
+        src->fd = open_unix(spec + 5);
+    } else if (!strncmp(spec, "tcp:", 4)) {
+        src->type = LWGPSD_SRC_TCP;
+        src->fd = open_inet(spec + 4, SOCK_STREAM, 0);
+    } else if (!strncmp(spec, "udp:", 4)) {
+        src->type = LWGPSD_SRC_UDP;
+        src->fd = open_inet(spec + 4, SOCK_DGRAM, 1);
+    } else if (!strncmp(spec, "tcp-listen:", 11)) {
+        src->type = LWGPSD_SRC_TCP_LISTEN;
+        src->fd = open_inet(spec + 11, SOCK_STREAM, 1);
+    } else if (!strncmp(spec, "udp-listen:", 11)) {
+        src->type = LWGPSD_SRC_UDP_LISTEN;
+        src->fd = open_inet(spec + 11, SOCK_DGRAM, 1);
+    } else if (!strncmp(spec, "file:", 5)) {
+        src->type = LWGPSD_SRC_FILE;
+        src->fd = open(spec + 5, O_RDONLY | O_CLOEXEC);
+    } else {
+        src->type = LWGPSD_SRC_TTY;
+        src->fd = open_tty(spec, speed);
+    }
+    if (src->fd < 0) {
+        fprintf(stderr, "lwgpsd: cannot open %s: %s\n", spec, strerror(errno));
+        free(src);
+        return NULL;
+    }
+    snprintf(src->name, sizeof(src->name), "%s", spec);
+    lwgps_init(&src->gps);
+    src->shm_row = -1;
+    if (src->type < LWGPSD_SRC_TCP_LISTEN) {
+        lwgpsd_shm_attach(src); /* Listeners have no fix, their handles get rows instead */
+    }
+    sources[sources_cnt++] = src;
+    return src;
+}
+
+/**
+ * \brief           Close source, it is kept in the table for statistics
+ * \param[in]       src: Source to close
+ */
+void
+lwgpsd_source_close(lwgpsd_source_t* src) {
+    fprintf(stderr, "lwgpsd: %s closed after %llu bytes\n", src->name, (unsigned long long)src->rx_bytes);
+    close(src->fd); /* Closing removes it from epoll set too */
+    src->fd = -1;
+}
+
+/**
+ * \brief           Read all available data from source
+ * \param[in]       src: Source with pending data
+ * \return          `1` if source is still opened, `0` if it has been closed
+ */
+static int
+source_read(lwgpsd_source_t* src) {
+    ssize_t len;
+
+    while ((len = read(src->fd, src->buff, sizeof(src->buff))) > 0) {
+        lwgpsd_feed(src, src->buff, (size_t)len);
+        if ((size_t)len < sizeof(src->buff)) {
+            return 1; /* Short read, nothing more is waiting */
+        }
+    }
+    if ((len < 0 && (errno == EAGAIN || errno == EINTR)) || (len == 0 && src->type == LWGPSD_SRC_UDP)) {
+        return 1; /* Empty datagram does not end UDP source */
+    }
+    lwgpsd_source_close(src); /* End of file, hang-up of pseudo terminal or error */
+    return 0;
+}
+
+/**
+ * \brief           Feed received data to GPS handle of the source and publish new fix
+ * \param[in]       src: Source
+ * \param[in]       data: Received data
+ * \param[in]       len: Length of data in units of bytes
+ */
+void
+lwgpsd_feed(lwgpsd_source_t* src, const void* data, size_t len) {
+    src->rx_bytes += len;
+    lwgps_process(&src->gps, data, len);
+    if (lwgps_fields_ack(&src->gps) & FIX_FIELDS) {
+        lwgpsd_shm_update(src);
+        if (!quiet) {
+            lwgpsd_publish(src);
+        }
+    }
+}
+
+/**
+ * \brief           Escape string for JSON output
+ *
+ *                  Names of TAG sources come from received data and may contain any character
+ *
+ * \param[out]      out: Output buffer
+ * \param[in]       size: Size of output buffer, escaped string is truncated to fit
+ * \param[in]       str: String to escape
+ * \return          Output buffer
+ */
+static const char*
+json_escape(char* out, size_t size, const char* str) {
+    size_t pos = 0;
+    unsigned char c;
+
+    for (; *str != '\0' && pos + 7 <= size; ++str) {
+        c = (unsigned char)*str;
+        if (c == '"' || c == '\\') {
+            out[pos++] = '\\';
+            out[pos++] = (char)c;
+        } else if (c < 0x20 || c >= 0x7F) {
+            pos += (size_t)snprintf(&out[pos], size - pos, "\\u%04x", (unsigned)c);
+        } else {
+            out[pos++] = (char)c;
+        }
+    }
+    out[pos] = '\0';
+    return out;
+}
+
+/**
+ * \brief           Publish current fix of the source
+ * \param[in]       src: Source
+ */
+void
+lwgpsd_publish(lwgpsd_source_t* src) {
+    const lwgps_t* gh = &src->gps;
+    char name[sizeof(src->name) * 6 + 1];
+
+    printf("{\"src\":\"%s\",\"date\":\"20%02u-%02u-%02u\",\"time\":\"%02u:%02u:%02u\",\"valid\":%u,"
+           "\"lat\":%.7f,\"lon\":%.7f,\"alt\":%.2f,\"speed\":%.3f,\"sats\":%u}\n",
+           json_escape(name, sizeof(name), src->name), (unsigned)gh->year, (unsigned)gh->month, (unsigned)gh->date,
+           (unsigned)gh->hours, (unsigned)gh->minutes, (unsigned)gh->seconds, (unsigned)gh->is_valid,
+           (double)gh->latitude, (double)gh->longitude, (double)gh->altitude, (double)gh->speed,
+           (unsigned)gh->sats_in_use);
+}
+
+/**
+ * \brief           Save checkpoint and report failure
+ */
+static void
+ckpt_save(void) {
+    if (!lwgpsd_ckpt_save(ckpt, sources, sources_cnt)) {
+        fprintf(stderr, "lwgpsd: cannot save checkpoint %s\n", ckpt);
+    }
+    ckpt_time = time(NULL);
+}
+
+/**
+ * \brief           Periodic housekeeping, called by backend about once per second
+ */
+void
+lwgpsd_tick(void) {
+    if (ckpt != NULL && time(NULL) - ckpt_time >= CKPT_INTERVAL) {
+        ckpt_save();
+    }
+}
+
+int
+main(int argc, char** argv) {
+    struct epoll_event ev, events[64];
+    struct sigaction sa;
+    speed_t speed = B0;
+    lwgpsd_source_t* src;
+    unsigned idle = 60;
+    int epfd = -1, uring = 0, opened = 0, n, i, opt;
+
+    while ((opt = getopt(argc, argv, "uqb:i:s:c:")) != -1) {
+        if (opt == 'u') {
+            uring = 1;
+            continue;
+        } else if (opt == 'q') {
+            quiet = 1;
+            continue;
+        } else if (opt == 'c') {
+            ckpt = optarg;
+            continue;
+        } else if (opt == 's') {
+            if (!lwgpsd_shm_open(optarg)) {
+                fprintf(stderr, "lwgpsd: cannot create shared memory %s: %s\n", optarg, strerror(errno));
+                return 1;
+            }
+            continue;
+        } else if (opt == 'b' && (speed = baud_to_speed(strtol(optarg, NULL, 10))) != B0) {
+            continue;
+        } else if (opt == 'i' && (idle = (unsigned)strtoul(optarg, NULL, 10)) > 0) {
+            continue;
+        }
+        fprintf(stderr, "usage: %s [-u] [-q] [-b baudrate] [-i idle] [-s shm] [-c checkpoint] source [source ...]\n",
+                argv[0]);
+        return 1;
+    }
+    if (!uring && (epfd = epoll_create1(EPOLL_CLOEXEC)) < 0) {
+        perror("epoll_create1");
+        return 1;
+    }
+    for (i = optind; i < argc; ++i) {
+        if ((src = source_open(argv[i], speed)) == NULL) {
+            continue;
+        }
+        if (uring && src->type < LWGPSD_SRC_TCP_LISTEN) {
+            ++opened;
+            continue;
+        }
+        ev.events = EPOLLIN | EPOLLRDHUP;
+        ev.data.ptr = src;
+        if (!uring && src->type != LWGPSD_SRC_FILE && epoll_ctl(epfd, EPOLL_CTL_ADD, src->fd, &ev) == 0) {
+            ++opened;
+        } else {
+            fprintf(stderr, "lwgpsd: %s is not supported by %s backend\n", src->name, uring ? "io_uring" : "epoll");
+            lwgpsd_source_close(src);
+        }
+    }
+    if (opened == 0) {
+        fprintf(stderr, "lwgpsd: no source opened\n");
+        return 1;
+    }
+    lwgpsd_net_init(epfd, idle);
+    if (ckpt != NULL && (n = lwgpsd_ckpt_load(ckpt, sources, sources_cnt)) >= 0) {
+        fprintf(stderr, "lwgpsd: %d sources restored from %s\n", n, ckpt);
+    }
+    ckpt_time = time(NULL);
+
+    memset(&sa, 0x00, sizeof(sa));
+    sa.sa_handler = stop_handler;
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+    setvbuf(stdout, NULL, _IOLBF, 0);
+
+    if (uring) {
+        n = lwgpsd_uring_run(sources, sources_cnt, &running);
+        if (ckpt != NULL) {
+            ckpt_save();
+        }
+        return n ? 0 : 1;
+    }
+    while (running && opened > 0) {
+        if ((n = epoll_wait(epfd, events, sizeof(events) / sizeof(events[0]), 1000)) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("epoll_wait");
+            break;
+        }
+        for (i = 0; i < n; ++i) {
+            src = events[i].data.ptr;
+            if (src->fd < 0) {
+                continue;
+            } else if (src->type >= LWGPSD_SRC_TCP_LISTEN) {
+                lwgpsd_net_read(src);
+            } else if (!source_read(src)) {
+                --opened;
+            }
+        }
+        lwgpsd_net_evict();
+        lwgpsd_tick();
+    }
+    if (ckpt != NULL) {
+        ckpt_save();
+    }
+    close(epfd);
+    return 0;
+}
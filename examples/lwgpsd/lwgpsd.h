@@ -0,0 +1,61 @@
+/**
+ * \file            lwgpsd.h
+ * \brief           Linux ingestion daemon for LwGPS
+ */
+#ifndef LWGPSD_HDR_H
+#define LWGPSD_HDR_H
+
+#include <signal.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "lwgps/lwgps.h"
+
+#define LWGPSD_MAX_SOURCES 256   /*!< Maximum number of opened sources */
+#define LWGPSD_BUFF_SIZE   4096  /*!< Size of per-source receive buffer */
+#define LWGPSD_MAX_PEERS   65536 /*!< Maximum number of handles in listener pool */
+
+/**
+ * \brief           Type of input source
+ */
+typedef enum {
+    LWGPSD_SRC_TTY,        /*!< Serial port or pseudo terminal */
+    LWGPSD_SRC_UNIX,       /*!< Line framed UNIX stream socket */
+    LWGPSD_SRC_TCP,        /*!< Line framed TCP stream socket */
+    LWGPSD_SRC_UDP,        /*!< Bound UDP socket, each datagram carries one or more lines */
+    LWGPSD_SRC_FILE,       /*!< Capture file, read with \ref lwgpsd_uring_run only */
+    LWGPSD_SRC_TCP_LISTEN, /*!< TCP listening socket, each connection gets handle from pool */
+    LWGPSD_SRC_UDP_LISTEN, /*!< UDP listening socket, each sender address or TAG source gets handle from pool */
+    LWGPSD_SRC_PEER,       /*!< Accepted connection or UDP sender, owned by listener pool */
+} lwgpsd_src_type_t;
+
+/**
+ * \brief           Input source with its own GPS handle and receive buffer
+ */
+typedef struct {
+    int fd;                         /*!< File descriptor, `-1` when closed */
+    lwgpsd_src_type_t type;         /*!< Source type */
+    char name[64];                  /*!< Name used in published fixes */
+    lwgps_t gps;                    /*!< GPS handle */
+    uint8_t buff[LWGPSD_BUFF_SIZE]; /*!< Receive buffer, reused for every read */
+    uint64_t rx_bytes;              /*!< Number of received bytes */
+    int32_t shm_row;                /*!< Row in shared memory fleet table, `-1` when not published */
+} lwgpsd_source_t;
+
+void lwgpsd_feed(lwgpsd_source_t* src, const void* data, size_t len);
+void lwgpsd_publish(lwgpsd_source_t* src);
+void lwgpsd_source_close(lwgpsd_source_t* src);
+void lwgpsd_tick(void);
+void lwgpsd_net_init(int epfd, unsigned idle_timeout);
+void lwgpsd_net_read(lwgpsd_source_t* src);
+void lwgpsd_net_evict(void);
+lwgpsd_source_t* lwgpsd_net_next(lwgpsd_source_t* prev, const uint8_t** key, size_t* key_len);
+lwgpsd_source_t* lwgpsd_net_restore(const uint8_t* key, size_t key_len, const char* name);
+int lwgpsd_shm_open(const char* name);
+void lwgpsd_shm_attach(lwgpsd_source_t* src);
+void lwgpsd_shm_detach(lwgpsd_source_t* src);
+void lwgpsd_shm_update(lwgpsd_source_t* src);
+int lwgpsd_ckpt_save(const char* path, lwgpsd_source_t** srcs, size_t cnt);
+int lwgpsd_ckpt_load(const char* path, lwgpsd_source_t** srcs, size_t cnt);
+int lwgpsd_uring_run(lwgpsd_source_t** srcs, size_t cnt, volatile sig_atomic_t* running);
+
+#endif /* LWGPSD_HDR_H */
@@ -0,0 +1,237 @@
+/*
+ * Checkpoint of Linux ingestion daemon
+ *
+ * Fix state of all sources and pooled listener handles is written to memory mapped file
+ * periodically and on shutdown, and restored on start, so consumers keep last fixes over restart.
+ *
+ * File format, all multi-byte values are little endian:
+ *
+ * - Header: magic `LGPD`, 16-bit format version, 16-bit reserved value, 32-bit number of records
+ * - Record: 8-bit kind, 8-bit key length, key, 8-bit name length, name,
+ *           16-bit checkpoint length, checkpoint written by `lwgps_checkpoint_save`
+ *
+ * Command line sources are matched by name, listener handles by their routing key.
+ * Sources with checkpoint longer than 16-bit length are skipped.
+ * File is written to temporary file first and renamed, to never leave partial checkpoint.
+ */
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "lwgpsd.h"
+
+#define CKPT_VERSION  1  /*!< File format version */
+#define CKPT_HDR_SIZE 12 /*!< Size of file header */
+#define CKPT_SOURCE   0  /*!< Record of command line source, matched by name */
+#define CKPT_POOLED   1  /*!< Record of listener handle, matched by routing key */
+
+/* Listening sockets have no fix of their own */
+#define CKPT_HAS_FIX(src) ((src)->type < LWGPSD_SRC_TCP_LISTEN)
+
+/* Checkpoint length is 16-bit value, records which do not fit are not written */
+#define CKPT_FITS(src) (lwgps_checkpoint_save(&(src)->gps, NULL, 0) <= 0xFFFF)
+
+/**
+ * \brief           Write little endian value
+ * \param[in,out]   pos: Write position, advanced by value size
+ * \param[in]       val: Value
+ * \param[in]       size: Size of value in units of bytes
+ */
+static void
+put(uint8_t** pos, uint32_t val, size_t size) {
+    for (; size > 0; --size, val >>= 8) {
+        *(*pos)++ = (uint8_t)val;
+    }
+}
+
+/**
+ * \brief           Read little endian value
+ * \param[in,out]   pos: Read position, advanced by value size
+ * \param[in]       size: Size of value in units of bytes
+ * \return          Value
+ */
+static uint32_t
+get(const uint8_t** pos, size_t size) {
+    uint32_t val = 0;
+    size_t i;
+
+    for (i = 0; i < size; ++i) {
+        val |= (uint32_t)*(*pos)++ << (8 * i);
+    }
+    return val;
+}
+
+/**
+ * \brief           Write single record
+ * \param[in,out]   pos: Write position
+ * \param[in]       src: Source
+ * \param[in]       kind: Record kind
+ * \param[in]       key: Routing key, `NULL` for command line source
+ * \param[in]       key_len: Length of routing key
+ */
+static void
+put_record(uint8_t** pos, const lwgpsd_source_t* src, uint8_t kind, const uint8_t* key, size_t key_len) {
+    size_t name_len = strlen(src->name), gps_len = lwgps_checkpoint_save(&src->gps, NULL, 0);
+
+    put(pos, kind, 1);
+    put(pos, (uint32_t)key_len, 1);
+    if (key_len > 0) {
+        memcpy(*pos, key, key_len);
+        *pos += key_len;
+    }
+    put(pos, (uint32_t)name_len, 1);
+    memcpy(*pos, src->name, name_len);
+    *pos += name_len;
+    put(pos, (uint32_t)gps_len, 2);
+    *pos += lwgps_checkpoint_save(&src->gps, *pos, gps_len);
+}
+
+/**
+ * \brief           Save fix state of all sources and listener handles
+ * \param[in]       path: Checkpoint file path
+ * \param[in]       srcs: Command line sources
+ * \param[in]       cnt: Number of command line sources
+ * \return          `1` on success, `0` otherwise
+ */
+int
+lwgpsd_ckpt_save(const char* path, lwgpsd_source_t** srcs, size_t cnt) {
+    char tmp[4096];
+    lwgpsd_source_t* src;
+    const uint8_t* key;
+    uint8_t *mem, *pos;
+    size_t i, key_len, size = CKPT_HDR_SIZE, records = 0;
+    int fd, ok;
+
+    for (i = 0; i < cnt; ++i) {
+        if (!CKPT_HAS_FIX(srcs[i]) || !CKPT_FITS(srcs[i])) {
+            continue;
+        }
+        ++records;
+        size += 5 + strlen(srcs[i]->name) + lwgps_checkpoint_save(&srcs[i]->gps, NULL, 0);
+    }
+    for (src = lwgpsd_net_next(NULL, &key, &key_len); src != NULL; src = lwgpsd_net_next(src, &key, &key_len)) {
+        if (!CKPT_FITS(src)) {
+            continue;
+        }
+        size += 5 + key_len + strlen(src->name) + lwgps_checkpoint_save(&src->gps, NULL, 0);
+        ++records;
+    }
+
+    snprintf(tmp, sizeof(tmp), "%s.tmp", path);
+    if ((fd = open(tmp, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644)) < 0) {
+        return 0;
+    }
+    if (ftruncate(fd, (off_t)size) < 0
+        || (mem = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)) == MAP_FAILED) {
+        close(fd);
+        unlink(tmp);
+        return 0;
+    }
+    pos = mem;
+    memcpy(pos, "LGPD", 4);
+    pos += 4;
+    put(&pos, CKPT_VERSION, 2);
+    put(&pos, 0, 2);
+    put(&pos, (uint32_t)records, 4);
+    for (i = 0; i < cnt; ++i) {
+        if (!CKPT_HAS_FIX(srcs[i]) || !CKPT_FITS(srcs[i])) {
+            continue;
+        }
+        put_record(&pos, srcs[i], CKPT_SOURCE, NULL, 0);
+    }
+    for (src = lwgpsd_net_next(NULL, &key, &key_len); src != NULL; src = lwgpsd_net_next(src, &key, &key_len)) {
+        if (CKPT_FITS(src)) {
+            put_record(&pos, src, CKPT_POOLED, key, key_len);
+        }
+    }
+    ok = msync(mem, size, MS_SYNC) == 0;
+    munmap(mem, size);
+    ok = ok && fsync(fd) == 0;
+    close(fd);
+    if (!ok || rename(tmp, path) < 0) {
+        unlink(tmp);
+        return 0;
+    }
+    return 1;
+}
+
+/**
+ * \brief           Restore fix state of sources and listener handles
+ *
+ *                  Must be called after command line sources are opened.
+ *                  Records of sources, which are not opened any more, are skipped
+ *
+ * \param[in]       path: Checkpoint file path
+ * \param[in]       srcs: Command line sources
+ * \param[in]       cnt: Number of command line sources
+ * \return          Number of restored sources, `-1` when file is missing or not valid
+ */
+int
+lwgpsd_ckpt_load(const char* path, lwgpsd_source_t** srcs, size_t cnt) {
+    struct stat st;
+    lwgpsd_source_t* src;
+    const uint8_t *mem, *pos, *end, *key, *name, *gps;
+    char name_str[sizeof(srcs[0]->name)];
+    size_t i, key_len, name_len, gps_len;
+    uint32_t records;
+    uint8_t kind;
+    int fd, restored = 0;
+
+    if ((fd = open(path, O_RDONLY | O_CLOEXEC)) < 0) {
+        return -1;
+    }
+    if (fstat(fd, &st) < 0 || st.st_size < CKPT_HDR_SIZE
+        || (mem = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0)) == MAP_FAILED) {
+        close(fd);
+        return -1;
+    }
+    close(fd);
+    pos = mem + 4;
+    end = mem + st.st_size;
+    if (memcmp(mem, "LGPD", 4) != 0 || get(&pos, 2) != CKPT_VERSION) {
+        munmap((void*)mem, (size_t)st.st_size);
+        return -1;
+    }
+    get(&pos, 2);
+    for (records = get(&pos, 4); records > 0 && end - pos >= 2; --records) {
+        kind = (uint8_t)get(&pos, 1);
+        key_len = get(&pos, 1);
+        key = pos;
+        if ((size_t)(end - pos) < key_len + 1) {
+            break;
+        }
+        pos += key_len;
+        name_len = get(&pos, 1);
+        name = pos;
+        if ((size_t)(end - pos) < name_len + 2 || name_len >= sizeof(name_str)) {
+            break;
+        }
+        pos += name_len;
+        gps_len = get(&pos, 2);
+        gps = pos;
+        if ((size_t)(end - pos) < gps_len) {
+            break;
+        }
+        pos += gps_len;
+
+        memcpy(name_str, name, name_len);
+        name_str[name_len] = '\0';
+        src = NULL;
+        if (kind == CKPT_SOURCE) {
+            for (i = 0; i < cnt && src == NULL; ++i) {
+                src = !strcmp(srcs[i]->name, name_str) ? srcs[i] : NULL;
+            }
+        } else if (kind == CKPT_POOLED) {
+            src = lwgpsd_net_restore(key, key_len, name_str);
+        }
+        if (src != NULL && lwgps_checkpoint_load(&src->gps, gps, gps_len)) {
+            lwgps_fields_ack(&src->gps); /* Restored fix goes to fleet table now, JSON is published on new data */
+            lwgpsd_shm_update(src);
+            ++restored;
+        }
+    }
+    munmap((void*)mem, (size_t)st.st_size);
+    return restored;
+}
@@ -0,0 +1,444 @@
+/*
+ * Network listener of Linux ingestion daemon
+ *
+ * Accepts TCP connections and receives UDP datagrams from many devices.
+ * Each TCP connection and each UDP sender address gets its own GPS handle from the pool.
+ * Datagram lines, starting with NMEA 4.x TAG block with source identification,
+ * are routed by TAG source instead, to separate devices behind the same gateway.
+ *
+ * Received data are fed to GPS handle directly from receive buffer, without intermediate copies.
+ * Datagrams are received in batches with single system call.
+ * Handles are kept in least recently used order and evicted after idle timeout,
+ * or when pool is full and new source arrives.
+ */
+#define _GNU_SOURCE
+#include <errno.h>
+#include <netdb.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+#include "lwgpsd.h"
+
+#define NET_BATCH    64   /*!< Number of datagrams received with single system call */
+#define NET_DGRAM    2048 /*!< Maximum datagram size */
+#define NET_KEY_SIZE 32   /*!< Maximum size of routing key */
+
+_Static_assert(LWGPS_CFG_TAG_SRC_LEN < NET_KEY_SIZE, "TAG source must fit routing key");
+
+/**
+ * \brief           Pooled source of network listener
+ */
+typedef struct peer {
+    lwgpsd_source_t src;              /*!< Source, must be first member as it is used as epoll event pointer */
+    uint8_t key[NET_KEY_SIZE];        /*!< Routing key, sender address or TAG source */
+    uint8_t key_len;                  /*!< Length of routing key */
+    uint32_t hash;                    /*!< Hash of routing key */
+    time_t last_rx;                   /*!< Time of last received data */
+    struct peer* next;                /*!< Next peer in hash bucket or in free list */
+    struct peer *lru_prev, *lru_next; /*!< Neighbours in least recently used list */
+} peer_t;
+
+static peer_t* buckets[LWGPSD_MAX_PEERS];
+static peer_t *lru_head, *lru_tail; /* Most and least recently used peer */
+static peer_t* free_list;
+static size_t peers_cnt;
+static int net_epfd = -1;
+static unsigned net_idle = 60;
+
+static uint8_t dgram_buff[NET_BATCH][NET_DGRAM];
+static struct sockaddr_storage dgram_addr[NET_BATCH];
+
+/**
+ * \brief           Get current monotonic time
+ * \return          Time in units of seconds
+ */
+static time_t
+now_sec(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec;
+}
+
+/**
+ * \brief           Calculate FNV-1a hash of routing key
+ * \param[in]       key: Key
+ * \param[in]       len: Length of key
+ * \return          Hash value
+ */
+static uint32_t
+key_hash(const uint8_t* key, size_t len) {
+    uint32_t h = 2166136261UL;
+
+    while (len-- > 0) {
+        h = (h ^ *key++) * 16777619UL;
+    }
+    return h;
+}
+
+/**
+ * \brief           Build routing key from sender address
+ * \param[out]      key: Key buffer of \ref NET_KEY_SIZE bytes
+ * \param[in]       proto: Protocol name, its first character separates TCP and UDP keys
+ * \param[in]       addr: Sender address
+ * \return          Length of key, `0` for unsupported address family
+ */
+static size_t
+key_from_addr(uint8_t* key, const char* proto, const struct sockaddr_storage* addr) {
+    const struct sockaddr_in* in4 = (const struct sockaddr_in*)addr;
+    const struct sockaddr_in6* in6 = (const struct sockaddr_in6*)addr;
+
+    key[0] = (uint8_t)proto[0];
+    if (addr->ss_family == AF_INET) {
+        memcpy(&key[1], &in4->sin_port, 2);
+        memcpy(&key[3], &in4->sin_addr, 4);
+        return 7;
+    } else if (addr->ss_family == AF_INET6) {
+        memcpy(&key[1], &in6->sin6_port, 2);
+        memcpy(&key[3], &in6->sin6_addr, 16);
+        return 19;
+    }
+    return 0;
+}
+
+/**
+ * \brief           Unlink peer from least recently used list
+ * \param[in]       p: Peer
+ */
+static void
+lru_unlink(peer_t* p) {
+    *(p->lru_prev != NULL ? &p->lru_prev->lru_next : &lru_head) = p->lru_next;
+    *(p->lru_next != NULL ? &p->lru_next->lru_prev : &lru_tail) = p->lru_prev;
+    p->lru_prev = p->lru_next = NULL;
+}
+
+/**
+ * \brief           Mark peer as most recently used
+ * \param[in]       p: Peer
+ * \param[in]       now: Current time
+ */
+static void
+lru_touch(peer_t* p, time_t now) {
+    p->last_rx = now;
+    if (lru_head == p) {
+        return;
+    }
+    if (p->lru_prev != NULL || lru_tail == p) {
+        lru_unlink(p);
+    }
+    p->lru_next = lru_head;
+    *(lru_head != NULL ? &lru_head->lru_prev : &lru_tail) = p;
+    lru_head = p;
+}
+
+/**
+ * \brief           Close peer and return its handle to the pool
+ * \param[in]       p: Peer
+ * \param[in]       reason: Reason written to log
+ */
+static void
+peer_free(peer_t* p, const char* reason) {
+    peer_t** pp;
+
+    fprintf(stderr, "lwgpsd: %s %s after %llu bytes\n", p->src.name, reason, (unsigned long long)p->src.rx_bytes);
+    if (p->src.fd >= 0) {
+        close(p->src.fd); /* Closing removes it from epoll set too */
+        p->src.fd = -1;
+    }
+    for (pp = &buckets[p->hash & (LWGPSD_MAX_PEERS - 1)]; *pp != NULL; pp = &(*pp)->next) {
+        if (*pp == p) {
+            *pp = p->next;
+            break;
+        }
+    }
+    lru_unlink(p);
+    lwgpsd_shm_detach(&p->src);
+    p->next = free_list;
+    free_list = p;
+    --peers_cnt;
+}
+
+/**
+ * \brief           Find peer by routing key or take new one from the pool
+ * \param[in]       key: Routing key
+ * \param[in]       key_len: Length of routing key
+ * \param[in]       now: Current time
+ * \param[out]      created: Set to `1` when new peer was taken from the pool
+ * \return          Peer, `NULL` if memory is exhausted
+ */
+static peer_t*
+peer_get(const uint8_t* key, size_t key_len, time_t now, int* created) {
+    uint32_t hash = key_hash(key, key_len);
+    peer_t* p;
+
+    *created = 0;
+    for (p = buckets[hash & (LWGPSD_MAX_PEERS - 1)]; p != NULL; p = p->next) {
+        if (p->hash == hash && p->key_len == key_len && !memcmp(p->key, key, key_len)) {
+            lru_touch(p, now);
+            return p;
+        }
+    }
+    if (peers_cnt >= LWGPSD_MAX_PEERS) {
+        peer_free(lru_tail, "evicted");
+    }
+    if ((p = free_list) != NULL) {
+        free_list = p->next;
+    } else if ((p = malloc(sizeof(*p))) == NULL) {
+        return NULL;
+    }
+    memset(p, 0x00, sizeof(*p));
+    memcpy(p->key, key, key_len);
+    p->key_len = (uint8_t)key_len;
+    p->hash = hash;
+    p->src.fd = -1;
+    p->src.type = LWGPSD_SRC_PEER;
+    p->src.shm_row = -1;
+    lwgps_init(&p->src.gps);
+    p->next = buckets[hash & (LWGPSD_MAX_PEERS - 1)];
+    buckets[hash & (LWGPSD_MAX_PEERS - 1)] = p;
+    lru_touch(p, now);
+    ++peers_cnt;
+    *created = 1;
+    return p;
+}
+
+/**
+ * \brief           Find or create peer for sender address
+ * \param[in]       proto: Protocol name, used as name prefix
+ * \param[in]       addr: Sender address
+ * \param[in]       alen: Length of sender address
+ * \param[in]       now: Current time
+ * \return          Peer, `NULL` on failure
+ */
+static peer_t*
+peer_from_addr(const char* proto, const struct sockaddr_storage* addr, socklen_t alen, time_t now) {
+    uint8_t key[NET_KEY_SIZE];
+    char host[64], port[8];
+    size_t key_len;
+    peer_t* p;
+    int created;
+
+    if ((key_len = key_from_addr(key, proto, addr)) == 0 || (p = peer_get(key, key_len, now, &created)) == NULL) {
+        return NULL;
+    }
+    if (created) {
+        if (getnameinfo((const struct sockaddr*)addr, alen, host, sizeof(host), port, sizeof(port),
+                        NI_NUMERICHOST | NI_NUMERICSERV)
+            != 0) {
+            strcpy(host, "?");
+            strcpy(port, "?");
+        }
+        snprintf(p->src.name, sizeof(p->src.name), "%s:%s:%s", proto, host, port);
+        lwgpsd_shm_attach(&p->src);
+    }
+    return p;
+}
+
+/**
+ * \brief           Find or create peer for TAG block source
+ * \param[in]       tag_src: TAG block source identification
+ * \param[in]       now: Current time
+ * \return          Peer, `NULL` on failure
+ */
+static peer_t*
+peer_from_tag(const char* tag_src, time_t now) {
+    uint8_t key[NET_KEY_SIZE];
+    size_t len = strlen(tag_src);
+    peer_t* p;
+    int created;
+
+    key[0] = '\\';
+    memcpy(&key[1], tag_src, len);
+    if ((p = peer_get(key, len + 1, now, &created)) != NULL && created) {
+        snprintf(p->src.name, sizeof(p->src.name), "tag:%s", tag_src);
+        lwgpsd_shm_attach(&p->src);
+    }
+    return p;
+}
+
+/**
+ * \brief           Route datagram to GPS handles
+ *
+ *                  Datagram without TAG block is fed to handle of its sender as a whole.
+ *                  Otherwise it is split to lines and each line with TAG source
+ *                  is fed to handle of that source.
+ *
+ * \param[in]       addr: Sender address
+ * \param[in]       alen: Length of sender address
+ * \param[in]       data: Datagram
+ * \param[in]       len: Length of datagram
+ * \param[in]       now: Current time
+ */
+static void
+route_dgram(const struct sockaddr_storage* addr, socklen_t alen, const uint8_t* data, size_t len, time_t now) {
+    const uint8_t *line, *nl, *end = data + len;
+    lwgps_tag_t tag;
+    peer_t *p, *sender = NULL;
+
+    if (len == 0) {
+        return;
+    }
+    if (data[0] != '\\') {
+        if ((p = peer_from_addr("udp", addr, alen, now)) != NULL) {
+            lwgpsd_feed(&p->src, data, len);
+        }
+        return;
+    }
+    for (line = data; line < end; line = nl) {
+        nl = memchr(line, '\n', (size_t)(end - line));
+        nl = nl != NULL ? nl + 1 : end;
+        if (lwgps_tag_parse(line, (size_t)(nl - line), &tag) > 0 && tag.src[0] != '\0') {
+            p = peer_from_tag(tag.src, now);
+        } else {
+            if (sender == NULL) {
+                sender = peer_from_addr("udp", addr, alen, now);
+            }
+            p = sender;
+        }
+        if (p != NULL) {
+            lwgpsd_feed(&p->src, line, (size_t)(nl - line));
+        }
+    }
+}
+
+/**
+ * \brief           Set epoll instance and idle timeout of listener pool
+ * \param[in]       epfd: Epoll instance, accepted connections are added to it
+ * \param[in]       idle_timeout: Time in units of seconds, after which idle handle is evicted
+ */
+void
+lwgpsd_net_init(int epfd, unsigned idle_timeout) {
+    net_epfd = epfd;
+    net_idle = idle_timeout;
+}
+
+/**
+ * \brief           Handle readiness of listening socket or pooled connection
+ * \param[in]       src: Listener or peer source
+ */
+void
+lwgpsd_net_read(lwgpsd_source_t* src) {
+    struct mmsghdr msgs[NET_BATCH];
+    struct iovec iov[NET_BATCH];
+    struct sockaddr_storage addr;
+    struct epoll_event ev;
+    socklen_t alen;
+    peer_t* p;
+    time_t now = now_sec();
+    ssize_t len;
+    int fd, n, i;
+
+    if (src->type == LWGPSD_SRC_TCP_LISTEN) {
+        for (alen = sizeof(addr);
+             (fd = accept4(src->fd, (struct sockaddr*)&addr, &alen, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0;
+             alen = sizeof(addr)) {
+            if ((p = peer_from_addr("tcp", &addr, alen, now)) == NULL) {
+                close(fd);
+                continue;
+            }
+            if (p->src.fd >= 0) {
+                close(p->src.fd); /* Stale connection from the same address and port */
+            }
+            p->src.fd = fd;
+            ev.events = EPOLLIN | EPOLLRDHUP;
+            ev.data.ptr = &p->src;
+            if (epoll_ctl(net_epfd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+                peer_free(p, "rejected");
+            }
+        }
+    } else if (src->type == LWGPSD_SRC_UDP_LISTEN) {
+        do {
+            for (i = 0; i < NET_BATCH; ++i) {
+                iov[i].iov_base = dgram_buff[i];
+                iov[i].iov_len = NET_DGRAM;
+                memset(&msgs[i].msg_hdr, 0x00, sizeof(msgs[i].msg_hdr));
+                msgs[i].msg_hdr.msg_name = &dgram_addr[i];
+                msgs[i].msg_hdr.msg_namelen = sizeof(dgram_addr[i]);
+                msgs[i].msg_hdr.msg_iov = &iov[i];
+                msgs[i].msg_hdr.msg_iovlen = 1;
+            }
+            if ((n = recvmmsg(src->fd, msgs, NET_BATCH, MSG_DONTWAIT, NULL)) <= 0) {
+                break;
+            }
+            for (i = 0; i < n; ++i) {
+                src->rx_bytes += msgs[i].msg_len;
+                route_dgram(&dgram_addr[i], msgs[i].msg_hdr.msg_namelen, dgram_buff[i], msgs[i].msg_len, now);
+            }
+        } while (n == NET_BATCH);
+    } else if (src->type == LWGPSD_SRC_PEER) {
+        p = (peer_t*)src;
+        while ((len = read(src->fd, src->buff, sizeof(src->buff))) > 0) {
+            lru_touch(p, now);
+            lwgpsd_feed(src, src->buff, (size_t)len);
+            if ((size_t)len < sizeof(src->buff)) {
+                return; /* Short read, nothing more is waiting */
+            }
+        }
+        if (len < 0 && (errno == EAGAIN || errno == EINTR)) {
+            return;
+        }
+        peer_free(p, "closed");
+    }
+}
+
+/**
+ * \brief           Iterate pooled handles, which can be restored after restart
+ *
+ *                  Handles with open TCP connection are skipped, as connection does not survive restart
+ *
+ * \param[in]       prev: Previous handle, `NULL` to get the first one
+ * \param[out]      key: Routing key of returned handle
+ * \param[out]      key_len: Length of routing key
+ * \return          Next handle, `NULL` when there are no more
+ */
+lwgpsd_source_t*
+lwgpsd_net_next(lwgpsd_source_t* prev, const uint8_t** key, size_t* key_len) {
+    peer_t* p = prev != NULL ? ((peer_t*)prev)->lru_next : lru_head;
+
+    while (p != NULL && p->src.fd >= 0) {
+        p = p->lru_next;
+    }
+    if (p != NULL) {
+        *key = p->key;
+        *key_len = p->key_len;
+    }
+    return p != NULL ? &p->src : NULL;
+}
+
+/**
+ * \brief           Take handle from the pool for restored routing key
+ * \param[in]       key: Routing key, saved from \ref lwgpsd_net_next
+ * \param[in]       key_len: Length of routing key
+ * \param[in]       name: Source name
+ * \return          Handle to restore, `NULL` on failure
+ */
+lwgpsd_source_t*
+lwgpsd_net_restore(const uint8_t* key, size_t key_len, const char* name) {
+    peer_t* p;
+    int created;
+
+    if (key_len == 0 || key_len > NET_KEY_SIZE || (p = peer_get(key, key_len, now_sec(), &created)) == NULL) {
+        return NULL;
+    }
+    if (created) {
+        snprintf(p->src.name, sizeof(p->src.name), "%s", name);
+        lwgpsd_shm_attach(&p->src);
+    }
+    return &p->src;
+}
+
+/**
+ * \brief           Evict handles, idle for longer than timeout
+ */
+void
+lwgpsd_net_evict(void) {
+    time_t now = now_sec();
+
+    while (lru_tail != NULL && now - lru_tail->last_rx >= (time_t)net_idle) {
+        peer_free(lru_tail, "evicted");
+    }
+}
@@ -0,0 +1,160 @@
+/*
+ * Shared memory fleet table of Linux ingestion daemon
+ *
+ * Table is created with POSIX shared memory and mapped by readers,
+ * which get positions of all sources with no system calls or serialization.
+ * Each source is assigned its own row, rows of evicted listener handles are reused.
+ * Row is written between two increments of its sequence counter.
+ */
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+#include "lwgpsd.h"
+#include "lwgpsd_shm.h"
+
+_Static_assert(LWGPSD_SHM_ROWS >= LWGPSD_MAX_SOURCES + LWGPSD_MAX_PEERS, "Table must fit all sources");
+_Static_assert(LWGPSD_SHM_NAME_LEN >= sizeof(((lwgpsd_source_t*)0)->name), "Table must fit source names");
+
+static lwgpsd_shm_t* shm;
+static uint32_t free_rows[LWGPSD_SHM_ROWS]; /* Stack of released rows */
+static uint32_t free_cnt;
+
+/**
+ * \brief           Start writing the row, readers retry until \ref row_end
+ * \param[in]       row: Row index
+ */
+static void
+row_begin(uint32_t row) {
+    __atomic_store_n(&shm->seq[row], shm->seq[row] + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+/**
+ * \brief           Finish writing the row
+ * \param[in]       row: Row index
+ */
+static void
+row_end(uint32_t row) {
+    __atomic_store_n(&shm->seq[row], shm->seq[row] + 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * \brief           Write fix fields of the row
+ * \param[in]       row: Row index
+ * \param[in]       lat: Latitude in units of degrees
+ * \param[in]       lon: Longitude in units of degrees
+ * \param[in]       time: UTC time in units of seconds since epoch
+ * \param[in]       speed: Speed in units of knots
+ * \param[in]       valid: Fix validity
+ */
+static void
+row_write(uint32_t row, double lat, double lon, int64_t time, float speed, uint8_t valid) {
+    row_begin(row);
+    __atomic_store(&shm->lat[row], &lat, __ATOMIC_RELAXED);
+    __atomic_store(&shm->lon[row], &lon, __ATOMIC_RELAXED);
+    __atomic_store(&shm->time[row], &time, __ATOMIC_RELAXED);
+    __atomic_store(&shm->speed[row], &speed, __ATOMIC_RELAXED);
+    __atomic_store_n(&shm->valid[row], valid, __ATOMIC_RELAXED);
+    row_end(row);
+}
+
+/**
+ * \brief           Create shared memory fleet table
+ * \param[in]       name: Shared memory object name, such as `/lwgpsd`
+ * \return          `1` on success, `0` otherwise
+ */
+int
+lwgpsd_shm_open(const char* name) {
+    void* mem;
+    int fd;
+
+    shm_unlink(name); /* Start with empty table, readers of previous one keep their mapping */
+    if ((fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0644)) < 0) {
+        return 0;
+    }
+    if (ftruncate(fd, sizeof(*shm)) < 0
+        || (mem = mmap(NULL, sizeof(*shm), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)) == MAP_FAILED) {
+        close(fd);
+        return 0;
+    }
+    close(fd);
+    shm = mem; /* New object is zero filled */
+    shm->version = LWGPSD_SHM_VERSION;
+    shm->rows = LWGPSD_SHM_ROWS;
+    __atomic_store_n(&shm->magic, LWGPSD_SHM_MAGIC, __ATOMIC_RELEASE);
+    return 1;
+}
+
+/**
+ * \brief           Assign table row to source and publish its name
+ * \param[in]       src: Source with name already set
+ */
+void
+lwgpsd_shm_attach(lwgpsd_source_t* src) {
+    uint32_t row;
+
+    src->shm_row = -1;
+    if (shm == NULL) {
+        return;
+    }
+    if (free_cnt > 0) {
+        row = free_rows[--free_cnt];
+    } else if (shm->rows_used < LWGPSD_SHM_ROWS) {
+        row = shm->rows_used;
+    } else {
+        return;
+    }
+    row_begin(row);
+    memcpy(shm->name[row], src->name, sizeof(src->name));
+    row_end(row);
+    if (row == shm->rows_used) {
+        __atomic_store_n(&shm->rows_used, row + 1, __ATOMIC_RELEASE);
+    }
+    src->shm_row = (int32_t)row;
+}
+
+/**
+ * \brief           Clear table row of source and release it for reuse
+ * \param[in]       src: Source
+ */
+void
+lwgpsd_shm_detach(lwgpsd_source_t* src) {
+    uint32_t row;
+
+    if (shm == NULL || src->shm_row < 0) {
+        return;
+    }
+    row = (uint32_t)src->shm_row;
+    row_write(row, 0, 0, 0, 0, 0);
+    row_begin(row);
+    memset(shm->name[row], 0x00, sizeof(shm->name[row]));
+    row_end(row);
+    free_rows[free_cnt++] = row;
+    src->shm_row = -1;
+}
+
+/**
+ * \brief           Write current fix of the source to its table row
+ * \param[in]       src: Source
+ */
+void
+lwgpsd_shm_update(lwgpsd_source_t* src) {
+    const lwgps_t* gh = &src->gps;
+    struct tm tm;
+
+    if (shm == NULL || src->shm_row < 0) {
+        return;
+    }
+    memset(&tm, 0x00, sizeof(tm));
+    tm.tm_year = 100 + gh->year;
+    tm.tm_mon = gh->month > 0 ? gh->month - 1 : 0;
+    tm.tm_mday = gh->date > 0 ? gh->date : 1;
+    tm.tm_hour = gh->hours;
+    tm.tm_min = gh->minutes;
+    tm.tm_sec = gh->seconds;
+
+    row_write((uint32_t)src->shm_row, gh->latitude, gh->longitude, timegm(&tm), gh->speed, gh->is_valid);
+}
@@ -0,0 +1,75 @@
+/**
+ * \file            lwgpsd_shm.h
+ * \brief           Shared memory fleet table of Linux ingestion daemon
+ *
+ * Table is published by daemon and mapped read-only by any number of reader processes.
+ * Fields are stored as structure of arrays, indexed by row, with one row per source.
+ * Every row has sequence counter, odd while row is being written,
+ * readers retry when counter is odd or has changed during the read.
+ */
+#ifndef LWGPSD_SHM_HDR_H
+#define LWGPSD_SHM_HDR_H
+
+#include <stdint.h>
+
+#define LWGPSD_SHM_MAGIC    0x53465747UL /*!< Table magic number, set once table is initialized */
+#define LWGPSD_SHM_VERSION  1            /*!< Table layout version */
+#define LWGPSD_SHM_ROWS     65792        /*!< Number of rows, enough for all sources and listener handles */
+#define LWGPSD_SHM_NAME_LEN 64           /*!< Size of source name, including `NULL` termination */
+
+/**
+ * \brief           Shared memory fleet table
+ */
+typedef struct {
+    uint32_t magic;                                  /*!< \ref LWGPSD_SHM_MAGIC when table is ready */
+    uint32_t version;                                /*!< \ref LWGPSD_SHM_VERSION */
+    uint32_t rows;                                   /*!< Number of rows in arrays */
+    uint32_t rows_used;                              /*!< Rows above this index have never been used */
+    double lat[LWGPSD_SHM_ROWS];                     /*!< Latitude in units of degrees */
+    double lon[LWGPSD_SHM_ROWS];                     /*!< Longitude in units of degrees */
+    int64_t time[LWGPSD_SHM_ROWS];                   /*!< UTC time of fix in units of seconds since epoch */
+    float speed[LWGPSD_SHM_ROWS];                    /*!< Speed over ground in units of knots */
+    uint32_t seq[LWGPSD_SHM_ROWS];                   /*!< Row sequence counter, odd while row is being written */
+    uint8_t valid[LWGPSD_SHM_ROWS];                  /*!< `1` when fix is valid, `0` otherwise or when row is free */
+    char name[LWGPSD_SHM_ROWS][LWGPSD_SHM_NAME_LEN]; /*!< Source name, empty when row is free */
+} lwgpsd_shm_t;
+
+/**
+ * \brief           Consistent copy of single row
+ */
+typedef struct {
+    double lat;                     /*!< Latitude in units of degrees */
+    double lon;                     /*!< Longitude in units of degrees */
+    int64_t time;                   /*!< UTC time of fix in units of seconds since epoch */
+    float speed;                    /*!< Speed over ground in units of knots */
+    uint8_t valid;                  /*!< `1` when fix is valid */
+    char name[LWGPSD_SHM_NAME_LEN]; /*!< Source name, empty when row is free */
+} lwgpsd_shm_row_t;
+
+/**
+ * \brief           Read consistent copy of row, without system calls
+ * \param[in]       t: Mapped table
+ * \param[in]       row: Row index, lower than `rows_used`
+ * \param[out]      out: Row copy
+ * \return          Sequence number of the copy, changes whenever row is written
+ */
+static inline uint32_t
+lwgpsd_shm_read(const lwgpsd_shm_t* t, uint32_t row, lwgpsd_shm_row_t* out) {
+    uint32_t s1, s2;
+
+    do {
+        while ((s1 = __atomic_load_n(&t->seq[row], __ATOMIC_ACQUIRE)) & 1) {}
+        __atomic_load(&t->lat[row], &out->lat, __ATOMIC_RELAXED);
+        __atomic_load(&t->lon[row], &out->lon, __ATOMIC_RELAXED);
+        __atomic_load(&t->time[row], &out->time, __ATOMIC_RELAXED);
+        __atomic_load(&t->speed[row], &out->speed, __ATOMIC_RELAXED);
+        out->valid = __atomic_load_n(&t->valid[row], __ATOMIC_RELAXED);
+        __builtin_memcpy(out->name, (const char*)t->name[row], sizeof(out->name));
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        s2 = __atomic_load_n(&t->seq[row], __ATOMIC_RELAXED);
+    } while (s1 != s2);
+    out->name[sizeof(out->name) - 1] = '\0';
+    return s1;
+}
+
+#endif /* LWGPSD_SHM_HDR_H */
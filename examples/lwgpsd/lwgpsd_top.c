@@ -0,0 +1,81 @@
+/*
+ * Reader of shared memory fleet table, published by Linux ingestion daemon
+ *
+ * Table is mapped read-only, rows are read with their sequence counters,
+ * no system calls are needed after mapping and daemon is never blocked by readers.
+ *
+ * Usage:   lwgpsd_top [-i interval] [shm]
+ *          shm defaults to /lwgpsd, table is printed once unless interval in seconds is set
+ */
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+#include "lwgpsd_shm.h"
+
+/**
+ * \brief           Print all used rows of the table
+ * \param[in]       t: Mapped table
+ */
+static void
+print_table(const lwgpsd_shm_t* t) {
+    lwgpsd_shm_row_t r;
+    uint32_t i, used, cnt = 0;
+    struct tm tm;
+    time_t tt;
+    char ts[32];
+
+    used = __atomic_load_n(&t->rows_used, __ATOMIC_ACQUIRE);
+    for (i = 0; i < used; ++i) {
+        lwgpsd_shm_read(t, i, &r);
+        if (r.name[0] == '\0') {
+            continue; /* Free row */
+        }
+        tt = (time_t)r.time;
+        gmtime_r(&tt, &tm);
+        strftime(ts, sizeof(ts), "%Y-%m-%dT%H:%M:%SZ", &tm);
+        printf("%-32s %u %12.7f %13.7f %8.3f %s\n", r.name, (unsigned)r.valid, r.lat, r.lon, (double)r.speed, ts);
+        ++cnt;
+    }
+    printf("%u sources\n", (unsigned)cnt);
+}
+
+int
+main(int argc, char** argv) {
+    const lwgpsd_shm_t* t;
+    const char* name = "/lwgpsd";
+    unsigned interval = 0;
+    int fd, opt;
+
+    while ((opt = getopt(argc, argv, "i:")) != -1) {
+        if (opt == 'i') {
+            interval = (unsigned)strtoul(optarg, NULL, 10);
+            continue;
+        }
+        fprintf(stderr, "usage: %s [-i interval] [shm]\n", argv[0]);
+        return 1;
+    }
+    if (optind < argc) {
+        name = argv[optind];
+    }
+    if ((fd = shm_open(name, O_RDONLY, 0)) < 0) {
+        perror("shm_open");
+        return 1;
+    }
+    t = mmap(NULL, sizeof(*t), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (t == MAP_FAILED || __atomic_load_n(&t->magic, __ATOMIC_ACQUIRE) != LWGPSD_SHM_MAGIC
+        || t->version != LWGPSD_SHM_VERSION || t->rows != LWGPSD_SHM_ROWS) {
+        fprintf(stderr, "lwgpsd_top: %s is not compatible fleet table\n", name);
+        return 1;
+    }
+    do {
+        print_table(t);
+        if (interval > 0) {
+            sleep(interval);
+        }
+    } while (interval > 0);
+    return 0;
+}
@@ -0,0 +1,465 @@
+/*
+ * io_uring input backend of Linux ingestion daemon
+ *
+ * - Sockets use multishot receive with ring of provided buffers,
+ *   single request keeps delivering data until socket is closed
+ * - Capture files are read with window of fixed reads into registered buffers,
+ *   completions are fed to GPS handle in file order
+ * - Serial ports and pseudo terminals use plain reads into per-source buffer
+ *
+ * - Timeout request completes every second, to run periodic housekeeping, see \ref lwgpsd_tick
+ *
+ * All completions, available at once, are processed in a batch
+ * and new requests are submitted with single system call.
+ * Ring is set up with raw system calls, no external library is needed.
+ */
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <linux/time_types.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include "lwgpsd.h"
+
+#define URING_ENTRIES     256  /*!< Number of submission queue entries */
+#define URING_RECV_BGID   1    /*!< Group ID of provided receive buffers */
+#define URING_RECV_BUFS   512  /*!< Number of provided receive buffers, power of 2 */
+#define URING_RECV_SIZE   2048 /*!< Size of each receive buffer */
+#define URING_FILE_DEPTH  8    /*!< Number of reads in flight per capture file */
+#define URING_FILE_SIZE   65536 /*!< Size of each registered file buffer */
+#define URING_TICK_SEC    1    /*!< Period of housekeeping timeout in units of seconds */
+
+/**
+ * \brief           Kind of request
+ */
+typedef enum {
+    OP_RECV, /*!< Multishot receive on socket */
+    OP_READ, /*!< Single read from serial port or pseudo terminal */
+    OP_FILE, /*!< Fixed read from capture file */
+    OP_TICK, /*!< Housekeeping timeout, not bound to any source */
+} op_kind_t;
+
+struct uring_src;
+
+/**
+ * \brief           Request context, pointed by `user_data`
+ */
+typedef struct {
+    struct uring_src* us; /*!< Source of the request */
+    op_kind_t kind;       /*!< Kind of request */
+    uint16_t buf_index;   /*!< Registered buffer index, for file reads */
+    uint8_t done;         /*!< File read has completed, waiting to be processed in order */
+    int res;              /*!< Result of completed file read */
+    uint64_t offset;      /*!< File offset of the read */
+} uring_op_t;
+
+/**
+ * \brief           Per-source backend state
+ */
+typedef struct uring_src {
+    lwgpsd_source_t* src;                /*!< Daemon source */
+    uring_op_t ops[URING_FILE_DEPTH];    /*!< Requests, only first one is used for non-file sources */
+    uint64_t feed_offset;                /*!< File offset of next data to feed */
+    uint64_t read_offset;                /*!< File offset of next read to submit */
+    uint8_t inflight;                    /*!< Number of file reads in flight */
+    uint8_t eof;                         /*!< End of file has been reached */
+} uring_src_t;
+
+/**
+ * \brief           Mapped io_uring instance
+ */
+typedef struct {
+    int fd;                      /*!< Ring file descriptor */
+    unsigned *sq_head, *sq_tail; /*!< Submission queue head and tail */
+    unsigned *sq_array, sq_mask; /*!< Submission queue index array and mask */
+    unsigned sq_entries;         /*!< Number of submission queue entries */
+    struct io_uring_sqe* sqes;   /*!< Submission queue entries */
+    unsigned *cq_head, *cq_tail; /*!< Completion queue head and tail */
+    unsigned cq_mask;            /*!< Completion queue mask */
+    struct io_uring_cqe* cqes;   /*!< Completion queue entries */
+    unsigned to_submit;          /*!< Number of queued, not yet submitted entries */
+    struct io_uring_buf_ring* br; /*!< Ring of provided receive buffers */
+    uint8_t* recv_mem;           /*!< Memory of provided receive buffers */
+    uint16_t br_tail;            /*!< Local tail of provided buffer ring */
+} uring_t;
+
+/**
+ * \brief           Set up the ring and map its queues
+ * \param[out]      ring: Ring to initialize
+ * \return          `1` on success, `0` otherwise
+ */
+static int
+ring_setup(uring_t* ring) {
+    struct io_uring_params p;
+    uint8_t *sq, *cq;
+    size_t sq_len, cq_len;
+
+    memset(&p, 0x00, sizeof(p));
+    memset(ring, 0x00, sizeof(*ring));
+    if ((ring->fd = (int)syscall(__NR_io_uring_setup, URING_ENTRIES, &p)) < 0) {
+        return 0;
+    }
+    sq_len = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    cq_len = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+    if (p.features & IORING_FEAT_SINGLE_MMAP) {
+        sq_len = cq_len = sq_len > cq_len ? sq_len : cq_len;
+    }
+    sq = mmap(NULL, sq_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQ_RING);
+    if (sq == MAP_FAILED) {
+        return 0;
+    }
+    cq = sq;
+    if (!(p.features & IORING_FEAT_SINGLE_MMAP)) {
+        cq = mmap(NULL, cq_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_CQ_RING);
+        if (cq == MAP_FAILED) {
+            return 0;
+        }
+    }
+    ring->sqes = mmap(NULL, p.sq_entries * sizeof(struct io_uring_sqe), PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES);
+    if (ring->sqes == MAP_FAILED) {
+        return 0;
+    }
+    ring->sq_head = (unsigned*)(sq + p.sq_off.head);
+    ring->sq_tail = (unsigned*)(sq + p.sq_off.tail);
+    ring->sq_array = (unsigned*)(sq + p.sq_off.array);
+    ring->sq_mask = *(unsigned*)(sq + p.sq_off.ring_mask);
+    ring->sq_entries = p.sq_entries;
+    ring->cq_head = (unsigned*)(cq + p.cq_off.head);
+    ring->cq_tail = (unsigned*)(cq + p.cq_off.tail);
+    ring->cq_mask = *(unsigned*)(cq + p.cq_off.ring_mask);
+    ring->cqes = (struct io_uring_cqe*)(cq + p.cq_off.cqes);
+    return 1;
+}
+
+/**
+ * \brief           Submit queued entries and optionally wait for completions
+ * \param[in]       ring: Ring
+ * \param[in]       wait_nr: Minimum number of completions to wait for
+ * \return          `0` on success, negative errno otherwise
+ */
+static int
+ring_enter(uring_t* ring, unsigned wait_nr) {
+    int res;
+
+    res = (int)syscall(__NR_io_uring_enter, ring->fd, ring->to_submit, wait_nr,
+                       wait_nr > 0 ? IORING_ENTER_GETEVENTS : 0, NULL, 0);
+    if (res < 0) {
+        return -errno;
+    }
+    ring->to_submit -= (unsigned)res;
+    return 0;
+}
+
+/**
+ * \brief           Get next free submission queue entry
+ * \param[in]       ring: Ring
+ * \return          Cleared entry, already queued for next submit
+ */
+static struct io_uring_sqe*
+ring_get_sqe(uring_t* ring) {
+    struct io_uring_sqe* sqe;
+    unsigned tail = *ring->sq_tail;
+
+    while (tail - __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE) >= ring->sq_entries) {
+        ring_enter(ring, 0); /* Queue is full, flush it to the kernel */
+    }
+    sqe = &ring->sqes[tail & ring->sq_mask];
+    memset(sqe, 0x00, sizeof(*sqe));
+    ring->sq_array[tail & ring->sq_mask] = tail & ring->sq_mask;
+    __atomic_store_n(ring->sq_tail, tail + 1, __ATOMIC_RELEASE);
+    ++ring->to_submit;
+    return sqe;
+}
+
+/**
+ * \brief           Register ring of provided buffers for multishot receives
+ * \param[in]       ring: Ring
+ * \return          `1` on success, `0` otherwise
+ */
+static int
+ring_setup_recv_buffers(uring_t* ring) {
+    struct io_uring_buf_reg reg;
+    uint16_t i;
+
+    ring->br = mmap(NULL, URING_RECV_BUFS * sizeof(struct io_uring_buf), PROT_READ | PROT_WRITE,
+                    MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+    if (ring->br == MAP_FAILED || (ring->recv_mem = malloc((size_t)URING_RECV_BUFS * URING_RECV_SIZE)) == NULL) {
+        return 0;
+    }
+    memset(&reg, 0x00, sizeof(reg));
+    reg.ring_addr = (uint64_t)(uintptr_t)ring->br;
+    reg.ring_entries = URING_RECV_BUFS;
+    reg.bgid = URING_RECV_BGID;
+    if (syscall(__NR_io_uring_register, ring->fd, IORING_REGISTER_PBUF_RING, &reg, 1) < 0) {
+        return 0;
+    }
+    for (i = 0; i < URING_RECV_BUFS; ++i) {
+        struct io_uring_buf* b = &ring->br->bufs[(ring->br_tail + i) & (URING_RECV_BUFS - 1)];
+
+        b->addr = (uint64_t)(uintptr_t)&ring->recv_mem[(size_t)i * URING_RECV_SIZE];
+        b->len = URING_RECV_SIZE;
+        b->bid = i;
+    }
+    ring->br_tail += URING_RECV_BUFS;
+    __atomic_store_n(&ring->br->tail, ring->br_tail, __ATOMIC_RELEASE);
+    return 1;
+}
+
+/**
+ * \brief           Give provided buffer back to the kernel
+ * \param[in]       ring: Ring
+ * \param[in]       bid: Buffer ID
+ */
+static void
+ring_recycle_buffer(uring_t* ring, uint16_t bid) {
+    struct io_uring_buf* b = &ring->br->bufs[ring->br_tail & (URING_RECV_BUFS - 1)];
+
+    b->addr = (uint64_t)(uintptr_t)&ring->recv_mem[(size_t)bid * URING_RECV_SIZE];
+    b->len = URING_RECV_SIZE;
+    b->bid = bid;
+    __atomic_store_n(&ring->br->tail, ++ring->br_tail, __ATOMIC_RELEASE);
+}
+
+/**
+ * \brief           Queue multishot receive or single read request
+ * \param[in]       ring: Ring
+ * \param[in]       op: Request context
+ */
+static void
+queue_stream(uring_t* ring, uring_op_t* op) {
+    struct io_uring_sqe* sqe = ring_get_sqe(ring);
+
+    sqe->fd = op->us->src->fd;
+    sqe->user_data = (uint64_t)(uintptr_t)op;
+    if (op->kind == OP_RECV) {
+        sqe->opcode = IORING_OP_RECV;
+        sqe->ioprio = IORING_RECV_MULTISHOT;
+        sqe->flags = IOSQE_BUFFER_SELECT;
+        sqe->buf_group = URING_RECV_BGID;
+    } else {
+        sqe->opcode = IORING_OP_READ;
+        sqe->addr = (uint64_t)(uintptr_t)op->us->src->buff;
+        sqe->len = sizeof(op->us->src->buff);
+        sqe->off = (uint64_t)-1; /* Current position, file is not seekable */
+    }
+}
+
+/**
+ * \brief           Queue housekeeping timeout
+ * \param[in]       ring: Ring
+ * \param[in]       op: Request context of the timeout
+ * \param[in]       ts: Timeout period, must stay valid until completion
+ */
+static void
+queue_tick(uring_t* ring, uring_op_t* op, const struct __kernel_timespec* ts) {
+    struct io_uring_sqe* sqe = ring_get_sqe(ring);
+
+    sqe->opcode = IORING_OP_TIMEOUT;
+    sqe->fd = -1;
+    sqe->addr = (uint64_t)(uintptr_t)ts;
+    sqe->len = 1;
+    sqe->user_data = (uint64_t)(uintptr_t)op;
+}
+
+/**
+ * \brief           Queue fixed read of next file block
+ * \param[in]       ring: Ring
+ * \param[in]       op: Request context
+ * \param[in]       file_mem: Memory of registered file buffers
+ */
+static void
+queue_file(uring_t* ring, uring_op_t* op, uint8_t* file_mem) {
+    struct io_uring_sqe* sqe = ring_get_sqe(ring);
+
+    op->offset = op->us->read_offset;
+    op->done = 0;
+    op->us->read_offset += URING_FILE_SIZE;
+    ++op->us->inflight;
+    sqe->opcode = IORING_OP_READ_FIXED;
+    sqe->fd = op->us->src->fd;
+    sqe->addr = (uint64_t)(uintptr_t)&file_mem[(size_t)op->buf_index * URING_FILE_SIZE];
+    sqe->len = URING_FILE_SIZE;
+    sqe->off = op->offset;
+    sqe->buf_index = op->buf_index;
+    sqe->user_data = (uint64_t)(uintptr_t)op;
+}
+
+/**
+ * \brief           Feed completed file reads in file order and refill the window
+ * \param[in]       ring: Ring
+ * \param[in]       us: File source
+ * \param[in]       file_mem: Memory of registered file buffers
+ * \return          `1` while file is still being read, `0` when it is done
+ */
+static int
+file_advance(uring_t* ring, uring_src_t* us, uint8_t* file_mem) {
+    uring_op_t* op;
+    size_t i;
+
+    do {
+        op = NULL;
+        for (i = 0; i < URING_FILE_DEPTH; ++i) {
+            if (us->ops[i].done && us->ops[i].offset == us->feed_offset) {
+                op = &us->ops[i];
+                break;
+            }
+        }
+        if (op == NULL) {
+            break;
+        }
+        op->done = 0;
+        if (op->res > 0 && !us->eof) {
+            lwgpsd_feed(us->src, &file_mem[(size_t)op->buf_index * URING_FILE_SIZE], (size_t)op->res);
+            us->feed_offset += (uint64_t)op->res;
+        }
+        if (op->res < 0) {
+            fprintf(stderr, "lwgpsd: %s read failed: %s\n", us->src->name, strerror(-op->res));
+            us->eof = 1; /* Source is closed once reads in flight complete */
+        } else if (op->res < URING_FILE_SIZE) {
+            us->eof = 1; /* Short read of regular file means end of file */
+        } else if (!us->eof) {
+            queue_file(ring, op, file_mem);
+        }
+    } while (1);
+    return !us->eof || us->inflight > 0;
+}
+
+/**
+ * \brief           Run io_uring backend until all sources are closed or daemon is stopped
+ * \param[in]       srcs: Opened sources
+ * \param[in]       cnt: Number of sources
+ * \param[in]       running: Flag, cleared by signal handler to stop
+ * \return          `1` on success, `0` if ring could not be set up
+ */
+int
+lwgpsd_uring_run(lwgpsd_source_t** srcs, size_t cnt, volatile sig_atomic_t* running) {
+    uring_t ring;
+    uring_src_t* us;
+    uring_op_t *op, tick;
+    struct __kernel_timespec tick_ts;
+    struct io_uring_cqe* cqe;
+    struct iovec* iov = NULL;
+    uint8_t* file_mem = NULL;
+    size_t i, j, files = 0, opened = 0;
+    unsigned head, tail;
+    int res;
+
+    if ((us = calloc(cnt, sizeof(*us))) == NULL || !ring_setup(&ring) || !ring_setup_recv_buffers(&ring)) {
+        fprintf(stderr, "lwgpsd: io_uring setup failed: %s\n", strerror(errno));
+        return 0;
+    }
+
+    /* Register one window of fixed buffers per capture file */
+    for (i = 0; i < cnt; ++i) {
+        files += srcs[i]->type == LWGPSD_SRC_FILE;
+    }
+    if (files > 0) {
+        if ((file_mem = malloc(files * URING_FILE_DEPTH * URING_FILE_SIZE)) == NULL
+            || (iov = calloc(files * URING_FILE_DEPTH, sizeof(*iov))) == NULL) {
+            return 0;
+        }
+        for (i = 0; i < files * URING_FILE_DEPTH; ++i) {
+            iov[i].iov_base = &file_mem[i * URING_FILE_SIZE];
+            iov[i].iov_len = URING_FILE_SIZE;
+        }
+        if (syscall(__NR_io_uring_register, ring.fd, IORING_REGISTER_BUFFERS, iov, files * URING_FILE_DEPTH) < 0) {
+            fprintf(stderr, "lwgpsd: buffer registration failed: %s\n", strerror(errno));
+            return 0;
+        }
+    }
+
+    /* Arm initial requests */
+    for (i = 0, files = 0; i < cnt; ++i) {
+        if (srcs[i]->fd < 0) {
+            continue;
+        }
+        us[i].src = srcs[i];
+        fcntl(srcs[i]->fd, F_SETFL, fcntl(srcs[i]->fd, F_GETFL) & ~O_NONBLOCK); /* Let the ring wait for data */
+        for (j = 0; j < URING_FILE_DEPTH; ++j) {
+            us[i].ops[j].us = &us[i];
+        }
+        if (srcs[i]->type == LWGPSD_SRC_FILE) {
+            for (j = 0; j < URING_FILE_DEPTH; ++j) {
+                us[i].ops[j].kind = OP_FILE;
+                us[i].ops[j].buf_index = (uint16_t)(files * URING_FILE_DEPTH + j);
+                queue_file(&ring, &us[i].ops[j], file_mem);
+            }
+            ++files;
+        } else {
+            us[i].ops[0].kind = srcs[i]->type == LWGPSD_SRC_TTY ? OP_READ : OP_RECV;
+            queue_stream(&ring, &us[i].ops[0]);
+        }
+        ++opened;
+    }
+    memset(&tick, 0x00, sizeof(tick));
+    memset(&tick_ts, 0x00, sizeof(tick_ts));
+    tick.kind = OP_TICK;
+    tick_ts.tv_sec = URING_TICK_SEC;
+    queue_tick(&ring, &tick, &tick_ts);
+
+    while (*running && opened > 0) {
+        if ((res = ring_enter(&ring, 1)) < 0 && res != -EINTR) {
+            fprintf(stderr, "lwgpsd: io_uring_enter: %s\n", strerror(-res));
+            break;
+        }
+
+        /* Process all available completions as one batch */
+        head = *ring.cq_head;
+        tail = __atomic_load_n(ring.cq_tail, __ATOMIC_ACQUIRE);
+        for (; head != tail; ++head) {
+            cqe = &ring.cqes[head & ring.cq_mask];
+            op = (uring_op_t*)(uintptr_t)cqe->user_data;
+            if (op->kind == OP_TICK) {
+                lwgpsd_tick();
+                queue_tick(&ring, op, &tick_ts);
+                continue;
+            }
+            if (cqe->flags & IORING_CQE_F_BUFFER) { /* Provided buffer always goes back, also when empty or late */
+                uint16_t bid = (uint16_t)(cqe->flags >> IORING_CQE_BUFFER_SHIFT);
+
+                if (cqe->res > 0 && op->us->src->fd >= 0) {
+                    lwgpsd_feed(op->us->src, &ring.recv_mem[(size_t)bid * URING_RECV_SIZE], (size_t)cqe->res);
+                }
+                ring_recycle_buffer(&ring, bid);
+            }
+            if (op->us->src->fd < 0) {
+                continue; /* Late completion of closed source */
+            }
+            if (op->kind == OP_FILE) {
+                op->done = 1;
+                op->res = cqe->res;
+                --op->us->inflight;
+                if (!file_advance(&ring, op->us, file_mem)) {
+                    lwgpsd_source_close(op->us->src);
+                    --opened;
+                }
+                continue;
+            }
+            if (cqe->res > 0) {
+                if (!(cqe->flags & IORING_CQE_F_BUFFER)) {
+                    lwgpsd_feed(op->us->src, op->us->src->buff, (size_t)cqe->res);
+                }
+            } else if ((cqe->res == 0 && op->us->src->type != LWGPSD_SRC_UDP)
+                       || (cqe->res < 0 && cqe->res != -ENOBUFS && cqe->res != -EINTR)) {
+                lwgpsd_source_close(op->us->src); /* End of stream or error */
+                --opened;
+                continue;
+            }
+            if (!(cqe->flags & IORING_CQE_F_MORE)) {
+                queue_stream(&ring, op); /* Single read or terminated multishot receive, arm it again */
+            }
+        }
+        __atomic_store_n(ring.cq_head, head, __ATOMIC_RELEASE);
+    }
+    close(ring.fd);
+    free(file_mem);
+    free(iov);
+    free(us);
+    return 1;
+}
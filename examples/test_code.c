@@ -3,6 +3,7 @@
  * to process dummy NMEA data from GPS receiver
  */
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include "lwgps/lwgps.h"
 #include "test_common.h"
@@ -10,6 +11,25 @@
 /* GPS handle */
 lwgps_t hgps;
 
+#if LWGPS_CFG_LATENCY
+uint32_t lwgps_dev_tick;
+#endif /* LWGPS_CFG_LATENCY */
+
+/* Compact handle needs its scratch state, attached after every init */
+#if LWGPS_CFG_COMPACT
+static lwgps_scratch_t hgps_scratch;
+#define TEST_INIT(gh) (lwgps_init(gh), lwgps_set_scratch((gh), &hgps_scratch))
+#else
+#define TEST_INIT(gh) lwgps_init(gh)
+#endif /* LWGPS_CFG_COMPACT */
+
+/* Processing functions take event function only when status reporting is enabled */
+#if LWGPS_CFG_STATUS
+#define LWGPS_TEST_EVT_FN , NULL
+#else
+#define LWGPS_TEST_EVT_FN
+#endif /* LWGPS_CFG_STATUS */
+
 /**
  * \brief           Dummy data from GPS receiver
  */
@@ -21,15 +41,201 @@ const char gps_rx_data[] = ""
                            "$GPGSV,2,2,08,08,02,145,00,09,46,303,47,24,16,178,32,26,18,231,43*77\r\n"
                            "";
 
+#if LWGPS_CFG_ODOMETER || LWGPS_CFG_HISTORY
+/**
+ * \brief           Dummy data for odometer, with one jitter fix and one invalid speed
+ */
+const char gps_rx_data_odo[] = ""
+                               "$GPGGA,120000,4600.000,N,01400.000,E,1,08,1.0,300.0,M,45.0,M,,*4D\r\n"
+                               "$GPGGA,120001,4600.010,N,01400.000,E,1,08,1.0,300.0,M,45.0,M,,*4D\r\n"
+                               "$GPGGA,120002,4600.011,N,01400.000,E,1,08,1.0,300.0,M,45.0,M,,*4F\r\n"
+                               "$GPGGA,120005,4600.030,N,01400.000,E,1,08,1.0,300.0,M,45.0,M,,*4B\r\n"
+                               "$GPRMC,120005,A,4600.030,N,01400.000,E,012.5,090.0,180126,,*1C\r\n"
+                               "$GPRMC,120006,V,4600.030,N,01400.000,E,099.0,090.0,180126,,*0E\r\n"
+                               "";
+#endif /* LWGPS_CFG_ODOMETER || LWGPS_CFG_HISTORY */
+
+#if LWGPS_CFG_ODOMETER
+/**
+ * \brief           Dummy data for odometer, moving north at about `1` m/s, below stationary distance per fix
+ */
+const char gps_rx_data_odo_slow[] = ""
+                                    "$GPGGA,120100,4600.0000,N,01400.0000,E,1,08,1.0,300.0,M,45.0,M,,*4C\r\n"
+                                    "$GPGGA,120101,4600.0006,N,01400.0000,E,1,08,1.0,300.0,M,45.0,M,,*4B\r\n"
+                                    "$GPGGA,120102,4600.0012,N,01400.0000,E,1,08,1.0,300.0,M,45.0,M,,*4D\r\n"
+                                    "$GPGGA,120103,4600.0018,N,01400.0000,E,1,08,1.0,300.0,M,45.0,M,,*46\r\n"
+                                    "$GPGGA,120104,4600.0024,N,01400.0000,E,1,08,1.0,300.0,M,45.0,M,,*4E\r\n"
+                                    "$GPGGA,120105,4600.0030,N,01400.0000,E,1,08,1.0,300.0,M,45.0,M,,*4A\r\n"
+                                    "";
+#endif /* LWGPS_CFG_ODOMETER */
+
+#if LWGPS_CFG_REPORT_FILTER
+/**
+ * \brief           Dummy data for report filter, stationary receiver that moves at the end
+ */
+const char gps_rx_data_filt[] = ""
+                                "$GPGGA,120000,4600.000,N,01400.000,E,1,08,1.0,300.0,M,45.0,M,,*4D\r\n"
+                                "$GPGGA,120001,4600.000,N,01400.000,E,1,08,1.0,300.0,M,45.0,M,,*4C\r\n"
+                                "$GPGGA,120002,4600.001,N,01400.000,E,1,08,1.0,300.0,M,45.0,M,,*4E\r\n"
+                                "$GPRMC,120003,A,4600.000,N,01400.000,E,000.0,000.0,180126,,*16\r\n"
+                                "$GPRMC,120004,A,4600.000,N,01400.000,E,000.0,000.0,180126,,*11\r\n"
+                                "$GPGGA,120005,4600.000,N,01400.000,E,1,08,1.0,300.0,M,45.0,M,,*48\r\n"
+                                "$GPGGA,120006,4600.020,N,01400.000,E,1,08,1.0,300.0,M,45.0,M,,*49\r\n"
+                                "$GPGSA,A,3,02,,,07,,09,24,26,,,,,1.6,1.6,1.0*3D\r\n"
+                                "";
+static uint32_t filt_gga_cnt, filt_rmc_cnt, filt_gsa_cnt;
+
+/**
+ * \brief           Count reported statements
+ * \param[in]       res: Reported statement
+ */
+static void
+filt_callback(lwgps_statement_t res) {
+    if (res == STAT_GGA) {
+        ++filt_gga_cnt;
+    } else if (res == STAT_RMC) {
+        ++filt_rmc_cnt;
+    } else if (res == STAT_GSA) {
+        ++filt_gsa_cnt;
+    }
+}
+#endif /* LWGPS_CFG_REPORT_FILTER */
+
+#if LWGPS_CFG_UBX
+/**
+ * \brief           UBX NAV-PVT frame, 3D fix at 46.0512345, 14.5 at 12:34:56 on 18.01.2026
+ */
+const uint8_t gps_rx_ubx_pvt[] = {
+    0xB5, 0x62, 0x01, 0x07, 0x5C, 0x00, 0x00, 0xCA, 0x5B, 0x07, 0xEA, 0x07, 0x01, 0x12, 0x0C, 0x22,
+    0x38, 0x07, 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0x01, 0x00, 0x0B, 0x40, 0x86,
+    0xA4, 0x08, 0x59, 0xDC, 0x72, 0x1B, 0x30, 0x57, 0x05, 0x00, 0xE0, 0x93, 0x04, 0x00, 0xE8, 0x03,
+    0x00, 0x00, 0xDC, 0x05, 0x00, 0x00, 0x64, 0x00, 0x00, 0x00, 0xC8, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x18, 0x14, 0x00, 0x00, 0x40, 0x54, 0x89, 0x00, 0x2C, 0x01, 0x00, 0x00, 0x90, 0x01,
+    0x00, 0x00, 0x7B, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0xF3, 0x5D,
+};
+
+/**
+ * \brief           UBX NAV-SAT frame with `2` satellites
+ */
+const uint8_t gps_rx_ubx_sat[] = {
+    0xB5, 0x62, 0x01, 0x35, 0x20, 0x00, 0x00, 0xCA, 0x5B, 0x07, 0x01, 0x02, 0x00, 0x00, 0x00, 0x05,
+    0x28, 0x2D, 0x78, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x21, 0x0A, 0x2C, 0x01,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xBB, 0x63,
+};
+#endif /* LWGPS_CFG_UBX */
+
+#if LWGPS_CFG_AIS
+/**
+ * \brief           AIS type `18` report of own vessel, received between fragments of type `1` report
+ */
+const char gps_rx_data_ais_frag1[] = "!AIVDM,2,1,3,A,177KQJ5000G?tO,0*31\r\n";
+const char gps_rx_data_ais_own[] = "!AIVDO,1,1,,A,B6CdCm0t3`tba35f@V9faHi7kP06,0*5A\r\n";
+const char gps_rx_data_ais_frag2[] = "!AIVDM,2,2,3,A,`K>RA1wUbN0TKH,0*4B\r\n";
+#endif /* LWGPS_CFG_AIS */
+
+#if LWGPS_CFG_TAG
+/**
+ * \brief           Sentences with TAG blocks, the last one with invalid checksum
+ */
+const char gps_rx_data_tag[] = ""
+                               "\\s:base1,c:1700000000*1E\\"
+                               "$GPGGA,183730,3907.356,N,12102.482,W,1,05,1.6,646.4,M,-24.1,M,,*75\r\n"
+                               "$GPRMC,183729,A,3907.356,N,12102.482,W,000.0,360.0,080301,015.5,E*6F\r\n"
+                               "\\g:1-2-73874,s:rover,c:1700000001123*3A\\"
+                               "$GPGSA,A,3,02,,,07,,09,24,26,,,,,1.6,1.6,1.0*3D\r\n";
+const char gps_rx_data_tag_bad[] = "\\s:base2,c:1700000002*1E\\"
+                                   "$GPGSA,A,3,02,,,07,,09,24,26,,,,,1.6,1.6,1.0*3D\r\n";
+#endif /* LWGPS_CFG_TAG */
+
+#if LWGPS_CFG_CUSTOM
+/**
+ * \brief           Garmin estimated error sentences, the last one with invalid checksum
+ */
+const char gps_rx_data_custom[] = ""
+                                  "$PGRME,15.0,M,45.0,M,25.0,M*1C\r\n"
+                                  "$PGRMZ,93,f,3*21\r\n"
+                                  "$PGRME,1.0,M,2.0,M,3.0,M*2F\r\n";
+
+/**
+ * \brief           Estimated position errors, in units of meters
+ */
+typedef struct {
+    double hpe; /*!< Horizontal error */
+    double vpe; /*!< Vertical error */
+    double epe; /*!< Spherical error */
+} pgrme_t;
+static pgrme_t pgrme_staging, pgrme;
+
+/**
+ * \brief           Decode PGRME field to staging memory
+ */
+static void
+pgrme_term(lwgps_t* gh, const lwgps_custom_t* desc, uint8_t term_num, const char* term) {
+    pgrme_t* st = desc->arg;
+
+    (void)gh;
+    switch (term_num) {
+        case 1: st->hpe = atof(term); break;
+        case 3: st->vpe = atof(term); break;
+        case 5: st->epe = atof(term); break;
+        default: break;
+    }
+}
+
+/**
+ * \brief           Copy PGRME staging memory to application
+ */
+static void
+pgrme_commit(lwgps_t* gh, const lwgps_custom_t* desc) {
+    (void)gh;
+    pgrme = *(const pgrme_t*)desc->arg;
+}
+
+static const lwgps_custom_t pgrme_desc = {"PGRME", 6, pgrme_term, pgrme_commit, &pgrme_staging};
+#endif /* LWGPS_CFG_CUSTOM */
+
+#if LWGPS_CFG_DEMUX
+/**
+ * \brief           RTCM3 frame with `$`, `CR` and `LF` characters in payload
+ */
+const uint8_t gps_rx_rtcm[] = {
+    0xD3, 0x00, 0x0A, 0x3E, 0xD0, 0x00, 0x24, 0x0D, 0x0A, 0x24, 0x11, 0x22, 0x33, 0x02, 0xFE, 0x00,
+};
+
+/**
+ * \brief           UBX ACK-ACK frame
+ */
+const uint8_t gps_rx_ubx_ack[] = {
+    0xB5, 0x62, 0x05, 0x01, 0x02, 0x00, 0x06, 0x24, 0x32, 0x5B,
+};
+static uint32_t demux_frames[LWGPS_PROTO_RTCM3 + 1];
+
+/**
+ * \brief           Count validated binary frames
+ * \param[in]       dh: Demultiplexer handle
+ * \param[in]       proto: Protocol of the frame
+ * \param[in]       frame: Frame data
+ * \param[in]       len: Frame length
+ */
+static void
+demux_callback(lwgps_demux_t* dh, lwgps_proto_t proto, const void* frame, size_t len) {
+    (void)dh;
+    (void)frame;
+    (void)len;
+    ++demux_frames[proto];
+}
+#endif /* LWGPS_CFG_DEMUX */
+
 /**
  * \brief           Run the test of raw input data
  */
 void
 run_tests() {
-    lwgps_init(&hgps); /* Init GPS */
+    TEST_INIT(&hgps); /* Init GPS */
 
     /* Process all input data */
-    lwgps_process(&hgps, gps_rx_data, strlen(gps_rx_data));
+    lwgps_process(&hgps, gps_rx_data, strlen(gps_rx_data) LWGPS_TEST_EVT_FN);
 
     /* Run the test */
     RUN_TEST(!INT_IS_EQUAL(hgps.is_valid, 0));
@@ -39,9 +245,9 @@ run_tests() {
     RUN_TEST(FLT_IS_EQUAL(hgps.longitude, -121.0413666666));
     RUN_TEST(FLT_IS_EQUAL(hgps.altitude, 646.4000000000));
     RUN_TEST(FLT_IS_EQUAL(hgps.course, 360.0000000000));
-    RUN_TEST(INT_IS_EQUAL(hgps.dop_p, 1.6000000000));
-    RUN_TEST(INT_IS_EQUAL(hgps.dop_h, 1.6000000000));
-    RUN_TEST(INT_IS_EQUAL(hgps.dop_v, 1.0000000000));
+    RUN_TEST(FLT_IS_EQUAL(hgps.dop_p, 1.6000000000));
+    RUN_TEST(FLT_IS_EQUAL(hgps.dop_h, 1.6000000000));
+    RUN_TEST(FLT_IS_EQUAL(hgps.dop_v, 1.0000000000));
     RUN_TEST(FLT_IS_EQUAL(hgps.speed, 0.0000000000));
     RUN_TEST(FLT_IS_EQUAL(hgps.geo_sep, -24.100000000));
     RUN_TEST(FLT_IS_EQUAL(hgps.variation, 15.500000000));
@@ -67,4 +273,477 @@ run_tests() {
     RUN_TEST(INT_IS_EQUAL(hgps.hours, 18));
     RUN_TEST(INT_IS_EQUAL(hgps.minutes, 37));
     RUN_TEST(INT_IS_EQUAL(hgps.seconds, 30));
+
+#if LWGPS_CFG_LATENCY
+    /* Every tick read advances the tick by 1: start, end of line and commit of each sentence */
+    RUN_TEST(INT_IS_EQUAL(hgps.lat.line_hist[1], 5));
+    RUN_TEST(INT_IS_EQUAL(hgps.lat.parse_hist[1], 5));
+    RUN_TEST(INT_IS_EQUAL(hgps.lat.total_hist[2], 5));
+    RUN_TEST(INT_IS_EQUAL(hgps.lat.commit - hgps.lat.start, 2));
+    RUN_TEST(INT_IS_EQUAL(lwgps_latency_percentile(hgps.lat.total_hist, 99), 3));
+    lwgps_latency_reset(&hgps);
+    RUN_TEST(INT_IS_EQUAL(lwgps_latency_percentile(hgps.lat.total_hist, 99), 0));
+#endif /* LWGPS_CFG_LATENCY */
+
+    /* Scattered input is processed as single stream */
+    {
+        lwgps_iovec_t iov[3] = {{gps_rx_data, 100}, {NULL, 0}, {&gps_rx_data[100], strlen(gps_rx_data) - 100}};
+
+        TEST_INIT(&hgps);
+        lwgps_processv(&hgps, iov, 3 LWGPS_TEST_EVT_FN);
+        RUN_TEST(FLT_IS_EQUAL(hgps.latitude, 39.1226000000));
+        RUN_TEST(INT_IS_EQUAL(hgps.sats_in_view, 8));
+    }
+
+    /* Byte limit is hard, input without line end is cut at the limit */
+    {
+        lwgps_budget_t budget = {100, 0, NULL, NULL};
+        char noise[1000];
+
+        memset(noise, 'x', sizeof(noise));
+        TEST_INIT(&hgps);
+        RUN_TEST(INT_IS_EQUAL(lwgps_process_budget(&hgps, noise, sizeof(noise), &budget LWGPS_TEST_EVT_FN), 100));
+        noise[500] = '$';
+        budget.max_bytes = 1000;
+        budget.max_sentences = 1;
+        RUN_TEST(INT_IS_EQUAL(lwgps_process_budget(&hgps, noise, sizeof(noise), &budget LWGPS_TEST_EVT_FN), 500));
+    }
+
+    /* Budgeted processing stops at line boundary and resumes from there */
+    {
+        lwgps_budget_t budget = {0, 2, NULL, NULL};
+        size_t len = strlen(gps_rx_data), pos = 0, cnt = 0;
+
+        TEST_INIT(&hgps);
+        RUN_TEST(INT_IS_EQUAL(lwgps_process_budget(&hgps, gps_rx_data, len, &budget LWGPS_TEST_EVT_FN),
+                              strchr(strchr(gps_rx_data, '\n') + 1, '\n') + 1 - gps_rx_data));
+        RUN_TEST(FLT_IS_EQUAL(hgps.latitude, 39.1226000000));
+        RUN_TEST(INT_IS_EQUAL(hgps.sats_in_view, 0));
+        TEST_INIT(&hgps);
+        while (pos < len) {
+            pos += lwgps_process_budget(&hgps, &gps_rx_data[pos], len - pos, &budget LWGPS_TEST_EVT_FN);
+            ++cnt;
+        }
+        RUN_TEST(INT_IS_EQUAL(cnt, 3));
+        RUN_TEST(INT_IS_EQUAL(hgps.sats_in_view, 8));
+    }
+
+#if LWGPS_CFG_FIELD_MASK
+    /* Empty DGPS age term is reported as updated, but not present */
+    RUN_TEST(INT_IS_EQUAL(hgps.fields_present & (LWGPS_FIELD_LATITUDE | LWGPS_FIELD_DGPS_AGE), LWGPS_FIELD_LATITUDE));
+    RUN_TEST(INT_IS_EQUAL(lwgps_fields_ack(&hgps) & (LWGPS_FIELD_DGPS_AGE | LWGPS_FIELD_SPEED | LWGPS_FIELD_SATS_IN_VIEW),
+                          LWGPS_FIELD_DGPS_AGE | LWGPS_FIELD_SPEED | LWGPS_FIELD_SATS_IN_VIEW));
+    RUN_TEST(INT_IS_EQUAL(lwgps_fields_ack(&hgps), 0));
+#endif /* LWGPS_CFG_FIELD_MASK */
+
+#if LWGPS_CFG_ODOMETER || LWGPS_CFG_HISTORY
+    TEST_INIT(&hgps);
+    lwgps_process(&hgps, gps_rx_data_odo, strlen(gps_rx_data_odo) LWGPS_TEST_EVT_FN);
+#endif /* LWGPS_CFG_ODOMETER || LWGPS_CFG_HISTORY */
+
+#if LWGPS_CFG_ODOMETER
+    /* Odometer must skip jitter and invalid speed */
+    RUN_TEST(fabs(hgps.odo.distance - 55.597463) < 0.001);
+    RUN_TEST(INT_IS_EQUAL(hgps.odo.moving_time, 5));
+    RUN_TEST(FLT_IS_EQUAL(hgps.odo.max_speed, 12.5));
+
+    lwgps_odometer_reset(&hgps);
+    RUN_TEST(FLT_IS_EQUAL(hgps.odo.distance, 0));
+#endif /* LWGPS_CFG_ODOMETER */
+
+#if LWGPS_CFG_HISTORY
+    /* History keeps all 4 fixes, kinematics from last 3 */
+    {
+        lwgps_kinematics_t kin;
+
+        RUN_TEST(INT_IS_EQUAL(lwgps_history_count(&hgps), 4));
+        RUN_TEST(INT_IS_EQUAL(lwgps_history_get(&hgps, 0)->time, 43205));
+        RUN_TEST(INT_IS_EQUAL(lwgps_history_get(&hgps, 3)->time, 43200));
+        RUN_TEST(lwgps_history_get(&hgps, 4) == NULL);
+        RUN_TEST(INT_IS_EQUAL(lwgps_history_kinematics(&hgps, &kin), 1));
+        RUN_TEST(fabs(kin.vel_north - 11.7372) < 0.001);
+        RUN_TEST(fabs(kin.vel_east) < 0.001);
+        RUN_TEST(fabs(kin.accel - 4.9421) < 0.001);
+        RUN_TEST(fabs(kin.turn_rate) < 0.001);
+        RUN_TEST(fabs(kin.heading) < 0.001);
+    }
+#endif /* LWGPS_CFG_HISTORY */
+
+#if LWGPS_CFG_CHECKPOINT
+    /* Checkpoint restores fix and history to fresh handle */
+    {
+        static lwgps_t hrest;
+        uint8_t ckpt[1024];
+        size_t len = lwgps_checkpoint_save(&hgps, NULL, 0);
+
+        RUN_TEST(len > 8 && len <= sizeof(ckpt));
+        RUN_TEST(INT_IS_EQUAL(lwgps_checkpoint_save(&hgps, ckpt, len - 1), 0));
+        RUN_TEST(INT_IS_EQUAL(lwgps_checkpoint_save(&hgps, ckpt, sizeof(ckpt)), len));
+        RUN_TEST(!memcmp(ckpt, "LGCP\x01\x00", 6));
+        lwgps_init(&hrest);
+        RUN_TEST(INT_IS_EQUAL(lwgps_checkpoint_load(&hrest, ckpt, len - 1), 0));
+        RUN_TEST(FLT_IS_EQUAL(hrest.latitude, 0));
+        RUN_TEST(INT_IS_EQUAL(lwgps_checkpoint_load(&hrest, ckpt, len), 1));
+        RUN_TEST(FLT_IS_EQUAL(hrest.latitude, hgps.latitude));
+        RUN_TEST(FLT_IS_EQUAL(hrest.speed, hgps.speed));
+        RUN_TEST(INT_IS_EQUAL(hrest.seconds, hgps.seconds));
+#if LWGPS_CFG_HISTORY
+        RUN_TEST(INT_IS_EQUAL(lwgps_history_count(&hrest), 4));
+        RUN_TEST(INT_IS_EQUAL(lwgps_history_get(&hrest, 0)->time, 43205));
+#endif /* LWGPS_CFG_HISTORY */
+#if LWGPS_CFG_STATEMENT_GPGGA
+        /* Known section with wrong length is rejected, even when framing is valid */
+        hrest.latitude = 0;
+        ckpt[9] = 44;
+        RUN_TEST(INT_IS_EQUAL(lwgps_checkpoint_load(&hrest, ckpt, 8 + 3 + 44), 0));
+        RUN_TEST(FLT_IS_EQUAL(hrest.latitude, 0));
+        ckpt[9] = 45;
+#endif /* LWGPS_CFG_STATEMENT_GPGGA */
+        ckpt[4] = 2; /* Unsupported version */
+        RUN_TEST(INT_IS_EQUAL(lwgps_checkpoint_load(&hrest, ckpt, len), 0));
+    }
+#endif /* LWGPS_CFG_CHECKPOINT */
+
+#if LWGPS_CFG_ODOMETER
+    /* Slow movement is credited to moving time for the whole stretch */
+    TEST_INIT(&hgps);
+    lwgps_process(&hgps, gps_rx_data_odo_slow, strlen(gps_rx_data_odo_slow) LWGPS_TEST_EVT_FN);
+    RUN_TEST(fabs(hgps.odo.distance - 5.559) < 0.01);
+    RUN_TEST(INT_IS_EQUAL(hgps.odo.moving_time, 5));
+#endif /* LWGPS_CFG_ODOMETER */
+
+#if LWGPS_CFG_REPORT_FILTER
+    /* Report first fix, then only after 5 seconds or 10 meters */
+    {
+        lwgps_report_filter_t filt = {0};
+
+        filt.distance = 10;
+        filt.interval = 5;
+        TEST_INIT(&hgps);
+        lwgps_set_report_filter(&hgps, &filt);
+        lwgps_process(&hgps, gps_rx_data_filt, strlen(gps_rx_data_filt), filt_callback);
+
+        RUN_TEST(INT_IS_EQUAL(filt_gga_cnt, 3));
+        RUN_TEST(INT_IS_EQUAL(filt_rmc_cnt, 1));
+        RUN_TEST(INT_IS_EQUAL(filt_gsa_cnt, 1));
+    }
+
+    /* Distance only policy does not apply to RMC, which is always reported */
+    {
+        lwgps_report_filter_t filt = {0};
+
+        filt.distance = 10;
+        filt_gga_cnt = filt_rmc_cnt = filt_gsa_cnt = 0;
+        TEST_INIT(&hgps);
+        lwgps_set_report_filter(&hgps, &filt);
+        lwgps_process(&hgps, gps_rx_data_filt, strlen(gps_rx_data_filt), filt_callback);
+
+        RUN_TEST(INT_IS_EQUAL(filt_gga_cnt, 2));
+        RUN_TEST(INT_IS_EQUAL(filt_rmc_cnt, 2));
+        RUN_TEST(INT_IS_EQUAL(filt_gsa_cnt, 1));
+    }
+#endif /* LWGPS_CFG_REPORT_FILTER */
+
+#if LWGPS_CFG_COMPACT
+    /* Handle without scratch state ignores data */
+    {
+        lwgps_iovec_t iov[1] = {{gps_rx_data, sizeof(gps_rx_data) - 1}};
+
+        lwgps_init(&hgps);
+        RUN_TEST(INT_IS_EQUAL(lwgps_process(&hgps, gps_rx_data, strlen(gps_rx_data) LWGPS_TEST_EVT_FN), 0));
+        RUN_TEST(INT_IS_EQUAL(lwgps_processv(&hgps, iov, 1 LWGPS_TEST_EVT_FN), 0));
+        RUN_TEST(INT_IS_EQUAL(lwgps_processv(&hgps, iov, 0 LWGPS_TEST_EVT_FN), 0));
+        RUN_TEST(FLT_IS_EQUAL(hgps.latitude, 0));
+        RUN_TEST(INT_IS_EQUAL(lwgps_set_scratch(&hgps, &hgps_scratch), 1));
+        RUN_TEST(INT_IS_EQUAL(lwgps_process(&hgps, gps_rx_data, strlen(gps_rx_data) LWGPS_TEST_EVT_FN), 1));
+        RUN_TEST(FLT_IS_EQUAL(hgps.latitude, 39.1226000000));
+        RUN_TEST(fabs(hgps.altitude - 646.4) < 1e-3);
+    }
+#endif /* LWGPS_CFG_COMPACT */
+
+#if LWGPS_CFG_RUNTIME_MASK
+    /* Statements and CRC check disabled on single handle */
+    {
+        static const char bad_crc[] = "$GPGGA,183731,3907.356,N,12102.482,W,1,05,1.6,999.9,M,-24.1,M,,*00\r\n";
+
+        TEST_INIT(&hgps);
+        RUN_TEST(INT_IS_EQUAL(lwgps_set_features(&hgps, LWGPS_FEATURE_ALL & ~LWGPS_FEATURE_GGA), 1));
+        lwgps_process(&hgps, gps_rx_data, strlen(gps_rx_data) LWGPS_TEST_EVT_FN);
+        RUN_TEST(FLT_IS_EQUAL(hgps.latitude, 0));
+        RUN_TEST(FLT_IS_EQUAL(hgps.altitude, 0));
+        RUN_TEST(FLT_IS_EQUAL(hgps.course, 360.0000000000));
+        RUN_TEST(INT_IS_EQUAL(hgps.sats_in_view, 8));
+        RUN_TEST(INT_IS_EQUAL(hgps.fix_mode, 3));
+
+        lwgps_set_features(&hgps, LWGPS_FEATURE_ALL);
+#if LWGPS_CFG_CRC
+        lwgps_process(&hgps, bad_crc, strlen(bad_crc) LWGPS_TEST_EVT_FN);
+        RUN_TEST(FLT_IS_EQUAL(hgps.altitude, 0));
+#endif /* LWGPS_CFG_CRC */
+        lwgps_set_features(&hgps, LWGPS_FEATURE_ALL & ~LWGPS_FEATURE_CRC);
+        lwgps_process(&hgps, bad_crc, strlen(bad_crc) LWGPS_TEST_EVT_FN);
+        RUN_TEST(FLT_IS_EQUAL(hgps.altitude, 999.9000000000));
+        RUN_TEST(FLT_IS_EQUAL(hgps.latitude, 39.1226000000));
+#if LWGPS_CFG_STATEMENT_GPGSV_SAT_DET
+        TEST_INIT(&hgps);
+        lwgps_set_features(&hgps, LWGPS_FEATURE_ALL & ~LWGPS_FEATURE_GSV_SAT_DET);
+        lwgps_process(&hgps, gps_rx_data, strlen(gps_rx_data) LWGPS_TEST_EVT_FN);
+        RUN_TEST(INT_IS_EQUAL(hgps.sats_in_view, 8));
+        RUN_TEST(INT_IS_EQUAL(hgps.sats_in_view_desc[5].num, 0));
+#endif /* LWGPS_CFG_STATEMENT_GPGSV_SAT_DET */
+    }
+#endif /* LWGPS_CFG_RUNTIME_MASK */
+
+#if LWGPS_CFG_UBX
+    /* Binary frames are decoded to the same fields as NMEA */
+    {
+        uint8_t frame[sizeof(gps_rx_ubx_pvt)];
+
+        TEST_INIT(&hgps);
+        RUN_TEST(INT_IS_EQUAL(lwgps_process_ubx(&hgps, gps_rx_ubx_pvt, sizeof(gps_rx_ubx_pvt) LWGPS_TEST_EVT_FN),
+                              1));
+        RUN_TEST(INT_IS_EQUAL(hgps.is_valid, 1));
+        RUN_TEST(INT_IS_EQUAL(hgps.fix, 1));
+        RUN_TEST(INT_IS_EQUAL(hgps.fix_mode, 3));
+        RUN_TEST(INT_IS_EQUAL(hgps.sats_in_use, 11));
+        RUN_TEST(FLT_IS_EQUAL(hgps.latitude, 46.0512345));
+        RUN_TEST(FLT_IS_EQUAL(hgps.longitude, 14.5));
+        RUN_TEST(FLT_IS_EQUAL(hgps.altitude, 300.0));
+        RUN_TEST(FLT_IS_EQUAL(hgps.geo_sep, 50.0));
+        RUN_TEST(fabs(hgps.speed - 10.0) < 0.01);
+        RUN_TEST(FLT_IS_EQUAL(hgps.course, 90.0));
+        RUN_TEST(FLT_IS_EQUAL(hgps.dop_p, 1.23));
+        RUN_TEST(INT_IS_EQUAL(hgps.hours, 12));
+        RUN_TEST(INT_IS_EQUAL(hgps.minutes, 34));
+        RUN_TEST(INT_IS_EQUAL(hgps.seconds, 56));
+        RUN_TEST(INT_IS_EQUAL(hgps.date, 18));
+        RUN_TEST(INT_IS_EQUAL(hgps.month, 1));
+        RUN_TEST(INT_IS_EQUAL(hgps.year, 26));
+
+        RUN_TEST(INT_IS_EQUAL(lwgps_process_ubx(&hgps, gps_rx_ubx_sat, sizeof(gps_rx_ubx_sat) LWGPS_TEST_EVT_FN),
+                              1));
+        RUN_TEST(INT_IS_EQUAL(hgps.sats_in_view, 2));
+
+        /* Corrupted frame must be rejected */
+        memcpy(frame, gps_rx_ubx_pvt, sizeof(frame));
+        frame[30] ^= 0x01;
+        RUN_TEST(INT_IS_EQUAL(lwgps_process_ubx(&hgps, frame, sizeof(frame) LWGPS_TEST_EVT_FN),
+                              0));
+    }
+#endif /* LWGPS_CFG_UBX */
+
+#if LWGPS_CFG_AIS
+    TEST_INIT(&hgps);
+    lwgps_process(&hgps, gps_rx_data_ais_frag1, strlen(gps_rx_data_ais_frag1) LWGPS_TEST_EVT_FN);
+    RUN_TEST(INT_IS_EQUAL(hgps.ais.type, 0));
+    lwgps_process(&hgps, gps_rx_data_ais_own, strlen(gps_rx_data_ais_own) LWGPS_TEST_EVT_FN);
+    RUN_TEST(INT_IS_EQUAL(hgps.ais.type, 18));
+    RUN_TEST(INT_IS_EQUAL(hgps.ais.own, 1));
+    RUN_TEST(INT_IS_EQUAL(hgps.ais.mmsi, 423302100));
+    RUN_TEST(FLT_IS_EQUAL(hgps.ais.speed, 1.4));
+    RUN_TEST(FLT_IS_EQUAL(hgps.ais.latitude, 40.0052833333));
+    RUN_TEST(FLT_IS_EQUAL(hgps.ais.longitude, 53.0109966666));
+    RUN_TEST(INT_IS_EQUAL(hgps.ais.heading, 177));
+    lwgps_process(&hgps, gps_rx_data_ais_frag2, strlen(gps_rx_data_ais_frag2) LWGPS_TEST_EVT_FN);
+    RUN_TEST(INT_IS_EQUAL(hgps.ais.type, 1));
+    RUN_TEST(INT_IS_EQUAL(hgps.ais.own, 0));
+    RUN_TEST(INT_IS_EQUAL(hgps.ais.channel, 'A'));
+    RUN_TEST(INT_IS_EQUAL(hgps.ais.mmsi, 477553000));
+    RUN_TEST(INT_IS_EQUAL(hgps.ais.nav_status, 5));
+    RUN_TEST(FLT_IS_EQUAL(hgps.ais.latitude, 47.5828333333));
+    RUN_TEST(FLT_IS_EQUAL(hgps.ais.longitude, -122.3458333333));
+    RUN_TEST(FLT_IS_EQUAL(hgps.ais.course, 51.0));
+    RUN_TEST(INT_IS_EQUAL(hgps.ais.heading, 181));
+    RUN_TEST(INT_IS_EQUAL(hgps.ais.timestamp, 15));
+
+    /* Corrupted and invalid first fragments do not restart or evict message being reassembled */
+    {
+        char line[64];
+        unsigned i;
+
+        TEST_INIT(&hgps);
+        lwgps_process(&hgps, gps_rx_data_ais_frag1, strlen(gps_rx_data_ais_frag1) LWGPS_TEST_EVT_FN);
+        for (i = 0; i <= LWGPS_CFG_AIS_SLOTS; ++i) {
+            sprintf(line, "!AIVDM,2,1,%u,A,177KQJ5000G?tO,0*00\r\n", (i + 3) % 10);
+            lwgps_process(&hgps, line, strlen(line) LWGPS_TEST_EVT_FN);
+        }
+        strcpy(line, "!AIVDM,1,1,,A,1!!,0*17\r\n!AIVDM,2,1,3,A,1!!,0*27\r\n");
+        lwgps_process(&hgps, line, strlen(line) LWGPS_TEST_EVT_FN);
+        lwgps_process(&hgps, gps_rx_data_ais_frag2, strlen(gps_rx_data_ais_frag2) LWGPS_TEST_EVT_FN);
+        RUN_TEST(INT_IS_EQUAL(hgps.ais.type, 1));
+        RUN_TEST(INT_IS_EQUAL(hgps.ais.mmsi, 477553000));
+    }
+#endif /* LWGPS_CFG_AIS */
+
+#if LWGPS_CFG_TAG
+    {
+        lwgps_tag_t tag;
+        size_t tag_len = strchr(gps_rx_data_tag, '$') - gps_rx_data_tag;
+
+        /* Front end routing, TAG block of the first line */
+        RUN_TEST(INT_IS_EQUAL(lwgps_tag_parse(gps_rx_data_tag, strlen(gps_rx_data_tag), &tag), tag_len));
+        RUN_TEST(!strcmp(tag.src, "base1"));
+        RUN_TEST(tag.time == 1700000000ULL);
+        RUN_TEST(INT_IS_EQUAL(lwgps_tag_parse(gps_rx_data_tag, tag_len - 1, &tag), 0));
+        RUN_TEST(INT_IS_EQUAL(lwgps_tag_parse(gps_rx_data_tag_bad, strlen(gps_rx_data_tag_bad), &tag), 0));
+
+        /* TAG block is assigned only to the sentence that follows it */
+        TEST_INIT(&hgps);
+        lwgps_process(&hgps, gps_rx_data_tag, strlen(gps_rx_data_tag) LWGPS_TEST_EVT_FN);
+        RUN_TEST(INT_IS_EQUAL(hgps.tag.valid, 1));
+        RUN_TEST(!strcmp(hgps.tag.src, "rover"));
+        RUN_TEST(hgps.tag.time == 1700000001123ULL);
+        RUN_TEST(FLT_IS_EQUAL(hgps.latitude, 39.1226000000));
+        lwgps_process(&hgps, gps_rx_data, 70 LWGPS_TEST_EVT_FN); /* RMC without TAG block */
+        RUN_TEST(INT_IS_EQUAL(hgps.tag.valid, 0));
+        lwgps_process(&hgps, gps_rx_data_tag_bad, strlen(gps_rx_data_tag_bad) LWGPS_TEST_EVT_FN);
+        RUN_TEST(INT_IS_EQUAL(hgps.tag.valid, 0));
+        RUN_TEST(INT_IS_EQUAL(hgps.fix_mode, 3));
+    }
+#endif /* LWGPS_CFG_TAG */
+
+#if LWGPS_CFG_CUSTOM
+    TEST_INIT(&hgps);
+    RUN_TEST(INT_IS_EQUAL(lwgps_custom_register(&hgps, &pgrme_desc), 1));
+    RUN_TEST(INT_IS_EQUAL(lwgps_custom_register(&hgps, &pgrme_desc), 0));
+    lwgps_process(&hgps, gps_rx_data_custom, strlen(gps_rx_data_custom) LWGPS_TEST_EVT_FN);
+    RUN_TEST(FLT_IS_EQUAL(pgrme.hpe, 15.0));
+    RUN_TEST(FLT_IS_EQUAL(pgrme.vpe, 45.0));
+    RUN_TEST(FLT_IS_EQUAL(pgrme.epe, 25.0));
+#endif /* LWGPS_CFG_CUSTOM */
+
+#if LWGPS_CFG_DEMUX
+    /* Same mixed stream at once, without copy, and byte by byte, through demux buffer */
+    {
+        static lwgps_demux_t hdemux;
+        uint8_t stream[256], bad[sizeof(gps_rx_rtcm)];
+        size_t len = 0, i, run, step;
+
+        memcpy(bad, gps_rx_rtcm, sizeof(bad));
+        bad[5] ^= 0x01;
+        memcpy(&stream[len], "$GPGGA,120000,4600.0", 20); /* Sentence interrupted by binary frame */
+        len += 20;
+        memcpy(&stream[len], gps_rx_rtcm, sizeof(gps_rx_rtcm));
+        len += sizeof(gps_rx_rtcm);
+        memcpy(&stream[len], &gps_rx_data[70], 68); /* GGA line */
+        len += 68;
+        memcpy(&stream[len], gps_rx_ubx_ack, sizeof(gps_rx_ubx_ack));
+        len += sizeof(gps_rx_ubx_ack);
+        memcpy(&stream[len], bad, sizeof(bad));
+        len += sizeof(bad);
+        memcpy(&stream[len], gps_rx_data, 70); /* RMC line */
+        len += 70;
+
+        for (run = 0; run < 2; ++run) {
+            step = run == 0 ? len : 1;
+            TEST_INIT(&hgps);
+            lwgps_demux_init(&hdemux, &hgps, demux_callback);
+            memset(demux_frames, 0x00, sizeof(demux_frames));
+            for (i = 0; i < len; i += step) {
+                lwgps_demux_process(&hdemux, &stream[i], step LWGPS_TEST_EVT_FN);
+            }
+            RUN_TEST(INT_IS_EQUAL(demux_frames[LWGPS_PROTO_UBX], 1));
+            RUN_TEST(INT_IS_EQUAL(demux_frames[LWGPS_PROTO_RTCM3], 1));
+            RUN_TEST(INT_IS_EQUAL(hdemux.crc_err, 1));
+            RUN_TEST(INT_IS_EQUAL(hgps.is_valid, 1));
+            RUN_TEST(INT_IS_EQUAL(hgps.sats_in_use, 5));
+            RUN_TEST(FLT_IS_EQUAL(hgps.latitude, 39.1226000000));
+            RUN_TEST(FLT_IS_EQUAL(hgps.longitude, -121.0413666666));
+        }
+
+#if LWGPS_CFG_COMPACT
+        /* Handle without scratch state ignores NMEA, binary frames still pass */
+        lwgps_init(&hgps);
+        lwgps_demux_init(&hdemux, &hgps, demux_callback);
+        memset(demux_frames, 0x00, sizeof(demux_frames));
+        lwgps_demux_process(&hdemux, stream, len LWGPS_TEST_EVT_FN);
+        RUN_TEST(INT_IS_EQUAL(demux_frames[LWGPS_PROTO_UBX], 1));
+        RUN_TEST(FLT_IS_EQUAL(hgps.latitude, 0));
+#endif /* LWGPS_CFG_COMPACT */
+    }
+
+    /* False RTCM3 header is rescanned, sentence it covers is not lost */
+    {
+        static lwgps_demux_t hdemux;
+        uint8_t stream[3 + 68];
+        size_t i, run, step;
+
+        stream[0] = 0xD3;
+        stream[1] = 0x00;
+        stream[2] = 0x20;
+        memcpy(&stream[3], &gps_rx_data[70], 68); /* GGA line */
+        for (run = 0; run < 2; ++run) {
+            step = run == 0 ? sizeof(stream) : 1;
+            TEST_INIT(&hgps);
+            lwgps_demux_init(&hdemux, &hgps, demux_callback);
+            for (i = 0; i < sizeof(stream); i += step) {
+                lwgps_demux_process(&hdemux, &stream[i], step LWGPS_TEST_EVT_FN);
+            }
+            RUN_TEST(INT_IS_EQUAL(hdemux.crc_err, 1));
+            RUN_TEST(INT_IS_EQUAL(hgps.sats_in_use, 5));
+            RUN_TEST(FLT_IS_EQUAL(hgps.latitude, 39.1226000000));
+        }
+    }
+
+    /* NAV-SAT frame with 90 satellites is longer than demux buffer, passed only when not split */
+    {
+        static lwgps_demux_t hdemux;
+        static uint8_t frame[8 + 8 + 12 * 90];
+        uint8_t ck_a = 0, ck_b = 0;
+        size_t i, pl_len = 8 + 12 * 90;
+
+        RUN_TEST(sizeof(frame) > LWGPS_CFG_DEMUX_BUFF_SIZE);
+        frame[0] = 0xB5;
+        frame[1] = 0x62;
+        frame[2] = 0x01; /* NAV */
+        frame[3] = 0x35; /* SAT */
+        frame[4] = (uint8_t)pl_len;
+        frame[5] = (uint8_t)(pl_len >> 8);
+        frame[6 + 5] = 90;
+        for (i = 0; i < 90; ++i) {
+            frame[6 + 8 + 12 * i + 1] = (uint8_t)(i + 1);
+        }
+        for (i = 2; i < 6 + pl_len; ++i) {
+            ck_a += frame[i];
+            ck_b += ck_a;
+        }
+        frame[6 + pl_len] = ck_a;
+        frame[7 + pl_len] = ck_b;
+
+        TEST_INIT(&hgps);
+        lwgps_demux_init(&hdemux, &hgps, demux_callback);
+        memset(demux_frames, 0x00, sizeof(demux_frames));
+        lwgps_demux_process(&hdemux, frame, sizeof(frame) LWGPS_TEST_EVT_FN);
+        RUN_TEST(INT_IS_EQUAL(demux_frames[LWGPS_PROTO_UBX], 1));
+#if LWGPS_CFG_UBX && LWGPS_CFG_STATEMENT_GPGSV
+        RUN_TEST(INT_IS_EQUAL(hgps.sats_in_view, 90));
+#endif /* LWGPS_CFG_UBX && LWGPS_CFG_STATEMENT_GPGSV */
+        lwgps_demux_process(&hdemux, frame, sizeof(frame) / 2 LWGPS_TEST_EVT_FN);
+        lwgps_demux_process(&hdemux, &frame[sizeof(frame) / 2], sizeof(frame) - sizeof(frame) / 2 LWGPS_TEST_EVT_FN);
+        RUN_TEST(INT_IS_EQUAL(demux_frames[LWGPS_PROTO_UBX], 1));
+    }
+#endif /* LWGPS_CFG_DEMUX */
+
+#if LWGPS_CFG_SIMPLIFY
+    /* Track goes north, turns east; only start, corner and end are needed */
+    {
+        lwgps_simplify_t simp;
+        lwgps_point_t pt, out;
+        uint32_t cnt = 0;
+
+        lwgps_simplify_init(&simp, 2);
+        for (uint32_t i = 0; i < 10; ++i) {
+            pt.latitude = 46.0 + 0.0001 * (i < 5 ? i : 4);
+            pt.longitude = 14.0 + 0.0001 * (i < 5 ? 0 : i - 4);
+            pt.time = i;
+            if (lwgps_simplify_add(&simp, &pt, &out)) {
+                RUN_TEST(INT_IS_EQUAL(out.time, cnt == 0 ? 0 : 4));
+                ++cnt;
+            }
+        }
+        RUN_TEST(INT_IS_EQUAL(cnt, 2));
+        RUN_TEST(INT_IS_EQUAL(lwgps_simplify_flush(&simp, &out), 1));
+        RUN_TEST(INT_IS_EQUAL(out.time, 9));
+    }
+#endif /* LWGPS_CFG_SIMPLIFY */
 }
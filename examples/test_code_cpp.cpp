@@ -0,0 +1,292 @@
+/*
+ * Tests of C++ interface, compiled together with C tests
+ */
+#include <stdio.h>
+#include <string.h>
+#include <utility>
+#include <vector>
+#include "lwgps/lwgps.hpp"
+#include "lwgps/lwgps_parser.hpp"
+#include "test_common.h"
+#if __cpp_impl_coroutine && __has_include(<coroutine>)
+#include "lwgps/lwgps_coro.hpp"
+#endif /* __cpp_impl_coroutine && __has_include(<coroutine>) */
+
+/**
+ * \brief           Dummy data from GPS receiver
+ */
+static const char gps_rx_data_cpp[] = ""
+                                      "$GPRMC,183729,A,3907.356,N,12102.482,W,000.0,360.0,080301,015.5,E*6F\r\n"
+                                      "$GPGGA,183730,3907.356,N,12102.482,W,1,05,1.6,646.4,M,-24.1,M,,*75\r\n"
+                                      "$GPGSA,A,3,02,,,07,,09,24,26,,,,,1.6,1.6,1.0*3D\r\n"
+                                      "$GPGSV,2,1,08,02,43,088,38,04,42,145,00,05,11,291,00,07,60,043,35*71\r\n"
+                                      "$GPGSV,2,2,08,08,02,145,00,09,46,303,47,24,16,178,32,26,18,231,43*77\r\n"
+                                      "$GPGGA,183731,3907.356,N,12102.482,W,1,05,1.6,999.9,M,-24.1,M,,*00\r\n"
+                                      "";
+
+/**
+ * \brief           Full configuration, with satellite details
+ */
+struct FullConfig : Lwgps::DefaultConfig {
+    static constexpr bool gsv_sat_det = true;
+};
+
+/**
+ * \brief           Position only configuration for bulk relays, single precision
+ */
+struct PositionConfig : Lwgps::DefaultConfig {
+    using float_type = float;
+    static constexpr bool gsa = false;
+    static constexpr bool gsv = false;
+    static constexpr bool rmc = false;
+};
+
+static_assert(sizeof(Lwgps::Fix<PositionConfig>) < sizeof(Lwgps::Fix<FullConfig>), "Disabled fields must be removed");
+
+/**
+ * \brief           Count reported statements
+ */
+struct StatCounter {
+    unsigned stats[STAT_CUSTOM + 1];
+    unsigned crc_fail;
+
+    void
+    operator()(lwgps_statement_t stat) {
+        if (stat == STAT_CHECKSUM_FAIL) {
+            ++crc_fail;
+        } else if (stat <= STAT_CUSTOM) {
+            ++stats[stat];
+        }
+    }
+};
+
+#if __cpp_impl_coroutine && __has_include(<coroutine>)
+/* Coroutines waiting for data, resumed by test reactor */
+static std::vector<std::coroutine_handle<>> coro_ready;
+
+/**
+ * \brief           Byte source, delivering data in small chunks on every reactor turn
+ */
+struct ChunkSource {
+    const char* data;
+    size_t len;
+    size_t chunk;
+
+    struct ReadAwaiter {
+        ChunkSource* src;
+        std::span<std::byte> buf;
+
+        bool
+        await_ready() const noexcept {
+            return false;
+        }
+
+        void
+        await_suspend(std::coroutine_handle<> h) {
+            coro_ready.push_back(h);
+        }
+
+        size_t
+        await_resume() noexcept {
+            size_t n = std::min(std::min(buf.size(), src->chunk), src->len);
+
+            memcpy(buf.data(), src->data, n);
+            src->data += n;
+            src->len -= n;
+            return n;
+        }
+    };
+
+    ReadAwaiter
+    read(std::span<std::byte> buf) {
+        return ReadAwaiter{this, buf};
+    }
+};
+
+/**
+ * \brief           Consumer coroutine, started immediately and destroyed when finished
+ */
+struct CoroTask {
+    struct promise_type {
+        CoroTask
+        get_return_object() noexcept {
+            return {};
+        }
+
+        std::suspend_never
+        initial_suspend() noexcept {
+            return {};
+        }
+
+        std::suspend_never
+        final_suspend() noexcept {
+            return {};
+        }
+
+        void
+        return_void() noexcept {}
+
+        void
+        unhandled_exception() noexcept {
+            std::terminate();
+        }
+    };
+};
+
+/**
+ * \brief           Result of single tracked stream
+ */
+struct TrackResult {
+    unsigned updates;
+    unsigned gga;
+    double latitude;
+    bool done;
+};
+
+/**
+ * \brief           Consume all updates of single stream
+ */
+static CoroTask
+track(Lwgps::Parser<>& gps, ChunkSource& src, TrackResult& res) {
+    auto stream = Lwgps::fixes<64>(gps, src);
+
+    while (auto u = co_await stream.next()) {
+        ++res.updates;
+        res.gga += u->stat == STAT_GGA;
+        res.latitude = u->fix->latitude;
+    }
+    res.done = true;
+}
+#endif /* __cpp_impl_coroutine && __has_include(<coroutine>) */
+
+void
+run_tests_cpp() {
+    auto full = Lwgps::make_parser<FullConfig>(StatCounter{});
+    Lwgps::Parser<PositionConfig> pos;
+
+    /* Both parsers in the same program, each with its own statements */
+    full.process(gps_rx_data_cpp, strlen(gps_rx_data_cpp));
+    pos.process(gps_rx_data_cpp, strlen(gps_rx_data_cpp));
+
+    RUN_TEST(!INT_IS_EQUAL(full.fix().is_valid, 0));
+    RUN_TEST(INT_IS_EQUAL(full.fix().fix, 1));
+    RUN_TEST(INT_IS_EQUAL(full.fix().fix_mode, 3));
+    RUN_TEST(FLT_IS_EQUAL(full.fix().latitude, 39.1226000000));
+    RUN_TEST(FLT_IS_EQUAL(full.fix().longitude, -121.0413666666));
+    RUN_TEST(FLT_IS_EQUAL(full.fix().altitude, 646.4000000000));
+    RUN_TEST(FLT_IS_EQUAL(full.fix().course, 360.0000000000));
+    RUN_TEST(FLT_IS_EQUAL(full.fix().dop_p, 1.6000000000));
+    RUN_TEST(FLT_IS_EQUAL(full.fix().dop_v, 1.0000000000));
+    RUN_TEST(FLT_IS_EQUAL(full.fix().geo_sep, -24.100000000));
+    RUN_TEST(FLT_IS_EQUAL(full.fix().variation, 15.500000000));
+    RUN_TEST(INT_IS_EQUAL(full.fix().sats_in_view, 8));
+    RUN_TEST(INT_IS_EQUAL(full.fix().sats_in_use, 5));
+    RUN_TEST(INT_IS_EQUAL(full.fix().satellites_ids[0], 2));
+    RUN_TEST(INT_IS_EQUAL(full.fix().satellites_ids[3], 7));
+    RUN_TEST(INT_IS_EQUAL(full.fix().satellites_ids[7], 26));
+    RUN_TEST(INT_IS_EQUAL(full.fix().satellites_ids[8], 0));
+    RUN_TEST(INT_IS_EQUAL(full.fix().sats_in_view_desc[5].num, 9));
+    RUN_TEST(INT_IS_EQUAL(full.fix().sats_in_view_desc[5].azimuth, 303));
+    RUN_TEST(INT_IS_EQUAL(full.fix().sats_in_view_desc[5].snr, 47));
+    RUN_TEST(INT_IS_EQUAL(full.fix().date, 8));
+    RUN_TEST(INT_IS_EQUAL(full.fix().month, 3));
+    RUN_TEST(INT_IS_EQUAL(full.fix().year, 1));
+    RUN_TEST(INT_IS_EQUAL(full.fix().seconds, 30));
+
+    /* Callback is called for every sentence, last one has wrong checksum and is not committed */
+    RUN_TEST(INT_IS_EQUAL(full.callback().stats[STAT_GGA], 1));
+    RUN_TEST(INT_IS_EQUAL(full.callback().stats[STAT_GSV], 2));
+    RUN_TEST(INT_IS_EQUAL(full.callback().crc_fail, 1));
+
+    /* Valid sentence, which commits nothing, is reported too */
+    full.process("$GPZDA,183730,08,03,2001,00,00*4E\r\n", 35);
+    RUN_TEST(INT_IS_EQUAL(full.callback().stats[STAT_UNKNOWN], 1));
+    RUN_TEST(INT_IS_EQUAL(full.fix().seconds, 30));
+
+    /* Position only parser has the same position, in single precision */
+    RUN_TEST(fabs(pos.fix().latitude - 39.1226) < 1e-5);
+    RUN_TEST(fabs(pos.fix().longitude - -121.0413666666) < 1e-4);
+    RUN_TEST(INT_IS_EQUAL(pos.fix().sats_in_use, 5));
+    RUN_TEST(INT_IS_EQUAL(pos.fix().seconds, 30));
+
+    /* Movable wrapper, stored in vector and reallocated */
+    std::vector<Lwgps::Lwgps> handles(1);
+    handles[0].process(std::string_view(gps_rx_data_cpp));
+    handles.resize(8);
+    RUN_TEST(FLT_IS_EQUAL(handles[0].fix().latitude(), 39.1226000000));
+    Lwgps::Lwgps moved(std::move(handles[0]));
+    RUN_TEST(FLT_IS_EQUAL(moved.fix().latitude(), 39.1226000000));
+    RUN_TEST(FLT_IS_EQUAL(moved.fix().longitude(), -121.0413666666));
+    RUN_TEST(FLT_IS_EQUAL(handles[0].fix().latitude(), 0));
+    RUN_TEST(moved.fix().is_valid());
+    RUN_TEST(INT_IS_EQUAL(moved.fix().time().seconds, 30));
+    RUN_TEST(INT_IS_EQUAL(moved.fix().date().month, 3));
+    RUN_TEST(INT_IS_EQUAL(moved.fix().satellites_ids()[3], 7));
+    RUN_TEST(FLT_IS_EQUAL(moved.fix().speed(LWGPS_SPEED_KPH), 0));
+    handles[1] = std::move(moved);
+    RUN_TEST(FLT_IS_EQUAL(handles[1].fix().altitude(), 646.4000000000));
+#if __cpp_lib_span
+    handles[2].process(std::as_bytes(std::span(gps_rx_data_cpp, strlen(gps_rx_data_cpp))));
+    RUN_TEST(INT_IS_EQUAL(handles[2].fix().sats_in_use(), 5));
+#endif /* __cpp_lib_span */
+
+    /* Lazy sentence range, with views of the buffer */
+    {
+        unsigned cnt = 0, gsv = 0, bad = 0, fields = 0;
+        Lwgps::Sentence first;
+
+        for (auto s : Lwgps::sentences(gps_rx_data_cpp)) {
+            first = cnt++ == 0 ? s : first;
+            gsv += s.statement() == STAT_GSV;
+            bad += !s.checksum_ok();
+        }
+        for (auto f : first.fields()) {
+            fields += !f.empty();
+        }
+        RUN_TEST(INT_IS_EQUAL(cnt, 6));
+        RUN_TEST(INT_IS_EQUAL(gsv, 2));
+        RUN_TEST(INT_IS_EQUAL(bad, 1));
+        RUN_TEST(first.address() == "GPRMC");
+        RUN_TEST(first.statement() == STAT_RMC);
+        RUN_TEST(first[3] == "3907.356");
+        RUN_TEST(first[3].data() == gps_rx_data_cpp + 16);
+        RUN_TEST(INT_IS_EQUAL(first.size(), 12));
+        RUN_TEST(INT_IS_EQUAL(fields, 12));
+        RUN_TEST(first[12].empty());
+        RUN_TEST(Lwgps::sentences("$GPGSA,A,3*00\r\n$GPGGA,1").rest() == "$GPGGA,1");
+        RUN_TEST(Lwgps::sentences("$GPGGA,1$GPGSA,A,3*00\r\n").begin()->address() == "GPGSA");
+    }
+
+#if __cpp_impl_coroutine && __has_include(<coroutine>)
+    /* Many coroutine streams on single thread, interleaved by reactor */
+    {
+        std::vector<Lwgps::Parser<>> parsers(100);
+        std::vector<ChunkSource> srcs;
+        std::vector<TrackResult> res(parsers.size());
+        std::vector<std::coroutine_handle<>> batch;
+        unsigned done = 0, updates = 0, gga = 0;
+
+        for (size_t i = 0; i < parsers.size(); ++i) {
+            srcs.push_back(ChunkSource{gps_rx_data_cpp, strlen(gps_rx_data_cpp), 5 + i % 11});
+        }
+        for (size_t i = 0; i < parsers.size(); ++i) {
+            track(parsers[i], srcs[i], res[i]);
+        }
+        while (!coro_ready.empty()) {
+            batch.swap(coro_ready);
+            for (auto h : batch) {
+                h.resume();
+            }
+            batch.clear();
+        }
+        for (const auto& r : res) {
+            done += r.done;
+            updates += r.updates;
+            gga += r.gga && FLT_IS_EQUAL(r.latitude, 39.1226000000);
+        }
+        RUN_TEST(INT_IS_EQUAL(done, 100));
+        RUN_TEST(INT_IS_EQUAL(updates, 500)); /* Last sentence has wrong checksum */
+        RUN_TEST(INT_IS_EQUAL(gga, 100));
+    }
+#endif /* __cpp_impl_coroutine && __has_include(<coroutine>) */
+}
@@ -12,7 +12,12 @@
             exit(1);                                \
         }                                           \
     } while (0)
+#if LWGPS_CFG_COMPACT
+/* Auxiliary fields are single precision, compare relative to expected value */
+#define FLT_IS_EQUAL(x, y)      (fabs((double)(x) - (double)(y)) < 0.00001 * (fabs((double)(y)) > 1 ? fabs((double)(y)) : 1))
+#else
 #define FLT_IS_EQUAL(x, y)      (fabs((double)(x) - (double)(y)) < 0.00001)
+#endif /* LWGPS_CFG_COMPACT */
 #define INT_IS_EQUAL(x, y)      ((int)((x) == (y)))
 
 #endif /* TEST_COMMON_HDR_H */
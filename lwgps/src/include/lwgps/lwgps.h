@@ -59,6 +59,16 @@ typedef double lwgps_float_t;
 typedef float lwgps_float_t;
 #endif
 
+/**
+ * \brief           GPS float definition for values, which do not need precision of coordinates
+ * \note            It is `float` with \ref LWGPS_CFG_COMPACT, \ref lwgps_float_t otherwise
+ */
+#if LWGPS_CFG_COMPACT && !__DOXYGEN__
+typedef float lwgps_float_aux_t;
+#else
+typedef lwgps_float_t lwgps_float_aux_t;
+#endif
+
 /**
  * \brief           Satellite descriptor
  */
@@ -69,6 +79,206 @@ typedef struct {
     uint8_t snr;       /*!< Signal-to-noise ratio */
 } lwgps_sat_t;
 
+#if LWGPS_CFG_ODOMETER || __DOXYGEN__
+
+/**
+ * \brief           Odometer and trip accumulator
+ * \note            Available only if \ref LWGPS_CFG_ODOMETER is enabled
+ */
+typedef struct {
+    lwgps_float_t distance;  /*!< Travelled distance in units of meters */
+    lwgps_float_t max_speed; /*!< Maximum ground speed in units of knots */
+    uint32_t moving_time;    /*!< Time spent moving in units of seconds */
+
+#if !__DOXYGEN__
+    lwgps_float_t comp;      /*!< Compensation term for distance summation */
+    lwgps_float_t latitude;  /*!< Latitude of last accepted position */
+    lwgps_float_t longitude; /*!< Longitude of last accepted position */
+    uint32_t time;           /*!< UTC time of last accepted position, in units of seconds of day */
+    uint8_t has_ref;         /*!< Set to `1` when reference position is valid */
+#endif                       /* !__DOXYGEN__ */
+} lwgps_odometer_t;
+
+#endif /* LWGPS_CFG_ODOMETER || __DOXYGEN__ */
+
+#if LWGPS_CFG_REPORT_FILTER || __DOXYGEN__
+
+/**
+ * \brief           Report filter policy for status callback
+ *
+ *                  Statement is reported when any of enabled criteria is met.
+ *                  Set criteria to `0` to disable it. Statement, to which none of enabled criteria applies,
+ *                  is always reported.
+ *
+ * \note            Available only if \ref LWGPS_CFG_REPORT_FILTER is enabled
+ */
+typedef struct {
+    lwgps_float_t distance; /*!< Minimum position change for `GGA` report, in units of meters */
+    lwgps_float_t course;   /*!< Minimum course change for `RMC` report, in units of degrees */
+    lwgps_float_t speed;    /*!< Minimum speed change for `RMC` report, in units of knots */
+    uint32_t interval;      /*!< Time after which statement is reported regardless of change, in units of seconds */
+} lwgps_report_filter_t;
+
+#endif /* LWGPS_CFG_REPORT_FILTER || __DOXYGEN__ */
+
+#if LWGPS_CFG_SIMPLIFY || __DOXYGEN__
+
+/**
+ * \brief           Track point
+ */
+typedef struct {
+    lwgps_float_t latitude;  /*!< Latitude in units of degrees */
+    lwgps_float_t longitude; /*!< Longitude in units of degrees */
+    uint32_t time;           /*!< Application defined timestamp, passed through unmodified */
+} lwgps_point_t;
+
+/**
+ * \brief           Streaming track simplifier
+ * \note            Available only if \ref LWGPS_CFG_SIMPLIFY is enabled
+ */
+typedef struct {
+    lwgps_float_t tolerance; /*!< Maximum distance of dropped point from simplified track, in units of meters */
+
+#if !__DOXYGEN__
+    lwgps_point_t anchor;                          /*!< Last output point */
+    lwgps_float_t anchor_scale;                    /*!< Longitude to meters scale at anchor latitude */
+    lwgps_point_t win[LWGPS_CFG_SIMPLIFY_WINDOW]; /*!< Points received after anchor, not yet output */
+    uint16_t win_len;                              /*!< Number of points in the window */
+    uint8_t has_anchor;                            /*!< Set to `1` when anchor is valid */
+#endif                                             /* !__DOXYGEN__ */
+} lwgps_simplify_t;
+
+#endif /* LWGPS_CFG_SIMPLIFY || __DOXYGEN__ */
+
+#if LWGPS_CFG_HISTORY || __DOXYGEN__
+
+/**
+ * \brief           Fix stored in the history ring buffer
+ * \note            Available only if \ref LWGPS_CFG_HISTORY is enabled
+ */
+typedef struct {
+    lwgps_float_t latitude;     /*!< Latitude in units of degrees */
+    lwgps_float_t longitude;    /*!< Longitude in units of degrees */
+    lwgps_float_aux_t altitude; /*!< Altitude in units of meters */
+    lwgps_float_aux_t speed;    /*!< Latest ground speed in knots, `0` if `RMC` is not enabled */
+    lwgps_float_aux_t course;   /*!< Latest ground course in degrees, `0` if `RMC` is not enabled */
+    uint32_t time;              /*!< UTC time in units of seconds of day */
+} lwgps_fix_t;
+
+/**
+ * \brief           Kinematics derived from the history of fixes
+ */
+typedef struct {
+    lwgps_float_t vel_north; /*!< Velocity towards north in units of meters per second */
+    lwgps_float_t vel_east;  /*!< Velocity towards east in units of meters per second */
+    lwgps_float_t accel;     /*!< Acceleration along track in units of meters per second^2 */
+    lwgps_float_t turn_rate; /*!< Turn rate in units of degrees per second, positive clockwise */
+    lwgps_float_t heading;   /*!< Heading smoothed over full history, in units of degrees */
+} lwgps_kinematics_t;
+
+#endif /* LWGPS_CFG_HISTORY || __DOXYGEN__ */
+
+#if LWGPS_CFG_AIS || __DOXYGEN__
+
+/**
+ * \brief           AIS position report, message type `1`, `2`, `3` or `18`
+ */
+typedef struct {
+    uint8_t type;            /*!< Message type */
+    uint32_t mmsi;           /*!< Maritime mobile service identity */
+    uint8_t nav_status;      /*!< Navigation status, `15` when not defined or for type `18` */
+    int8_t rot;              /*!< Rate of turn, raw value, `-128` when not available or for type `18` */
+    lwgps_float_t speed;     /*!< Speed over ground in knots, `102.3` when not available */
+    lwgps_float_t latitude;  /*!< Latitude in units of degrees, `91` when not available */
+    lwgps_float_t longitude; /*!< Longitude in units of degrees, `181` when not available */
+    lwgps_float_t course;    /*!< Course over ground in units of degrees, `360` when not available */
+    uint16_t heading;        /*!< True heading in units of degrees, `511` when not available */
+    uint8_t accuracy;        /*!< Position accuracy, `1` = high, `0` = low */
+    uint8_t timestamp;       /*!< UTC second when report was generated */
+    uint8_t own;             /*!< Set to `1` for own vessel (`VDO`), `0` for other vessels (`VDM`) */
+    char channel;            /*!< Radio channel, `A` or `B` */
+} lwgps_ais_t;
+
+#endif /* LWGPS_CFG_AIS || __DOXYGEN__ */
+
+#if LWGPS_CFG_TAG || __DOXYGEN__
+
+/**
+ * \brief           NMEA 4.x TAG block information
+ */
+typedef struct {
+    char src[LWGPS_CFG_TAG_SRC_LEN]; /*!< Source identification from `s:` field, empty when not present */
+    uint64_t time;                   /*!< UNIX time from `c:` field, as received, `0` when not present */
+    uint8_t valid;                   /*!< Set to `1` when TAG block is present and checksum is valid */
+} lwgps_tag_t;
+
+/**
+ * \brief           TAG block parser state, used internally by GPS handle
+ */
+typedef struct {
+    lwgps_tag_t tag;  /*!< TAG block being parsed or waiting for sentence */
+    uint8_t crc_calc; /*!< Calculated checksum */
+    uint8_t crc_rx;   /*!< Received checksum */
+    uint8_t star;     /*!< `0` before star, then `1` plus number of checksum characters */
+    uint8_t pos;      /*!< Character position in current field */
+    char field;       /*!< Current field code */
+    uint8_t active;   /*!< Set to `1` while inside TAG block */
+} lwgps_tag_parser_t;
+
+#endif /* LWGPS_CFG_TAG || __DOXYGEN__ */
+
+#if LWGPS_CFG_CUSTOM || __DOXYGEN__
+struct lwgps_custom;
+#endif /* LWGPS_CFG_CUSTOM || __DOXYGEN__ */
+
+/**
+ * \brief           Groups of public fields, used as bits of field update and presence masks
+ * \note            Related fields, such as hours, minutes and seconds, share the same bit
+ */
+typedef enum {
+    LWGPS_FIELD_LATITUDE = 0x00000001,          /*!< \ref lwgps_t.latitude */
+    LWGPS_FIELD_LONGITUDE = 0x00000002,         /*!< \ref lwgps_t.longitude */
+    LWGPS_FIELD_ALTITUDE = 0x00000004,          /*!< \ref lwgps_t.altitude */
+    LWGPS_FIELD_GEO_SEP = 0x00000008,           /*!< \ref lwgps_t.geo_sep */
+    LWGPS_FIELD_SATS_IN_USE = 0x00000010,       /*!< \ref lwgps_t.sats_in_use */
+    LWGPS_FIELD_FIX = 0x00000020,               /*!< \ref lwgps_t.fix */
+    LWGPS_FIELD_TIME = 0x00000040,              /*!< \ref lwgps_t.hours, `minutes` and `seconds` */
+    LWGPS_FIELD_DGPS_AGE = 0x00000080,          /*!< \ref lwgps_t.dgps_age */
+    LWGPS_FIELD_DOP_H = 0x00000100,             /*!< \ref lwgps_t.dop_h */
+    LWGPS_FIELD_DOP_V = 0x00000200,             /*!< \ref lwgps_t.dop_v */
+    LWGPS_FIELD_DOP_P = 0x00000400,             /*!< \ref lwgps_t.dop_p */
+    LWGPS_FIELD_FIX_MODE = 0x00000800,          /*!< \ref lwgps_t.fix_mode */
+    LWGPS_FIELD_SATELLITES_IDS = 0x00001000,    /*!< \ref lwgps_t.satellites_ids */
+    LWGPS_FIELD_SATS_IN_VIEW = 0x00002000,      /*!< \ref lwgps_t.sats_in_view */
+    LWGPS_FIELD_SATS_IN_VIEW_DESC = 0x00004000, /*!< \ref lwgps_t.sats_in_view_desc */
+    LWGPS_FIELD_IS_VALID = 0x00008000,          /*!< \ref lwgps_t.is_valid */
+    LWGPS_FIELD_SPEED = 0x00010000,             /*!< \ref lwgps_t.speed */
+    LWGPS_FIELD_COURSE = 0x00020000,            /*!< \ref lwgps_t.course */
+    LWGPS_FIELD_VARIATION = 0x00040000,         /*!< \ref lwgps_t.variation */
+    LWGPS_FIELD_DATE = 0x00080000,              /*!< \ref lwgps_t.date, `month` and `year` */
+    LWGPS_FIELD_UTC_TOW = 0x00100000,           /*!< \ref lwgps_t.utc_tow */
+    LWGPS_FIELD_UTC_WK = 0x00200000,            /*!< \ref lwgps_t.utc_wk */
+    LWGPS_FIELD_LEAP_SEC = 0x00400000,          /*!< \ref lwgps_t.leap_sec */
+    LWGPS_FIELD_CLK_BIAS = 0x00800000,          /*!< \ref lwgps_t.clk_bias */
+    LWGPS_FIELD_CLK_DRIFT = 0x01000000,         /*!< \ref lwgps_t.clk_drift */
+    LWGPS_FIELD_TP_GRAN = 0x02000000,           /*!< \ref lwgps_t.tp_gran */
+    LWGPS_FIELD_AIS = 0x04000000,               /*!< \ref lwgps_t.ais */
+} lwgps_field_t;
+
+#if LWGPS_CFG_LATENCY || __DOXYGEN__
+/**
+ * \brief           Sentence latency information, in units of \ref LWGPS_CFG_LATENCY_GET_TICK ticks
+ */
+typedef struct {
+    uint32_t start;                              /*!< Tick of start character of last committed sentence */
+    uint32_t end;                                /*!< Tick of end of line of last committed sentence */
+    uint32_t commit;                             /*!< Tick of commit of last committed sentence */
+    uint32_t line_hist[LWGPS_CFG_LATENCY_BINS];  /*!< Histogram of start character to end of line */
+    uint32_t parse_hist[LWGPS_CFG_LATENCY_BINS]; /*!< Histogram of end of line to commit */
+    uint32_t total_hist[LWGPS_CFG_LATENCY_BINS]; /*!< Histogram of start character to commit */
+} lwgps_latency_t;
+#endif /* LWGPS_CFG_LATENCY || __DOXYGEN__ */
+
 /**
  * \brief           ENUM of possible GPS statements parsed
  */
@@ -80,54 +290,204 @@ typedef enum {
     STAT_RMC = 4,                  /*!< GPRMC statement */
     STAT_UBX = 5,                  /*!< UBX statement (uBlox specific) */
     STAT_UBX_TIME = 6,             /*!< UBX TIME statement (uBlox specific) */
+    STAT_UBX_NAV_PVT = 7,          /*!< UBX binary NAV-PVT message (uBlox specific) */
+    STAT_UBX_NAV_SAT = 8,          /*!< UBX binary NAV-SAT message (uBlox specific) */
+    STAT_UBX_NAV_TIMEUTC = 9,      /*!< UBX binary NAV-TIMEUTC message (uBlox specific) */
+    STAT_AIS = 10,                 /*!< AIS position report from `!xxVDM` or `!xxVDO` sentence */
+    STAT_CUSTOM = 11,              /*!< Application registered statement, see \ref lwgps_custom_register */
     STAT_CHECKSUM_FAIL = UINT8_MAX /*!< Special case, used when checksum fails */
 } lwgps_statement_t;
 
+#if LWGPS_CFG_RUNTIME_MASK || __DOXYGEN__
+
+/**
+ * \brief           Runtime features of GPS handle, see \ref lwgps_set_features
+ *
+ *                  Statement features use bit of \ref lwgps_statement_t value.
+ *                  Features, disabled at compile time, are never parsed
+ *
+ * \note            Available only if \ref LWGPS_CFG_RUNTIME_MASK is enabled
+ */
+typedef enum {
+    LWGPS_FEATURE_GGA = 1UL << STAT_GGA,                                      /*!< `GGA` statement */
+    LWGPS_FEATURE_GSA = 1UL << STAT_GSA,                                      /*!< `GSA` statement */
+    LWGPS_FEATURE_GSV = 1UL << STAT_GSV,                                      /*!< `GSV` statement */
+    LWGPS_FEATURE_RMC = 1UL << STAT_RMC,                                      /*!< `RMC` statement */
+    LWGPS_FEATURE_PUBX_TIME = (1UL << STAT_UBX) | (1UL << STAT_UBX_TIME),     /*!< `PUBX,04` statement */
+    LWGPS_FEATURE_AIS = 1UL << STAT_AIS,                                      /*!< AIS sentences */
+    LWGPS_FEATURE_CUSTOM = 1UL << STAT_CUSTOM,                                /*!< Application registered statements */
+    LWGPS_FEATURE_GSV_SAT_DET = 1UL << 16,                                    /*!< Satellite details of `GSV` */
+    LWGPS_FEATURE_CRC = 1UL << 17,                                            /*!< Reject sentences with wrong CRC */
+    LWGPS_FEATURE_ALL = 0x00030C7EUL,                                         /*!< All features */
+} lwgps_feature_t;
+
+#endif /* LWGPS_CFG_RUNTIME_MASK || __DOXYGEN__ */
+
+/**
+ * \brief           Parser scratch state of sentence being received
+ *
+ *                  Members are private to the library. Scratch state is part of \ref lwgps_t,
+ *                  or attached to it with \ref lwgps_set_scratch when \ref LWGPS_CFG_COMPACT is enabled
+ */
+typedef struct {
+#if !__DOXYGEN__
+#if LWGPS_CFG_COMPACT
+    uint8_t stat; /*!< Statement index, value of \ref lwgps_statement_t */
+#else
+    lwgps_statement_t stat; /*!< Statement index */
+#endif                     /* LWGPS_CFG_COMPACT */
+    char term_str[13];     /*!< Current term in string format */
+    uint8_t term_pos;      /*!< Current index position in term */
+    uint8_t term_num;      /*!< Current term number */
+    uint8_t field_cnt;     /*!< Number of generic fields of statement, resolved at dispatch */
+
+    uint8_t star; /*!< Star detected flag */
+#if LWGPS_CFG_CUSTOM
+    const struct lwgps_custom* custom; /*!< Descriptor of custom statement being parsed */
+#endif                                 /* LWGPS_CFG_CUSTOM */
+#if LWGPS_CFG_TAG
+    uint8_t tagged; /*!< Set to `1` when sentence is preceded by valid TAG block */
+#endif              /* LWGPS_CFG_TAG */
+#if LWGPS_CFG_LATENCY
+    uint32_t t_start; /*!< Tick of sentence start character */
+#endif                /* LWGPS_CFG_LATENCY */
+
+#if LWGPS_CFG_CRC
+    uint8_t crc_calc; /*!< Calculated CRC string */
+#endif                /* LWGPS_CFG_CRC */
+
+    uint32_t present; /*!< Bitmask of built-in statement terms received, bit position is term number */
+
+    /*
+     * Staging structures mirror layout of public fields, to commit them with single copy.
+     * Members above form control header, reset on every sentence start, while staging data
+     * is not cleared and must stay last. Terms missing in the sentence are cleared on commit
+     */
+    union {
+        uint8_t dummy; /*!< Dummy byte */
+#if LWGPS_CFG_STATEMENT_GPGGA
+        struct {
+            lwgps_float_t latitude;     /*!< GPS latitude position in degrees */
+            lwgps_float_t longitude;    /*!< GPS longitude position in degrees */
+            lwgps_float_aux_t altitude; /*!< GPS altitude in meters */
+            lwgps_float_aux_t geo_sep;  /*!< Geoid separation in units of meters */
+            lwgps_float_aux_t dgps_age; /*!< Age of DGPS correction data (in seconds) */
+            uint8_t sats_in_use;        /*!< Number of satellites currently in use */
+            uint8_t fix;     /*!< Type of current fix, `0` = Invalid, `1` = GPS fix, `2` = Differential GPS fix */
+            uint8_t hours;   /*!< Current UTC hours */
+            uint8_t minutes; /*!< Current UTC minutes */
+            uint8_t seconds; /*!< Current UTC seconds */
+        } gga;               /*!< GPGGA message */
+#endif                       /* LWGPS_CFG_STATEMENT_GPGGA */
+#if LWGPS_CFG_STATEMENT_GPGSA
+        struct {
+            uint8_t fix_mode;           /*!< Fix mode, `1` = No fix, `2` = 2D fix, `3` = 3D fix */
+            uint8_t satellites_ids[12]; /*!< IDs of satellites currently in use */
+            lwgps_float_aux_t dop_h;    /*!< Horizontal dilution of precision */
+            lwgps_float_aux_t dop_v;    /*!< Vertical dilution of precision */
+            lwgps_float_aux_t dop_p;    /*!< Position dilution of precision */
+        } gsa;                          /*!< GPGSA message */
+#endif                                  /* LWGPS_CFG_STATEMENT_GPGSA */
+#if LWGPS_CFG_STATEMENT_GPGSV
+        struct {
+            uint8_t sats_in_view; /*!< Number of stallites in view */
+            uint8_t stat_num;     /*!< Satellite line number during parsing GPGSV data */
+        } gsv;                    /*!< GPGSV message */
+#endif                            /* LWGPS_CFG_STATEMENT_GPGSV */
+#if LWGPS_CFG_STATEMENT_GPRMC
+        struct {
+            uint8_t is_valid;            /*!< Status whether GPS status is valid or not */
+            lwgps_float_aux_t speed;     /*!< Current spead over the ground in knots */
+            lwgps_float_aux_t course;    /*!< Current course over ground */
+            lwgps_float_aux_t variation; /*!< Current magnetic variation in degrees */
+            uint8_t date;                /*!< Current UTC date */
+            uint8_t month;               /*!< Current UTC month */
+            uint8_t year;                /*!< Current UTC year */
+        } rmc;                           /*!< GPRMC message */
+#endif                                   /* LWGPS_CFG_STATEMENT_GPRMC */
+#if LWGPS_CFG_STATEMENT_PUBX_TIME
+        struct {
+            uint8_t hours;               /*!< Current UTC hours */
+            uint8_t minutes;             /*!< Current UTC minutes */
+            uint8_t seconds;             /*!< Current UTC seconds */
+            uint8_t date;                /*!< Current UTC date */
+            uint8_t month;               /*!< Current UTC month */
+            uint8_t year;                /*!< Current UTC year */
+            lwgps_float_t utc_tow;       /*!< UTC TimeOfWeek, eg 113851.00 */
+            uint16_t utc_wk;             /*!< UTC week number, continues beyond 1023 */
+            uint8_t leap_sec;            /*!< UTC leap seconds; UTC + leap_sec = TAI */
+            uint32_t clk_bias;           /*!< Receiver clock bias, eg 1930035 */
+            lwgps_float_aux_t clk_drift; /*!< Receiver clock drift, eg -2660.664 */
+            uint32_t tp_gran;            /*!< Time pulse granularity, eg 43 */
+        } time;                          /*!< PUBX TIME message */
+#endif                                   /* LWGPS_CFG_STATEMENT_PUBX_TIME */
+#if LWGPS_CFG_AIS
+        struct {
+            uint16_t bits;    /*!< Write position in reassembly slot, in units of bits */
+            uint8_t frag_cnt; /*!< Number of fragments of the message */
+            uint8_t frag_num; /*!< Fragment number of this sentence */
+            uint8_t seq;      /*!< Sequential message ID, `0xFF` when empty */
+            uint8_t slot;     /*!< Reassembly slot index, `0xFF` when sentence is ignored */
+            uint8_t fill;     /*!< Number of fill bits at the end of payload */
+            uint8_t err;      /*!< Set to `1` when payload is not valid or too long */
+            uint8_t own;      /*!< Set to `1` for `VDO` sentence */
+            char channel;     /*!< Radio channel */
+        } ais;                /*!< AIS VDM and VDO message */
+#endif                        /* LWGPS_CFG_AIS */
+    } data;                   /*!< Union with data for each information */
+#endif                        /* !__DOXYGEN__ */
+} lwgps_scratch_t;
+
 /**
  * \brief           GPS main structure
+ *
+ *                  Fields of statements are ordered without padding, so time, position,
+ *                  validity and velocity of the fix share the first cache line with \ref LWGPS_CFG_COMPACT
  */
 typedef struct {
 #if LWGPS_CFG_STATEMENT_GPGGA || __DOXYGEN__
     /* Information related to GPGGA statement */
-    lwgps_float_t latitude;  /*!< Latitude in units of degrees */
-    lwgps_float_t longitude; /*!< Longitude in units of degrees */
-    lwgps_float_t altitude;  /*!< Altitude in units of meters */
-    lwgps_float_t geo_sep;   /*!< Geoid separation in units of meters */
-    uint8_t sats_in_use;     /*!< Number of satellites in use */
-    uint8_t fix;             /*!< Fix status. `0` = invalid, `1` = GPS fix, `2` = DGPS fix, `3` = PPS fix */
-    uint8_t hours;           /*!< Hours in UTC */
-    uint8_t minutes;         /*!< Minutes in UTC */
-    uint8_t seconds;         /*!< Seconds in UTC */
-    lwgps_float_t dgps_age;  /*!< Age of DGPS correction data (in seconds) */
-#endif                       /* LWGPS_CFG_STATEMENT_GPGGA || __DOXYGEN__ */
+    lwgps_float_t latitude;     /*!< Latitude in units of degrees */
+    lwgps_float_t longitude;    /*!< Longitude in units of degrees */
+    lwgps_float_aux_t altitude; /*!< Altitude in units of meters */
+    lwgps_float_aux_t geo_sep;  /*!< Geoid separation in units of meters */
+    lwgps_float_aux_t dgps_age; /*!< Age of DGPS correction data (in seconds) */
+    uint8_t sats_in_use;        /*!< Number of satellites in use */
+    uint8_t fix;                /*!< Fix status. `0` = invalid, `1` = GPS fix, `2` = DGPS fix, `3` = PPS fix */
+    uint8_t hours;              /*!< Hours in UTC */
+    uint8_t minutes;            /*!< Minutes in UTC */
+    uint8_t seconds;            /*!< Seconds in UTC */
+#endif                          /* LWGPS_CFG_STATEMENT_GPGGA || __DOXYGEN__ */
+
+#if LWGPS_CFG_STATEMENT_GPGSV || __DOXYGEN__
+    /* Information related to GPGSV statement */
+    uint8_t sats_in_view; /*!< Number of satellites in view */
+#endif                    /* LWGPS_CFG_STATEMENT_GPGSV || __DOXYGEN__ */
+
+#if LWGPS_CFG_STATEMENT_GPRMC || __DOXYGEN__
+    /* Information related to GPRMC statement */
+    uint8_t is_valid;            /*!< GPS valid status */
+    lwgps_float_aux_t speed;     /*!< Ground speed in knots */
+    lwgps_float_aux_t course;    /*!< Ground coarse */
+    lwgps_float_aux_t variation; /*!< Magnetic variation */
+    uint8_t date;                /*!< Fix date */
+    uint8_t month;               /*!< Fix month */
+    uint8_t year;                /*!< Fix year */
+#endif                           /* LWGPS_CFG_STATEMENT_GPRMC || __DOXYGEN__ */
 
 #if LWGPS_CFG_STATEMENT_GPGSA || __DOXYGEN__
     /* Information related to GPGSA statement */
-    lwgps_float_t dop_h;        /*!< Dolution of precision, horizontal */
-    lwgps_float_t dop_v;        /*!< Dolution of precision, vertical */
-    lwgps_float_t dop_p;        /*!< Dolution of precision, position */
     uint8_t fix_mode;           /*!< Fix mode. `1` = NO fix, `2` = 2D fix, `3` = 3D fix */
     uint8_t satellites_ids[12]; /*!< List of satellite IDs in use. Valid range is `0` to `sats_in_use` */
+    lwgps_float_aux_t dop_h;    /*!< Dolution of precision, horizontal */
+    lwgps_float_aux_t dop_v;    /*!< Dolution of precision, vertical */
+    lwgps_float_aux_t dop_p;    /*!< Dolution of precision, position */
 #endif                          /* LWGPS_CFG_STATEMENT_GPGSA || __DOXYGEN__ */
 
-#if LWGPS_CFG_STATEMENT_GPGSV || __DOXYGEN__
-    /* Information related to GPGSV statement */
-    uint8_t sats_in_view; /*!< Number of satellites in view */
-#if LWGPS_CFG_STATEMENT_GPGSV_SAT_DET || __DOXYGEN__
+#if (LWGPS_CFG_STATEMENT_GPGSV && LWGPS_CFG_STATEMENT_GPGSV_SAT_DET) || __DOXYGEN__
+    /* Satellite details of GPGSV statement, after fields of the fix */
     lwgps_sat_t sats_in_view_desc[12];
-#endif /* LWGPS_CFG_STATEMENT_GPGSV_SAT_DET || __DOXYGEN__ */
-#endif /* LWGPS_CFG_STATEMENT_GPGSV || __DOXYGEN__ */
-
-#if LWGPS_CFG_STATEMENT_GPRMC || __DOXYGEN__
-    /* Information related to GPRMC statement */
-    uint8_t is_valid;        /*!< GPS valid status */
-    lwgps_float_t speed;     /*!< Ground speed in knots */
-    lwgps_float_t course;    /*!< Ground coarse */
-    lwgps_float_t variation; /*!< Magnetic variation */
-    uint8_t date;            /*!< Fix date */
-    uint8_t month;           /*!< Fix month */
-    uint8_t year;            /*!< Fix year */
-#endif                       /* LWGPS_CFG_STATEMENT_GPRMC || __DOXYGEN__ */
+#endif /* (LWGPS_CFG_STATEMENT_GPGSV && LWGPS_CFG_STATEMENT_GPGSV_SAT_DET) || __DOXYGEN__ */
 
 #if LWGPS_CFG_STATEMENT_PUBX_TIME || __DOXYGEN__
 #if !LWGPS_CFG_STATEMENT_GPGGA && !__DOXYGEN__
@@ -143,88 +503,89 @@ typedef struct {
     uint8_t year;
 #endif /* !LWGPS_CFG_STATEMENT_GPRMC && !__DOXYGEN__ */
     /* fields only available in PUBX_TIME */
-    lwgps_float_t utc_tow;   /*!< UTC TimeOfWeek, eg 113851.00 */
-    uint16_t utc_wk;         /*!< UTC week number, continues beyond 1023 */
-    uint8_t leap_sec;        /*!< UTC leap seconds; UTC + leap_sec = TAI */
-    uint32_t clk_bias;       /*!< Receiver clock bias, eg 1930035 */
-    lwgps_float_t clk_drift; /*!< Receiver clock drift, eg -2660.664 */
-    uint32_t tp_gran;        /*!< Time pulse granularity, eg 43 */
-#endif                       /* LWGPS_CFG_STATEMENT_PUBX_TIME || __DOXYGEN__ */
+    lwgps_float_t utc_tow;       /*!< UTC TimeOfWeek, eg 113851.00 */
+    uint16_t utc_wk;             /*!< UTC week number, continues beyond 1023 */
+    uint8_t leap_sec;            /*!< UTC leap seconds; UTC + leap_sec = TAI */
+    uint32_t clk_bias;           /*!< Receiver clock bias, eg 1930035 */
+    lwgps_float_aux_t clk_drift; /*!< Receiver clock drift, eg -2660.664 */
+    uint32_t tp_gran;            /*!< Time pulse granularity, eg 43 */
+#endif                           /* LWGPS_CFG_STATEMENT_PUBX_TIME || __DOXYGEN__ */
 
-#if !__DOXYGEN__
+#if LWGPS_CFG_AIS || __DOXYGEN__
+    lwgps_ais_t ais; /*!< Last decoded AIS position report */
+#endif               /* LWGPS_CFG_AIS || __DOXYGEN__ */
+
+#if LWGPS_CFG_TAG || __DOXYGEN__
+    lwgps_tag_t tag; /*!< TAG block of last processed sentence */
+#endif               /* LWGPS_CFG_TAG || __DOXYGEN__ */
+
+#if LWGPS_CFG_FIELD_MASK || __DOXYGEN__
+    uint32_t fields_updated; /*!< Fields written since last \ref lwgps_fields_ack, bits of \ref lwgps_field_t */
+    uint32_t fields_present; /*!< Fields received with non-empty value when last written, bits of \ref lwgps_field_t */
+#endif                       /* LWGPS_CFG_FIELD_MASK || __DOXYGEN__ */
+
+#if LWGPS_CFG_LATENCY || __DOXYGEN__
+    lwgps_latency_t lat; /*!< Sentence latency tracing */
+#endif                   /* LWGPS_CFG_LATENCY || __DOXYGEN__ */
+
+#if LWGPS_CFG_ODOMETER || __DOXYGEN__
+    lwgps_odometer_t odo; /*!< Odometer and trip information */
+#endif                    /* LWGPS_CFG_ODOMETER || __DOXYGEN__ */
+
+#if LWGPS_CFG_REPORT_FILTER && !__DOXYGEN__
     struct {
-        lwgps_statement_t stat; /*!< Statement index */
-        char term_str[13];      /*!< Current term in string format */
-        uint8_t term_pos;       /*!< Current index position in term */
-        uint8_t term_num;       /*!< Current term number */
+        lwgps_report_filter_t cfg; /*!< Active report policy */
+        lwgps_float_t latitude;    /*!< Latitude of last reported `GGA` */
+        lwgps_float_t longitude;   /*!< Longitude of last reported `GGA` */
+        lwgps_float_t course;      /*!< Course of last reported `RMC` */
+        lwgps_float_t speed;       /*!< Speed of last reported `RMC` */
+        uint32_t pos_time;         /*!< Time of last reported `GGA`, in units of seconds of day */
+        uint32_t vel_time;         /*!< Time of last reported `RMC`, in units of seconds of day */
+        uint8_t has_pos;           /*!< Set to `1` when `GGA` has already been reported */
+        uint8_t has_vel;           /*!< Set to `1` when `RMC` has already been reported */
+    } filt;                        /*!< Report filter state */
+#endif                             /* LWGPS_CFG_REPORT_FILTER && !__DOXYGEN__ */
 
-        uint8_t star; /*!< Star detected flag */
+#if LWGPS_CFG_HISTORY && !__DOXYGEN__
+    struct {
+        lwgps_fix_t fix[LWGPS_CFG_HISTORY_LEN]; /*!< Ring buffer of fixes */
+        uint16_t head;                          /*!< Index of next write */
+        uint16_t count;                         /*!< Number of valid fixes */
+    } hist;                                     /*!< History of recent fixes */
+#endif                                          /* LWGPS_CFG_HISTORY && !__DOXYGEN__ */
 
-#if LWGPS_CFG_CRC
-        uint8_t crc_calc; /*!< Calculated CRC string */
-#endif                    /* LWGPS_CFG_CRC */
+#if LWGPS_CFG_AIS && !__DOXYGEN__
+    struct {
+        uint8_t buff[LWGPS_CFG_AIS_BUFF_SIZE + 8]; /*!< Message bits, padded for 64-bit reads */
+        uint16_t bits;                             /*!< Number of bits from committed fragments */
+        uint8_t frag_cnt;                          /*!< Number of fragments of the message */
+        uint8_t frag_next;                         /*!< Next expected fragment, `0` when slot is free */
+        uint8_t seq;                               /*!< Sequential message ID */
+        char channel;                              /*!< Radio channel */
+    } ais_slot[LWGPS_CFG_AIS_SLOTS + 1];           /*!< Reassembly table, with free slot for next first fragment */
+    uint8_t ais_victim;                            /*!< Next slot to evict when table is full */
+#endif                                             /* LWGPS_CFG_AIS && !__DOXYGEN__ */
 
-        union {
-            uint8_t dummy; /*!< Dummy byte */
-#if LWGPS_CFG_STATEMENT_GPGGA
-            struct {
-                lwgps_float_t latitude;  /*!< GPS latitude position in degrees */
-                lwgps_float_t longitude; /*!< GPS longitude position in degrees */
-                lwgps_float_t altitude;  /*!< GPS altitude in meters */
-                lwgps_float_t geo_sep;   /*!< Geoid separation in units of meters */
-                uint8_t sats_in_use;     /*!< Number of satellites currently in use */
-                uint8_t fix;     /*!< Type of current fix, `0` = Invalid, `1` = GPS fix, `2` = Differential GPS fix */
-                uint8_t hours;   /*!< Current UTC hours */
-                uint8_t minutes; /*!< Current UTC minutes */
-                uint8_t seconds; /*!< Current UTC seconds */
-                lwgps_float_t dgps_age; /*!< Age of DGPS correction data (in seconds) */
-            } gga;               /*!< GPGGA message */
-#endif                           /* LWGPS_CFG_STATEMENT_GPGGA */
-#if LWGPS_CFG_STATEMENT_GPGSA
-            struct {
-                lwgps_float_t dop_h;        /*!< Horizontal dilution of precision */
-                lwgps_float_t dop_v;        /*!< Vertical dilution of precision */
-                lwgps_float_t dop_p;        /*!< Position dilution of precision */
-                uint8_t fix_mode;           /*!< Fix mode, `1` = No fix, `2` = 2D fix, `3` = 3D fix */
-                uint8_t satellites_ids[12]; /*!< IDs of satellites currently in use */
-            } gsa;                          /*!< GPGSA message */
-#endif                                      /* LWGPS_CFG_STATEMENT_GPGSA */
-#if LWGPS_CFG_STATEMENT_GPGSV
-            struct {
-                uint8_t sats_in_view; /*!< Number of stallites in view */
-                uint8_t stat_num;     /*!< Satellite line number during parsing GPGSV data */
-            } gsv;                    /*!< GPGSV message */
-#endif                                /* LWGPS_CFG_STATEMENT_GPGSV */
-#if LWGPS_CFG_STATEMENT_GPRMC
-            struct {
-                uint8_t is_valid;        /*!< Status whether GPS status is valid or not */
-                uint8_t date;            /*!< Current UTC date */
-                uint8_t month;           /*!< Current UTC month */
-                uint8_t year;            /*!< Current UTC year */
-                lwgps_float_t speed;     /*!< Current spead over the ground in knots */
-                lwgps_float_t course;    /*!< Current course over ground */
-                lwgps_float_t variation; /*!< Current magnetic variation in degrees */
-            } rmc;                       /*!< GPRMC message */
-#endif                                   /* LWGPS_CFG_STATEMENT_GPRMC */
-#if LWGPS_CFG_STATEMENT_PUBX_TIME
-            struct {
-                uint8_t hours;           /*!< Current UTC hours */
-                uint8_t minutes;         /*!< Current UTC minutes */
-                uint8_t seconds;         /*!< Current UTC seconds */
-                uint8_t date;            /*!< Current UTC date */
-                uint8_t month;           /*!< Current UTC month */
-                uint8_t year;            /*!< Current UTC year */
-                lwgps_float_t utc_tow;   /*!< UTC TimeOfWeek, eg 113851.00 */
-                uint16_t utc_wk;         /*!< UTC week number, continues beyond 1023 */
-                uint8_t leap_sec;        /*!< UTC leap seconds; UTC + leap_sec = TAI */
-                uint32_t clk_bias;       /*!< Receiver clock bias, eg 1930035 */
-                lwgps_float_t clk_drift; /*!< Receiver clock drift, eg -2660.664 */
-                uint32_t tp_gran;        /*!< Time pulse granularity, eg 43 */
-            } time;                      /*!< PUBX TIME message */
-#endif                                   /* LWGPS_CFG_STATEMENT_PUBX_TIME */
-        } data;                          /*!< Union with data for each information */
-    } p;                                 /*!< Structure with private data */
-#endif                                   /* !__DOXYGEN__ */
+#if LWGPS_CFG_CUSTOM && !__DOXYGEN__
+    const struct lwgps_custom* custom[LWGPS_CFG_CUSTOM_MAX]; /*!< Registered custom statements */
+    uint8_t custom_hash[2 * LWGPS_CFG_CUSTOM_MAX];          /*!< Address hash table, index plus `1` or `0` if empty */
+#endif                                                      /* LWGPS_CFG_CUSTOM && !__DOXYGEN__ */
+
+#if LWGPS_CFG_RUNTIME_MASK && !__DOXYGEN__
+    uint32_t features_off; /*!< Disabled features, bits of \ref lwgps_feature_t, zero handle has all enabled */
+#endif                     /* LWGPS_CFG_RUNTIME_MASK && !__DOXYGEN__ */
+
+#if LWGPS_CFG_TAG && !__DOXYGEN__
+    lwgps_tag_parser_t tag_p; /*!< TAG block parser */
+#endif                        /* LWGPS_CFG_TAG && !__DOXYGEN__ */
+
+#if !__DOXYGEN__
+#if LWGPS_CFG_COMPACT
+    lwgps_scratch_t* p; /*!< Parser scratch state, attached with \ref lwgps_set_scratch */
+#else
+    lwgps_scratch_t p[1]; /*!< Parser scratch state */
+#endif /* LWGPS_CFG_COMPACT */
+#endif /* !__DOXYGEN__ */
 } lwgps_t;
 
 /**
@@ -277,6 +638,103 @@ typedef enum {
  */
 typedef void (*lwgps_process_fn)(lwgps_statement_t res);
 
+/**
+ * \brief           Processing budget, see \ref lwgps_process_budget
+ *
+ *                  Limits are checked at the end of every line and at the start of every sentence.
+ *                  Byte limit is also checked inside the line and deadline is polled every few bytes there.
+ *                  Set unused limits to `0` or `NULL`
+ */
+typedef struct {
+    size_t max_bytes;                 /*!< Stop after this number of bytes has been processed */
+    size_t max_sentences;             /*!< Stop after this number of lines has been processed */
+    uint8_t (*expired_fn)(void* arg); /*!< Deadline callback, returns `1` when processing shall stop */
+    void* arg;                        /*!< Custom argument passed to `expired_fn` */
+} lwgps_budget_t;
+
+/**
+ * \brief           Segment of input data, see \ref lwgps_processv
+ */
+typedef struct {
+    const void* data; /*!< Pointer to segment data */
+    size_t len;       /*!< Length of segment in units of bytes */
+} lwgps_iovec_t;
+
+#if LWGPS_CFG_CUSTOM || __DOXYGEN__
+
+/**
+ * \brief           Signature for custom statement field decode function
+ * \param[in]       gh: GPS handle
+ * \param[in]       desc: Statement descriptor
+ * \param[in]       term_num: Field number, starting with `1` for the first field after address
+ * \param[in]       term: Field value as `NULL` terminated string, truncated to `12` characters
+ */
+typedef void (*lwgps_custom_term_fn)(lwgps_t* gh, const struct lwgps_custom* desc, uint8_t term_num,
+                                     const char* term);
+
+/**
+ * \brief           Signature for custom statement commit function,
+ *                  called when complete statement is received with valid checksum
+ * \param[in]       gh: GPS handle
+ * \param[in]       desc: Statement descriptor
+ */
+typedef void (*lwgps_custom_commit_fn)(lwgps_t* gh, const struct lwgps_custom* desc);
+
+/**
+ * \brief           Custom statement descriptor
+ * \note            Descriptor must stay valid while GPS handle is in use
+ */
+typedef struct lwgps_custom {
+    const char* addr;                 /*!< Address field without start character, for example `PGRME` */
+    uint8_t field_cnt;                /*!< Number of fields passed to decode function, the rest are ignored */
+    lwgps_custom_term_fn term_fn;     /*!< Field decode function, typically writes to staging memory */
+    lwgps_custom_commit_fn commit_fn; /*!< Commit function, typically copies staging to application memory */
+    void* arg;                        /*!< Custom user argument, for example pointer to staging memory */
+} lwgps_custom_t;
+
+#endif /* LWGPS_CFG_CUSTOM || __DOXYGEN__ */
+
+#if LWGPS_CFG_DEMUX || __DOXYGEN__
+
+/**
+ * \brief           List of protocols recognized by demultiplexer
+ */
+typedef enum {
+    LWGPS_PROTO_NONE = 0x00, /*!< No frame in progress */
+    LWGPS_PROTO_NMEA,        /*!< NMEA 0183 sentence */
+    LWGPS_PROTO_UBX,         /*!< UBX binary frame */
+    LWGPS_PROTO_RTCM3,       /*!< RTCM 3 correction frame */
+} lwgps_proto_t;
+
+struct lwgps_demux;
+
+/**
+ * \brief           Signature for caller-suplied callback function with validated binary frame
+ * \param[in]       dh: Demultiplexer handle
+ * \param[in]       proto: Protocol of the frame
+ * \param[in]       frame: Complete frame, including header and checksum.
+ *                      Memory is valid only during callback
+ * \param[in]       len: Frame length in units of bytes
+ */
+typedef void (*lwgps_frame_fn)(struct lwgps_demux* dh, lwgps_proto_t proto, const void* frame, size_t len);
+
+/**
+ * \brief           Protocol demultiplexer handle
+ */
+typedef struct lwgps_demux {
+    lwgps_t* gps;            /*!< GPS handle for NMEA sentences and UBX frames. Can be set to `NULL` */
+    lwgps_frame_fn frame_fn; /*!< Callback for validated UBX and RTCM3 frames. Can be set to `NULL` */
+    uint32_t crc_err;        /*!< Number of binary frames dropped due to checksum error */
+#if !__DOXYGEN__
+    lwgps_proto_t proto;                     /*!< Protocol of frame in progress */
+    size_t frame_len;                        /*!< Expected frame length, `0` until header is complete */
+    size_t len;                              /*!< Number of bytes in buffer */
+    uint8_t buff[LWGPS_CFG_DEMUX_BUFF_SIZE]; /*!< Buffer for frames split across input chunks */
+#endif                                       /* !__DOXYGEN__ */
+} lwgps_demux_t;
+
+#endif /* LWGPS_CFG_DEMUX || __DOXYGEN__ */
+
 /**
  * \brief           Check if current GPS data contain valid signal
  * \note            \ref LWGPS_CFG_STATEMENT_GPRMC must be enabled and `GPRMC` statement must be sent from GPS receiver
@@ -290,14 +748,79 @@ typedef void (*lwgps_process_fn)(lwgps_statement_t res);
 #endif /* LWGPS_CFG_STATEMENT_GPRMC || __DOXYGEN__ */
 
 uint8_t lwgps_init(lwgps_t* gh);
+#if LWGPS_CFG_COMPACT || __DOXYGEN__
+uint8_t lwgps_set_scratch(lwgps_t* gh, lwgps_scratch_t* scratch);
+#endif /* LWGPS_CFG_COMPACT || __DOXYGEN__ */
 #if LWGPS_CFG_STATUS || __DOXYGEN__
 uint8_t lwgps_process(lwgps_t* gh, const void* data, size_t len, lwgps_process_fn evt_fn);
 #else  /* LWGPS_CFG_STATUS */
 uint8_t lwgps_process(lwgps_t* gh, const void* data, size_t len);
 #endif /* !LWGPS_CFG_STATUS */
+#if LWGPS_CFG_STATUS || __DOXYGEN__
+uint8_t lwgps_processv(lwgps_t* gh, const lwgps_iovec_t* iov, size_t iovcnt, lwgps_process_fn evt_fn);
+#else  /* LWGPS_CFG_STATUS */
+uint8_t lwgps_processv(lwgps_t* gh, const lwgps_iovec_t* iov, size_t iovcnt);
+#endif /* !LWGPS_CFG_STATUS */
+#if LWGPS_CFG_STATUS || __DOXYGEN__
+size_t lwgps_process_budget(lwgps_t* gh, const void* data, size_t len, const lwgps_budget_t* budget,
+                            lwgps_process_fn evt_fn);
+#else  /* LWGPS_CFG_STATUS */
+size_t lwgps_process_budget(lwgps_t* gh, const void* data, size_t len, const lwgps_budget_t* budget);
+#endif /* !LWGPS_CFG_STATUS */
+#if LWGPS_CFG_UBX || __DOXYGEN__
+#if LWGPS_CFG_STATUS || __DOXYGEN__
+uint8_t lwgps_process_ubx(lwgps_t* gh, const void* frame, size_t len, lwgps_process_fn evt_fn);
+#else  /* LWGPS_CFG_STATUS */
+uint8_t lwgps_process_ubx(lwgps_t* gh, const void* frame, size_t len);
+#endif /* !LWGPS_CFG_STATUS */
+#endif /* LWGPS_CFG_UBX || __DOXYGEN__ */
+#if LWGPS_CFG_CUSTOM || __DOXYGEN__
+uint8_t lwgps_custom_register(lwgps_t* gh, const lwgps_custom_t* desc);
+#endif /* LWGPS_CFG_CUSTOM || __DOXYGEN__ */
+#if LWGPS_CFG_FIELD_MASK || __DOXYGEN__
+uint32_t lwgps_fields_ack(lwgps_t* gh);
+#endif /* LWGPS_CFG_FIELD_MASK || __DOXYGEN__ */
+#if LWGPS_CFG_TAG || __DOXYGEN__
+size_t lwgps_tag_parse(const void* data, size_t len, lwgps_tag_t* tag);
+#endif /* LWGPS_CFG_TAG || __DOXYGEN__ */
+#if LWGPS_CFG_DEMUX || __DOXYGEN__
+uint8_t lwgps_demux_init(lwgps_demux_t* dh, lwgps_t* gh, lwgps_frame_fn frame_fn);
+#if LWGPS_CFG_STATUS || __DOXYGEN__
+uint8_t lwgps_demux_process(lwgps_demux_t* dh, const void* data, size_t len, lwgps_process_fn evt_fn);
+#else  /* LWGPS_CFG_STATUS */
+uint8_t lwgps_demux_process(lwgps_demux_t* dh, const void* data, size_t len);
+#endif /* !LWGPS_CFG_STATUS */
+#endif /* LWGPS_CFG_DEMUX || __DOXYGEN__ */
 uint8_t lwgps_distance_bearing(lwgps_float_t las, lwgps_float_t los, lwgps_float_t lae, lwgps_float_t loe,
                                lwgps_float_t* d, lwgps_float_t* b);
 lwgps_float_t lwgps_to_speed(lwgps_float_t sik, lwgps_speed_t ts);
+#if LWGPS_CFG_LATENCY || __DOXYGEN__
+uint8_t lwgps_latency_reset(lwgps_t* gh);
+uint32_t lwgps_latency_percentile(const uint32_t* hist, uint8_t percent);
+#endif /* LWGPS_CFG_LATENCY || __DOXYGEN__ */
+#if LWGPS_CFG_CHECKPOINT || __DOXYGEN__
+size_t lwgps_checkpoint_save(const lwgps_t* gh, void* buff, size_t len);
+uint8_t lwgps_checkpoint_load(lwgps_t* gh, const void* buff, size_t len);
+#endif /* LWGPS_CFG_CHECKPOINT || __DOXYGEN__ */
+#if LWGPS_CFG_ODOMETER || __DOXYGEN__
+uint8_t lwgps_odometer_reset(lwgps_t* gh);
+#endif /* LWGPS_CFG_ODOMETER || __DOXYGEN__ */
+#if LWGPS_CFG_REPORT_FILTER || __DOXYGEN__
+uint8_t lwgps_set_report_filter(lwgps_t* gh, const lwgps_report_filter_t* filter);
+#endif /* LWGPS_CFG_REPORT_FILTER || __DOXYGEN__ */
+#if LWGPS_CFG_RUNTIME_MASK || __DOXYGEN__
+uint8_t lwgps_set_features(lwgps_t* gh, uint32_t features);
+#endif /* LWGPS_CFG_RUNTIME_MASK || __DOXYGEN__ */
+#if LWGPS_CFG_SIMPLIFY || __DOXYGEN__
+uint8_t lwgps_simplify_init(lwgps_simplify_t* sh, lwgps_float_t tolerance);
+uint8_t lwgps_simplify_add(lwgps_simplify_t* sh, const lwgps_point_t* pt, lwgps_point_t* out);
+uint8_t lwgps_simplify_flush(lwgps_simplify_t* sh, lwgps_point_t* out);
+#endif /* LWGPS_CFG_SIMPLIFY || __DOXYGEN__ */
+#if LWGPS_CFG_HISTORY || __DOXYGEN__
+size_t lwgps_history_count(const lwgps_t* gh);
+const lwgps_fix_t* lwgps_history_get(const lwgps_t* gh, size_t idx);
+uint8_t lwgps_history_kinematics(const lwgps_t* gh, lwgps_kinematics_t* kin);
+#endif /* LWGPS_CFG_HISTORY || __DOXYGEN__ */
 
 /**
  * \}
@@ -34,30 +34,353 @@
 #ifndef LWGPS_HDR_HPP
 #define LWGPS_HDR_HPP
 
+#include <cstddef>
+#include <cstdint>
 #include "lwgps/lwgps.h"
 
+#if __cplusplus >= 201703L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L)
+#define LWGPS_HPP_CPP17 1
+#include <iterator>
+#include <string_view>
+#if __has_include(<span>)
+#include <span>
+#endif
+#endif
+
 namespace Lwgps {
 class Lwgps {
+  public:
+    /**
+     * \brief           UTC time of fix
+     */
+    struct Time {
+        uint8_t hours;   /*!< Hours in UTC */
+        uint8_t minutes; /*!< Minutes in UTC */
+        uint8_t seconds; /*!< Seconds in UTC */
+    };
+
+    /**
+     * \brief           UTC date of fix
+     */
+    struct Date {
+        uint8_t date;  /*!< Day of month */
+        uint8_t month; /*!< Month */
+        uint8_t year;  /*!< Year, `0` for `2000` */
+    };
+
+    /**
+     * \brief           Read-only view of fix data, with typed accessors
+     *
+     *                  Accessors exist only for fields enabled in configuration
+     */
+    class Fix {
+      public:
+#if LWGPS_CFG_STATEMENT_GPGGA || __DOXYGEN__
+        lwgps_float_t
+        latitude() const noexcept {
+            return m_gps.latitude;
+        }
+
+        lwgps_float_t
+        longitude() const noexcept {
+            return m_gps.longitude;
+        }
+
+        lwgps_float_t
+        altitude() const noexcept {
+            return m_gps.altitude;
+        }
+
+        lwgps_float_t
+        geo_sep() const noexcept {
+            return m_gps.geo_sep;
+        }
+
+        lwgps_float_t
+        dgps_age() const noexcept {
+            return m_gps.dgps_age;
+        }
+
+        uint8_t
+        sats_in_use() const noexcept {
+            return m_gps.sats_in_use;
+        }
+
+        /**
+         * \brief           Get fix status
+         * \return          `0` = invalid, `1` = GPS fix, `2` = DGPS fix, `3` = PPS fix
+         */
+        uint8_t
+        fix() const noexcept {
+            return m_gps.fix;
+        }
+#endif /* LWGPS_CFG_STATEMENT_GPGGA || __DOXYGEN__ */
+
+#if LWGPS_CFG_STATEMENT_GPGGA || LWGPS_CFG_STATEMENT_PUBX_TIME || __DOXYGEN__
+        Time
+        time() const noexcept {
+            return Time{m_gps.hours, m_gps.minutes, m_gps.seconds};
+        }
+#endif /* LWGPS_CFG_STATEMENT_GPGGA || LWGPS_CFG_STATEMENT_PUBX_TIME || __DOXYGEN__ */
+
+#if LWGPS_CFG_STATEMENT_GPGSA || __DOXYGEN__
+        lwgps_float_t
+        dop_h() const noexcept {
+            return m_gps.dop_h;
+        }
+
+        lwgps_float_t
+        dop_v() const noexcept {
+            return m_gps.dop_v;
+        }
+
+        lwgps_float_t
+        dop_p() const noexcept {
+            return m_gps.dop_p;
+        }
+
+        /**
+         * \brief           Get fix mode
+         * \return          `1` = NO fix, `2` = 2D fix, `3` = 3D fix
+         */
+        uint8_t
+        fix_mode() const noexcept {
+            return m_gps.fix_mode;
+        }
+
+        /**
+         * \brief           Get IDs of satellites in use, unused entries are `0`
+         * \return          Array of `12` satellite IDs
+         */
+        const uint8_t (&satellites_ids() const noexcept)[12] {
+            return m_gps.satellites_ids;
+        }
+#endif /* LWGPS_CFG_STATEMENT_GPGSA || __DOXYGEN__ */
+
+#if LWGPS_CFG_STATEMENT_GPGSV || __DOXYGEN__
+        uint8_t
+        sats_in_view() const noexcept {
+            return m_gps.sats_in_view;
+        }
+
+#if LWGPS_CFG_STATEMENT_GPGSV_SAT_DET || __DOXYGEN__
+        /**
+         * \brief           Get descriptors of satellites in view
+         * \return          Array of `12` satellite descriptors
+         */
+        const lwgps_sat_t (&sats_in_view_desc() const noexcept)[12] {
+            return m_gps.sats_in_view_desc;
+        }
+#endif /* LWGPS_CFG_STATEMENT_GPGSV_SAT_DET || __DOXYGEN__ */
+#endif /* LWGPS_CFG_STATEMENT_GPGSV || __DOXYGEN__ */
+
+#if LWGPS_CFG_STATEMENT_GPRMC || __DOXYGEN__
+        bool
+        is_valid() const noexcept {
+            return m_gps.is_valid != 0;
+        }
+
+        /**
+         * \brief           Get ground speed
+         * \return          Speed in units of knots
+         */
+        lwgps_float_t
+        speed() const noexcept {
+            return m_gps.speed;
+        }
+
+        /**
+         * \brief           Get ground speed in selected unit
+         * \param[in]       ts: Target speed unit
+         * \return          Speed in target unit
+         */
+        lwgps_float_t
+        speed(lwgps_speed_t ts) const noexcept {
+            return lwgps_to_speed(m_gps.speed, ts);
+        }
+
+        lwgps_float_t
+        course() const noexcept {
+            return m_gps.course;
+        }
+
+        lwgps_float_t
+        variation() const noexcept {
+            return m_gps.variation;
+        }
+#endif /* LWGPS_CFG_STATEMENT_GPRMC || __DOXYGEN__ */
+
+#if LWGPS_CFG_STATEMENT_GPRMC || LWGPS_CFG_STATEMENT_PUBX_TIME || __DOXYGEN__
+        Date
+        date() const noexcept {
+            return Date{m_gps.date, m_gps.month, m_gps.year};
+        }
+#endif /* LWGPS_CFG_STATEMENT_GPRMC || LWGPS_CFG_STATEMENT_PUBX_TIME || __DOXYGEN__ */
+
+#if LWGPS_CFG_STATEMENT_PUBX_TIME || __DOXYGEN__
+        lwgps_float_t
+        utc_tow() const noexcept {
+            return m_gps.utc_tow;
+        }
+
+        uint16_t
+        utc_wk() const noexcept {
+            return m_gps.utc_wk;
+        }
+
+        uint8_t
+        leap_sec() const noexcept {
+            return m_gps.leap_sec;
+        }
+
+        uint32_t
+        clk_bias() const noexcept {
+            return m_gps.clk_bias;
+        }
+
+        lwgps_float_t
+        clk_drift() const noexcept {
+            return m_gps.clk_drift;
+        }
+
+        uint32_t
+        tp_gran() const noexcept {
+            return m_gps.tp_gran;
+        }
+#endif /* LWGPS_CFG_STATEMENT_PUBX_TIME || __DOXYGEN__ */
+
+#if LWGPS_CFG_FIELD_MASK || __DOXYGEN__
+        /**
+         * \brief           Get fields written since last \ref lwgps_fields_ack
+         * \return          Bits of \ref lwgps_field_t
+         */
+        uint32_t
+        fields_updated() const noexcept {
+            return m_gps.fields_updated;
+        }
+
+        /**
+         * \brief           Get fields received with non-empty value
+         * \return          Bits of \ref lwgps_field_t
+         */
+        uint32_t
+        fields_present() const noexcept {
+            return m_gps.fields_present;
+        }
+#endif /* LWGPS_CFG_FIELD_MASK || __DOXYGEN__ */
+
+#if LWGPS_CFG_TAG || __DOXYGEN__
+        const lwgps_tag_t&
+        tag() const noexcept {
+            return m_gps.tag;
+        }
+#endif /* LWGPS_CFG_TAG || __DOXYGEN__ */
+
+#if LWGPS_CFG_AIS || __DOXYGEN__
+        const lwgps_ais_t&
+        ais() const noexcept {
+            return m_gps.ais;
+        }
+#endif /* LWGPS_CFG_AIS || __DOXYGEN__ */
+
+#if LWGPS_CFG_ODOMETER || __DOXYGEN__
+        const lwgps_odometer_t&
+        odometer() const noexcept {
+            return m_gps.odo;
+        }
+#endif /* LWGPS_CFG_ODOMETER || __DOXYGEN__ */
+
+        /**
+         * \brief           Get underlying C handle, for functions without C++ wrapper
+         * \return          GPS handle
+         */
+        const lwgps_t&
+        handle() const noexcept {
+            return m_gps;
+        }
+
+      private:
+        friend class Lwgps;
+        lwgps_t m_gps;
+    };
+
   private:
-    lwgps_t m_hgps;
+    Fix m_fix;
+
+#if LWGPS_CFG_COMPACT
+    lwgps_scratch_t m_scratch; /* Parser scratch state, owned by the wrapper */
+#endif                         /* LWGPS_CFG_COMPACT */
 
 #if LWGPS_CFG_STATUS || __DOXYGEN__
     lwgps_process_fn m_procfn;
 #endif /* LWGPS_CFG_STATUS || __DOXYGEN__ */
 
+    /**
+     * \brief           Reset handle to initial state
+     */
+    void
+    reset() noexcept {
+        lwgps_init(&m_fix.m_gps);
+#if LWGPS_CFG_COMPACT
+        lwgps_set_scratch(&m_fix.m_gps, &m_scratch);
+#endif /* LWGPS_CFG_COMPACT */
+    }
+
+    /**
+     * \brief           Take over scratch state of sentence being received from other handle
+     * \param[in]       other: Handle to take scratch state from
+     */
+    void
+    take_scratch(const Lwgps& other) noexcept {
+#if LWGPS_CFG_COMPACT
+        m_scratch = other.m_scratch;
+        m_fix.m_gps.p = &m_scratch; /* Copied handle points to scratch state of the other */
+#else
+        (void)other; /* Scratch state is part of the handle */
+#endif /* LWGPS_CFG_COMPACT */
+    }
+
   public:
     Lwgps(const Lwgps& other) = delete;            /* No copy constructor */
     Lwgps& operator=(const Lwgps& other) = delete; /* No copy assignment */
-    Lwgps(const Lwgps&& other) = delete;           /* No move constructor */
-    Lwgps& operator=(Lwgps&& other) = delete;      /* No move assignment */
 
     Lwgps() { /* Constructor */
-        lwgps_init(&m_hgps);
+        reset();
 #if LWGPS_CFG_STATUS
         m_procfn = nullptr;
 #endif /* LWGPS_CFG_STATUS */
     }
 
+    /**
+     * \brief           Move constructor, moved-from handle is reset to initial state
+     * \param[in,out]   other: Handle to move from
+     */
+    Lwgps(Lwgps&& other) noexcept : m_fix(other.m_fix) {
+#if LWGPS_CFG_STATUS
+        m_procfn = other.m_procfn;
+#endif /* LWGPS_CFG_STATUS */
+        take_scratch(other);
+        other.reset();
+    }
+
+    /**
+     * \brief           Move assignment, moved-from handle is reset to initial state
+     * \param[in,out]   other: Handle to move from
+     * \return          Reference to this handle
+     */
+    Lwgps&
+    operator=(Lwgps&& other) noexcept {
+        if (this != &other) {
+            m_fix = other.m_fix;
+#if LWGPS_CFG_STATUS
+            m_procfn = other.m_procfn;
+#endif /* LWGPS_CFG_STATUS */
+            take_scratch(other);
+            other.reset();
+        }
+        return *this;
+    }
+
 #if LWGPS_CFG_STATUS || __DOXYGEN__
     /**
      * \brief           Set processing callback function
@@ -78,7 +401,7 @@ class Lwgps {
      */
     uint8_t
     process(const void* data, size_t len) {
-        return lwgps_process(&m_hgps, data, len
+        return lwgps_process(&m_fix.m_gps, data, len
 #if LWGPS_CFG_STATUS
                              ,
                              m_procfn
@@ -86,6 +409,48 @@ class Lwgps {
         );
     }
 
+#if LWGPS_HPP_CPP17 || __DOXYGEN__
+    /**
+     * \brief           Process NMEA data from GPS receiver
+     * \param[in]       data: Received characters
+     * \return          `1` on success, `0` otherwise
+     */
+    uint8_t
+    process(std::string_view data) {
+        return process(data.data(), data.size());
+    }
+#endif /* LWGPS_HPP_CPP17 || __DOXYGEN__ */
+
+#if __cpp_lib_span || __DOXYGEN__
+    /**
+     * \brief           Process NMEA data from GPS receiver
+     * \param[in]       data: Received bytes
+     * \return          `1` on success, `0` otherwise
+     */
+    uint8_t
+    process(std::span<const std::byte> data) {
+        return process(data.data(), data.size());
+    }
+#endif /* __cpp_lib_span || __DOXYGEN__ */
+
+    /**
+     * \brief           Get fix data, updated on every processed sentence
+     * \return          Fix view
+     */
+    const Fix&
+    fix() const noexcept {
+        return m_fix;
+    }
+
+    /**
+     * \brief           Get underlying C handle, for functions without C++ wrapper
+     * \return          GPS handle
+     */
+    lwgps_t*
+    handle() noexcept {
+        return &m_fix.m_gps;
+    }
+
 #if LWESP_CFG_DISTANCE_BEARING || __DOXYGEN__
 
     /**
@@ -119,6 +484,378 @@ class Lwgps {
     ~Lwgps() { /* Destructor */
     }
 };
+
+#if LWGPS_HPP_CPP17 || __DOXYGEN__
+
+/**
+ * \brief           View of single NMEA sentence in application buffer
+ *
+ *                  Sentence and its fields are views of the buffer, nothing is copied.
+ *                  Buffer must outlive the view
+ */
+class Sentence {
+  public:
+    /**
+     * \brief           Forward iterator over comma separated fields
+     */
+    class FieldIterator {
+      public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::string_view;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const std::string_view*;
+        using reference = std::string_view;
+
+        FieldIterator() = default;
+
+        /**
+         * \brief           Construct iterator at field starting at `pos`
+         * \param[in]       data: Data part of sentence
+         * \param[in]       pos: Position of field start, `data.size() + 1` for end iterator
+         */
+        FieldIterator(std::string_view data, size_t pos) : m_data(data), m_pos(pos) {
+            m_len = field_len();
+        }
+
+        std::string_view
+        operator*() const noexcept {
+            return m_data.substr(m_pos, m_len);
+        }
+
+        FieldIterator&
+        operator++() noexcept {
+            m_pos += m_len + 1;
+            m_len = field_len();
+            return *this;
+        }
+
+        FieldIterator
+        operator++(int) noexcept {
+            FieldIterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        bool
+        operator==(const FieldIterator& other) const noexcept {
+            return m_pos == other.m_pos;
+        }
+
+        bool
+        operator!=(const FieldIterator& other) const noexcept {
+            return m_pos != other.m_pos;
+        }
+
+      private:
+        std::string_view m_data;
+        size_t m_pos = 0;
+        size_t m_len = 0;
+
+        size_t
+        field_len() const noexcept {
+            size_t end;
+
+            if (m_pos > m_data.size()) {
+                return 0;
+            }
+            end = m_data.find(',', m_pos);
+            return (end == std::string_view::npos ? m_data.size() : end) - m_pos;
+        }
+    };
+
+    /**
+     * \brief           Range of sentence fields
+     */
+    struct Fields {
+        FieldIterator first; /*!< First field */
+        FieldIterator last;  /*!< End of fields */
+
+        FieldIterator
+        begin() const noexcept {
+            return first;
+        }
+
+        FieldIterator
+        end() const noexcept {
+            return last;
+        }
+    };
+
+    Sentence() = default;
+
+    /**
+     * \brief           Construct view of sentence
+     * \param[in]       line: Sentence from start character, without line end characters
+     */
+    explicit Sentence(std::string_view line) : m_line(line) {}
+
+    /**
+     * \brief           Get full sentence
+     * \return          Sentence from start character, including checksum, without line end characters
+     */
+    std::string_view
+    text() const noexcept {
+        return m_line;
+    }
+
+    /**
+     * \brief           Get data part of sentence, covered by checksum
+     * \return          Sentence between start character and `*` character
+     */
+    std::string_view
+    data() const noexcept {
+        size_t star = m_line.find('*');
+
+        if (m_line.empty()) {
+            return std::string_view();
+        }
+        return m_line.substr(1, star == std::string_view::npos ? star : star - 1);
+    }
+
+    /**
+     * \brief           Get fields of sentence, address field is first
+     * \return          Range of fields
+     */
+    Fields
+    fields() const noexcept {
+        std::string_view d = data();
+
+        return Fields{FieldIterator(d, 0), FieldIterator(d, d.size() + 1)};
+    }
+
+    /**
+     * \brief           Get number of fields, including address field
+     * \return          Number of fields
+     */
+    size_t
+    size() const noexcept {
+        std::string_view d = data();
+        size_t cnt = 1;
+
+        for (char c : d) {
+            cnt += c == ',';
+        }
+        return cnt;
+    }
+
+    /**
+     * \brief           Get single field
+     * \param[in]       index: Field index, `0` for address field such as `GPGGA`
+     * \return          Field, empty when index is out of range
+     */
+    std::string_view
+    operator[](size_t index) const noexcept {
+        Fields f = fields();
+
+        for (; index > 0 && f.first != f.last; --index) {
+            ++f.first;
+        }
+        return f.first != f.last ? *f.first : std::string_view();
+    }
+
+    /**
+     * \brief           Get address field, such as `GPGGA`
+     * \return          Address field
+     */
+    std::string_view
+    address() const noexcept {
+        return (*this)[0];
+    }
+
+    /**
+     * \brief           Check received checksum against checksum of data
+     * \return          `true` when checksum is present and valid
+     */
+    bool
+    checksum_ok() const noexcept {
+        size_t star = m_line.find('*');
+        uint8_t crc = 0;
+
+        if (star == std::string_view::npos || m_line.size() < star + 3) {
+            return false;
+        }
+        for (char c : data()) {
+            crc ^= (uint8_t)c;
+        }
+        return crc == (uint8_t)((hex_value(m_line[star + 1]) << 4) | hex_value(m_line[star + 2]));
+    }
+
+    /**
+     * \brief           Get built-in statement of sentence, with the same rules as \ref lwgps_process
+     * \return          Statement, \ref STAT_UNKNOWN for other sentences
+     */
+    lwgps_statement_t
+    statement() const noexcept {
+        std::string_view a = address();
+
+        if (m_line.empty()) {
+            return STAT_UNKNOWN;
+        } else if (m_line[0] == '!') {
+            return a.size() >= 5 && (a.substr(2, 3) == "VDM" || a.substr(2, 3) == "VDO") ? STAT_AIS : STAT_UNKNOWN;
+        } else if (a.substr(0, 4) == "PUBX") {
+            return (*this)[1] == "04" ? STAT_UBX_TIME : STAT_UBX;
+        } else if (a.size() < 5 || (a.substr(0, 2) != "GP" && a.substr(0, 2) != "GN")) {
+            return STAT_UNKNOWN;
+        }
+        a = a.substr(2, 3);
+        return a == "GGA"   ? STAT_GGA
+               : a == "GSA" ? STAT_GSA
+               : a == "GSV" ? STAT_GSV
+               : a == "RMC" ? STAT_RMC
+                            : STAT_UNKNOWN;
+    }
+
+  private:
+    std::string_view m_line;
+
+    static uint8_t
+    hex_value(char c) noexcept {
+        return (uint8_t)((c >= '0' && c <= '9')   ? c - '0'
+                         : (c >= 'a' && c <= 'f') ? c - 'a' + 10
+                         : (c >= 'A' && c <= 'F') ? c - 'A' + 10
+                                                  : 0);
+    }
+};
+
+/**
+ * \brief           Lazy range of complete sentences in application buffer
+ *
+ *                  Sentence starts with `$` or `!` character and ends with `\r` or `\n` character.
+ *                  Sentence without line end at the end of buffer is not complete and is not part of range,
+ *                  \ref rest returns it to be processed together with next data
+ */
+class SentenceRange {
+  public:
+    /**
+     * \brief           Forward iterator, finds next sentence on increment
+     */
+    class iterator {
+      public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Sentence;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Sentence*;
+        using reference = const Sentence&;
+
+        iterator() = default;
+
+        explicit iterator(std::string_view buf) : m_rest(buf), m_end(false) {
+            next();
+        }
+
+        const Sentence&
+        operator*() const noexcept {
+            return m_cur;
+        }
+
+        const Sentence*
+        operator->() const noexcept {
+            return &m_cur;
+        }
+
+        iterator&
+        operator++() noexcept {
+            next();
+            return *this;
+        }
+
+        iterator
+        operator++(int) noexcept {
+            iterator tmp = *this;
+            next();
+            return tmp;
+        }
+
+        bool
+        operator==(const iterator& other) const noexcept {
+            return m_end == other.m_end && (m_end || m_cur.text().data() == other.m_cur.text().data());
+        }
+
+        bool
+        operator!=(const iterator& other) const noexcept {
+            return !(*this == other);
+        }
+
+      private:
+        std::string_view m_rest;
+        Sentence m_cur;
+        bool m_end = true;
+
+        void
+        next() noexcept {
+            size_t start, end, restart;
+
+            while (!m_end) {
+                if ((start = m_rest.find_first_of("$!")) == std::string_view::npos
+                    || (end = m_rest.find_first_of("\r\n", start)) == std::string_view::npos) {
+                    m_end = true; /* No more complete sentences */
+                } else if ((restart = m_rest.find_first_of("$!", start + 1)) < end) {
+                    m_rest.remove_prefix(restart); /* Sentence without line end is dropped */
+                } else {
+                    m_cur = Sentence(m_rest.substr(start, end - start));
+                    m_rest.remove_prefix(end);
+                    break;
+                }
+            }
+        }
+    };
+
+    /**
+     * \brief           Construct range over buffer
+     * \param[in]       buf: Buffer with received data
+     */
+    explicit SentenceRange(std::string_view buf) : m_buf(buf) {}
+
+    iterator
+    begin() const noexcept {
+        return iterator(m_buf);
+    }
+
+    iterator
+    end() const noexcept {
+        return iterator();
+    }
+
+    /**
+     * \brief           Get data after last complete sentence
+     * \return          Incomplete sentence at the end of buffer, empty if there is none
+     */
+    std::string_view
+    rest() const noexcept {
+        size_t last = m_buf.find_last_of("\r\n"), start;
+
+        start = m_buf.find_first_of("$!", last == std::string_view::npos ? 0 : last);
+        return start == std::string_view::npos ? std::string_view() : m_buf.substr(start);
+    }
+
+  private:
+    std::string_view m_buf;
+};
+
+/**
+ * \brief           Iterate complete sentences of the buffer, without copying
+ * \param[in]       buf: Buffer with received data
+ * \return          Range of sentences
+ */
+inline SentenceRange
+sentences(std::string_view buf) noexcept {
+    return SentenceRange(buf);
+}
+
+#if __cpp_lib_span || __DOXYGEN__
+/**
+ * \brief           Iterate complete sentences of the buffer, without copying
+ * \param[in]       buf: Buffer with received data
+ * \return          Range of sentences
+ */
+inline SentenceRange
+sentences(std::span<const std::byte> buf) noexcept {
+    return SentenceRange(std::string_view(reinterpret_cast<const char*>(buf.data()), buf.size()));
+}
+#endif /* __cpp_lib_span || __DOXYGEN__ */
+
+#endif /* LWGPS_HPP_CPP17 || __DOXYGEN__ */
+
 }; // namespace Lwgps
 
 #endif /* LWGPS_HDR_HPP */
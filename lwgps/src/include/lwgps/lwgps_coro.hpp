@@ -0,0 +1,255 @@
+/**
+ * \file            lwgps_coro.hpp
+ * \brief           C++20 coroutine stream of fix updates
+ */
+
+/*
+ * Copyright (c) 2023 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwGPS - Lightweight GPS NMEA parser library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v2.2.0
+ */
+#ifndef LWGPS_HDR_CORO_HPP
+#define LWGPS_HDR_CORO_HPP
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <optional>
+#include <span>
+#include <utility>
+#include "lwgps/lwgps_parser.hpp"
+
+namespace Lwgps {
+
+/**
+ * \brief           Asynchronous byte source, such as socket on `epoll` reactor or `io_uring`
+ *
+ *                  `co_await src.read(buf)` fills the buffer and returns number of bytes, `0` at the end of stream.
+ *                  Awaitable resumes the reading coroutine from reactor, when data are available
+ */
+template <typename S>
+concept ByteSource = requires(S& src, std::span<std::byte> buf) {
+    { src.read(buf) };
+};
+
+/**
+ * \brief           Single fix update
+ */
+template <typename Fix>
+struct FixUpdate {
+    lwgps_statement_t stat; /*!< Statement, which updated fix data */
+    const Fix* fix;         /*!< Fix data of parser, valid until next update is requested */
+};
+
+/**
+ * \brief           Asynchronous stream of fix updates, see \ref fixes
+ *
+ *                  Consumer coroutine requests updates with `co_await stream.next()`.
+ *                  Stream reads and parses data only while update is requested,
+ *                  then control is transferred directly between coroutines, with no queue or allocation per update
+ */
+template <typename Fix>
+class FixStream {
+  public:
+    using value_type = FixUpdate<Fix>; /*!< Update type */
+
+    /**
+     * \brief           Coroutine promise of stream
+     */
+    struct promise_type {
+        value_type value{};                  /*!< Last update */
+        std::coroutine_handle<> consumer;    /*!< Coroutine waiting for update */
+        std::exception_ptr error;            /*!< Exception of byte source or parser */
+
+        /**
+         * \brief           Suspend stream and resume consumer
+         */
+        struct Transfer {
+            bool
+            await_ready() const noexcept {
+                return false;
+            }
+
+            std::coroutine_handle<>
+            await_suspend(std::coroutine_handle<promise_type> h) const noexcept {
+                return h.promise().consumer;
+            }
+
+            void
+            await_resume() const noexcept {}
+        };
+
+        FixStream
+        get_return_object() noexcept {
+            return FixStream(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        std::suspend_always
+        initial_suspend() const noexcept {
+            return {};
+        }
+
+        Transfer
+        final_suspend() const noexcept {
+            return {};
+        }
+
+        Transfer
+        yield_value(value_type v) noexcept {
+            value = v;
+            return {};
+        }
+
+        void
+        return_void() noexcept {}
+
+        void
+        unhandled_exception() noexcept {
+            error = std::current_exception();
+        }
+    };
+
+    /**
+     * \brief           Awaitable of next update
+     */
+    class NextAwaiter {
+      public:
+        explicit NextAwaiter(std::coroutine_handle<promise_type> h) noexcept : m_h(h) {}
+
+        bool
+        await_ready() const noexcept {
+            return !m_h || m_h.done();
+        }
+
+        std::coroutine_handle<>
+        await_suspend(std::coroutine_handle<> consumer) noexcept {
+            m_h.promise().consumer = consumer;
+            return m_h;
+        }
+
+        /**
+         * \brief           Get update
+         * \return          Update, or `std::nullopt` at the end of stream
+         */
+        std::optional<value_type>
+        await_resume() const {
+            if (!m_h) {
+                return std::nullopt;
+            }
+            if (m_h.promise().error) {
+                std::rethrow_exception(std::exchange(m_h.promise().error, nullptr));
+            }
+            if (m_h.done()) {
+                return std::nullopt;
+            }
+            return m_h.promise().value;
+        }
+
+      private:
+        std::coroutine_handle<promise_type> m_h;
+    };
+
+    FixStream(const FixStream& other) = delete;
+    FixStream& operator=(const FixStream& other) = delete;
+
+    FixStream(FixStream&& other) noexcept : m_h(std::exchange(other.m_h, nullptr)) {}
+
+    FixStream&
+    operator=(FixStream&& other) noexcept {
+        if (this != &other) {
+            if (m_h) {
+                m_h.destroy();
+            }
+            m_h = std::exchange(other.m_h, nullptr);
+        }
+        return *this;
+    }
+
+    ~FixStream() {
+        if (m_h) {
+            m_h.destroy();
+        }
+    }
+
+    /**
+     * \brief           Request next update
+     * \return          Awaitable, resulting in `std::optional` update
+     */
+    NextAwaiter
+    next() noexcept {
+        return NextAwaiter(m_h);
+    }
+
+  private:
+    explicit FixStream(std::coroutine_handle<promise_type> h) noexcept : m_h(h) {}
+
+    std::coroutine_handle<promise_type> m_h;
+};
+
+/**
+ * \brief           Create asynchronous stream of fix updates from byte source
+ *
+ *                  Every sentence, which updates fix data of the parser, is one update.
+ *                  Read buffer of `N` bytes is part of coroutine frame, parser and source are used by reference
+ *                  and must outlive the stream.
+ *
+ * \code{.cpp}
+ * Task
+ * track(Lwgps::Parser<>& gps, Socket& sock) {
+ *     auto stream = Lwgps::fixes(gps, sock);
+ *     while (auto u = co_await stream.next()) {
+ *         if (u->stat == STAT_GGA) {
+ *             publish(u->fix->latitude, u->fix->longitude);
+ *         }
+ *     }
+ * }
+ * \endcode
+ *
+ * \tparam          N: Size of read buffer in units of bytes
+ * \param[in]       gps: Parser
+ * \param[in]       src: Byte source
+ * \return          Stream of updates
+ */
+template <size_t N = 256, typename Config, typename Callback, ByteSource Source>
+FixStream<typename Parser<Config, Callback>::fix_type>
+fixes(Parser<Config, Callback>& gps, Source& src) {
+    std::byte buff[N];
+    lwgps_statement_t stat;
+    size_t len, pos;
+
+    while ((len = static_cast<size_t>(co_await src.read(std::span<std::byte>(buff)))) > 0) {
+        for (pos = 0; pos < len;) {
+            pos += gps.process_until_commit(buff + pos, len - pos, stat);
+            if (stat != STAT_UNKNOWN) {
+                co_yield FixUpdate<typename Parser<Config, Callback>::fix_type>{stat, &gps.fix()};
+            }
+        }
+    }
+}
+
+}; // namespace Lwgps
+
+#endif /* LWGPS_HDR_CORO_HPP */
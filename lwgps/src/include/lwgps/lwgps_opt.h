@@ -62,6 +62,20 @@ extern "C" {
 #define LWGPS_CFG_DOUBLE 1
 #endif
 
+/**
+ * \brief           Enables `1` or disables `0` compact layout of GPS handle, for large number of handles
+ *
+ *                  Only latitude and longitude use \ref lwgps_float_t, other floating point values
+ *                  use `float`, see \ref lwgps_float_aux_t. Parser scratch state is kept out of line
+ *                  and attached to the handle with \ref lwgps_set_scratch, so array of handles holds fix data only,
+ *                  with time, position, validity and velocity in the first cache line
+ *
+ * \note            Every handle needs its own scratch state, attached after \ref lwgps_init
+ */
+#ifndef LWGPS_CFG_COMPACT
+#define LWGPS_CFG_COMPACT 0
+#endif
+
 /**
  * \brief           Enables `1` or disables `0` status reporting callback
  *                  by \ref lwgps_process
@@ -158,6 +172,177 @@ extern "C" {
 #define LWGPS_CFG_STATEMENT_PUBX_TIME 0
 #endif
 
+/**
+ * \brief           Enables `1` or disables `0` decoding of UBX (uBlox) binary frames
+ *
+ * \note            Supported messages are `NAV-PVT`, `NAV-SAT` and `NAV-TIMEUTC`,
+ *                  decoded to the same fields as NMEA statements. See \ref lwgps_process_ubx
+ *
+ *                  This is a nonstandard ublox-specific extension,
+ *                  so disabled by default.
+ */
+#ifndef LWGPS_CFG_UBX
+#define LWGPS_CFG_UBX 0
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` parsing of AIS `!xxVDM` and `!xxVDO` sentences
+ *
+ * \note            Multi-fragment messages are reassembled in fixed-size table.
+ *                  Position reports of type `1`, `2`, `3` and `18` are decoded
+ */
+#ifndef LWGPS_CFG_AIS
+#define LWGPS_CFG_AIS 0
+#endif
+
+/**
+ * \brief           Number of AIS messages that can be reassembled at the same time
+ *
+ * \note            One more reassembly buffer is used for first fragment, until its checksum is verified
+ */
+#ifndef LWGPS_CFG_AIS_SLOTS
+#define LWGPS_CFG_AIS_SLOTS 4
+#endif
+
+/**
+ * \brief           Maximum length of reassembled AIS message, in units of bytes
+ *
+ * \note            Default value fits the longest AIS message of `1008` bits
+ */
+#ifndef LWGPS_CFG_AIS_BUFF_SIZE
+#define LWGPS_CFG_AIS_BUFF_SIZE 126
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` parsing of NMEA 4.x TAG blocks
+ *
+ * \note            TAG block is validated with its own checksum and assigned
+ *                  to the sentence that immediately follows it
+ */
+#ifndef LWGPS_CFG_TAG
+#define LWGPS_CFG_TAG 0
+#endif
+
+/**
+ * \brief           Size of TAG block source identification buffer, including `NULL` termination
+ */
+#ifndef LWGPS_CFG_TAG_SRC_LEN
+#define LWGPS_CFG_TAG_SRC_LEN 16
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` application registered custom statements
+ *
+ * \note            Proprietary sentences can be parsed without modifying the library.
+ *                  See \ref lwgps_custom_register
+ */
+#ifndef LWGPS_CFG_CUSTOM
+#define LWGPS_CFG_CUSTOM 0
+#endif
+
+/**
+ * \brief           Maximum number of custom statements registered to single GPS handle
+ */
+#ifndef LWGPS_CFG_CUSTOM_MAX
+#define LWGPS_CFG_CUSTOM_MAX 4
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` per-field update and presence masks
+ *
+ *                  Every commit sets bits of written fields in \ref lwgps_t.fields_updated,
+ *                  which are cleared by \ref lwgps_fields_ack. \ref lwgps_t.fields_present
+ *                  tells whether field was received with a value or was empty in the sentence
+ *
+ * \note            This is an extension, so not enabled by default.
+ */
+#ifndef LWGPS_CFG_FIELD_MASK
+#define LWGPS_CFG_FIELD_MASK 0
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` per-handle runtime feature mask
+ *
+ *                  Statements, `GSV` satellite details and CRC check, enabled at compile time,
+ *                  can be disabled for each GPS handle separately with \ref lwgps_set_features.
+ *                  Mask is checked once per sentence, when statement is detected
+ *
+ * \note            This is an extension, so not enabled by default.
+ */
+#ifndef LWGPS_CFG_RUNTIME_MASK
+#define LWGPS_CFG_RUNTIME_MASK 0
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` protocol demultiplexer
+ *                  for mixed NMEA, UBX and RTCM3 input on single stream
+ *
+ * \note            Frames are recognized by their sync pattern and length,
+ *                  validated and passed to NMEA parser, UBX decoder or user callback.
+ *                  See \ref lwgps_demux_process
+ */
+#ifndef LWGPS_CFG_DEMUX
+#define LWGPS_CFG_DEMUX 0
+#endif
+
+/**
+ * \brief           Size of demultiplexer buffer for binary frames, in units of bytes
+ *
+ * \note            Buffer is used only for frames split across multiple input chunks.
+ *                  Split frames longer than buffer are dropped, frames fully contained in input data are not limited.
+ *                  Default value fits the longest RTCM3 frame
+ */
+#ifndef LWGPS_CFG_DEMUX_BUFF_SIZE
+#define LWGPS_CFG_DEMUX_BUFF_SIZE 1029
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` sentence latency tracing
+ *
+ *                  Each sentence is timestamped when its start character arrives,
+ *                  when end of line is received and when it is committed to user memory.
+ *                  Timings are accumulated to log2 histograms in \ref lwgps_t.lat
+ *
+ * \note            This is an extension, so not enabled by default.
+ *                  It requires \ref LWGPS_CFG_LATENCY_GET_TICK to be defined
+ */
+#ifndef LWGPS_CFG_LATENCY
+#define LWGPS_CFG_LATENCY 0
+#endif
+
+/**
+ * \brief           Get current time as 32-bit free-running tick counter
+ *
+ *                  Set it to system tick or hardware cycle counter, such as `DWT->CYCCNT`.
+ *                  Tick unit defines the unit of all latency values
+ */
+#if defined(__DOXYGEN__)
+#define LWGPS_CFG_LATENCY_GET_TICK() 0
+#endif
+
+/**
+ * \brief           Number of bins in each latency histogram
+ *
+ *                  Bin `0` counts zero durations, bin `n` counts durations
+ *                  from `2^(n-1)` to `2^n - 1` ticks and last bin counts everything above
+ */
+#ifndef LWGPS_CFG_LATENCY_BINS
+#define LWGPS_CFG_LATENCY_BINS 16
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` checkpoint of fix state
+ *
+ *                  \ref lwgps_checkpoint_save writes fix and accumulated state of GPS handle
+ *                  to compact, versioned binary format, which is restored by \ref lwgps_checkpoint_load
+ *                  after restart, without waiting for receiver to send full epoch again
+ *
+ * \note            This is an extension, so not enabled by default.
+ */
+#ifndef LWGPS_CFG_CHECKPOINT
+#define LWGPS_CFG_CHECKPOINT 0
+#endif
+
 /**
  * \brief           Enables `1` or disables `0` CRC calculation and check
  *
@@ -176,6 +361,93 @@ extern "C" {
 #define LWESP_CFG_DISTANCE_BEARING 1
 #endif
 
+/**
+ * \brief           Enables `1` or disables `0` per-handle odometer and trip accumulator
+ *
+ *                  Odometer is updated on every committed `GGA` statement with valid fix,
+ *                  while maximum speed is tracked from valid `RMC` statements.
+ *
+ * \note            This is an extension, so not enabled by default.
+ *                  It requires \ref LWGPS_CFG_STATEMENT_GPGGA and \ref LWESP_CFG_DISTANCE_BEARING
+ */
+#ifndef LWGPS_CFG_ODOMETER
+#define LWGPS_CFG_ODOMETER 0
+#endif
+
+/**
+ * \brief           Minimum distance in units of meters from last accepted position,
+ *                  before new position is accepted by the odometer
+ *
+ *                  Smaller movements are considered as position jitter of stationary receiver
+ *                  and are not added to the travelled distance.
+ */
+#ifndef LWGPS_CFG_ODOMETER_STATIONARY_DIST
+#define LWGPS_CFG_ODOMETER_STATIONARY_DIST 5
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` per-handle report filter
+ *                  for status reporting callback
+ *
+ *                  When enabled, `GGA` and `RMC` statements are reported to the callback
+ *                  only when position, course or speed changed enough, or when configured time elapsed.
+ *                  See \ref lwgps_set_report_filter
+ *
+ * \note            This is an extension, so not enabled by default.
+ *                  It requires \ref LWGPS_CFG_STATUS
+ */
+#ifndef LWGPS_CFG_REPORT_FILTER
+#define LWGPS_CFG_REPORT_FILTER 0
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` streaming track simplification
+ *
+ *                  Simplifier takes committed fixes and outputs only points
+ *                  needed to keep the track within configured distance tolerance.
+ *                  See \ref lwgps_simplify_init
+ *
+ * \note            This is an extension, so not enabled by default.
+ */
+#ifndef LWGPS_CFG_SIMPLIFY
+#define LWGPS_CFG_SIMPLIFY 0
+#endif
+
+/**
+ * \brief           Maximum number of pending points in the simplifier window
+ *
+ *                  When window is full, point is output even if track is still within tolerance.
+ *                  Larger window allows better simplification of straight tracks, at the cost of memory
+ *                  and processing time, which is linear with window size.
+ */
+#ifndef LWGPS_CFG_SIMPLIFY_WINDOW
+#define LWGPS_CFG_SIMPLIFY_WINDOW 16
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` per-handle history of recent fixes
+ *
+ *                  Every committed `GGA` statement with valid fix is stored to the ring buffer,
+ *                  together with latest speed and course. See \ref lwgps_history_get
+ *                  and \ref lwgps_history_kinematics
+ *
+ * \note            This is an extension, so not enabled by default.
+ *                  It requires \ref LWGPS_CFG_STATEMENT_GPGGA
+ */
+#ifndef LWGPS_CFG_HISTORY
+#define LWGPS_CFG_HISTORY 0
+#endif
+
+/**
+ * \brief           Number of fixes kept in the history ring buffer
+ *
+ * \note            Must not exceed `1489` when \ref LWGPS_CFG_CHECKPOINT is enabled,
+ *                  for history to fit single checkpoint section
+ */
+#ifndef LWGPS_CFG_HISTORY_LEN
+#define LWGPS_CFG_HISTORY_LEN 8
+#endif
+
 /**
  * \brief           Memory set function
  * 
@@ -194,11 +466,61 @@ extern "C" {
 #define LWGPS_MEMCPY(dst, src, len) memcpy((dst), (src), (len))
 #endif
 
+/**
+ * \brief           Memory move function, for overlapping regions
+ * 
+ * \note            Function footprint is the same as \ref memmove
+ */
+#ifndef LWGPS_MEMMOVE
+#define LWGPS_MEMMOVE(dst, src, len) memmove((dst), (src), (len))
+#endif
+
+/**
+ * \brief           Atomic bitwise OR on 32-bit variable, used to set field update bits
+ *
+ * \note            Default implementation uses compiler builtins when available.
+ *                  Override it on targets without atomic instructions,
+ *                  if parser and consumer run in different contexts
+ */
+#ifndef LWGPS_ATOMIC_OR_U32
+#if defined(__GNUC__)
+#define LWGPS_ATOMIC_OR_U32(ptr, val) ((void)__atomic_fetch_or((ptr), (val), __ATOMIC_RELEASE))
+#else
+#define LWGPS_ATOMIC_OR_U32(ptr, val) ((void)(*(ptr) |= (val)))
+#endif
+#endif
+
+/**
+ * \brief           Atomic exchange of 32-bit variable, used to read and clear field update bits
+ *
+ * \note            Macro must evaluate to previous value of the variable.
+ *                  When not available, read and clear are done as separate operations
+ */
+#if !defined(LWGPS_ATOMIC_XCHG_U32) && defined(__GNUC__)
+#define LWGPS_ATOMIC_XCHG_U32(ptr, val) __atomic_exchange_n((ptr), (val), __ATOMIC_ACQ_REL)
+#endif
+
 /* Guard against accidental parser breakage */
 #if LWGPS_CFG_STATEMENT_PUBX_TIME && !LWGPS_CFG_STATEMENT_PUBX
 #error LWGPS_CFG_STATEMENT_PUBX must be enabled when enabling LWGPS_CFG_STATEMENT_PUBX_TIME
 #endif /* LWGPS_CFG_STATEMENT_PUBX_TIME && !LWGPS_CFG_STATEMENT_PUBX */
 
+#if LWGPS_CFG_ODOMETER && (!LWGPS_CFG_STATEMENT_GPGGA || !LWESP_CFG_DISTANCE_BEARING)
+#error LWGPS_CFG_STATEMENT_GPGGA and LWESP_CFG_DISTANCE_BEARING must be enabled when enabling LWGPS_CFG_ODOMETER
+#endif /* LWGPS_CFG_ODOMETER && (!LWGPS_CFG_STATEMENT_GPGGA || !LWESP_CFG_DISTANCE_BEARING) */
+
+#if LWGPS_CFG_REPORT_FILTER && !LWGPS_CFG_STATUS
+#error LWGPS_CFG_STATUS must be enabled when enabling LWGPS_CFG_REPORT_FILTER
+#endif /* LWGPS_CFG_REPORT_FILTER && !LWGPS_CFG_STATUS */
+
+#if LWGPS_CFG_HISTORY && !LWGPS_CFG_STATEMENT_GPGGA
+#error LWGPS_CFG_STATEMENT_GPGGA must be enabled when enabling LWGPS_CFG_HISTORY
+#endif /* LWGPS_CFG_HISTORY && !LWGPS_CFG_STATEMENT_GPGGA */
+
+#if LWGPS_CFG_LATENCY && !defined(LWGPS_CFG_LATENCY_GET_TICK)
+#error LWGPS_CFG_LATENCY_GET_TICK must be defined when enabling LWGPS_CFG_LATENCY
+#endif /* LWGPS_CFG_LATENCY && !defined(LWGPS_CFG_LATENCY_GET_TICK) */
+
 /**
  * \}
  */
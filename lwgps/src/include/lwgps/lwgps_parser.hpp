@@ -0,0 +1,718 @@
+/**
+ * \file            lwgps_parser.hpp
+ * \brief           Header-only C++ parser, configured at compile time
+ */
+
+/*
+ * Copyright (c) 2023 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of LwGPS - Lightweight GPS NMEA parser library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v2.2.0
+ */
+#ifndef LWGPS_HDR_PARSER_HPP
+#define LWGPS_HDR_PARSER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include "lwgps/lwgps.h"
+
+namespace Lwgps {
+
+/**
+ * \brief           Default parser configuration, with the same statements as default C library configuration
+ *
+ *                  Application configuration inherits it and overrides selected members only.
+ *                  Parsers with different configurations are independent types and can coexist in one program
+ */
+struct DefaultConfig {
+    using float_type = double;                 /*!< Floating point type of fix fields */
+    static constexpr bool gga = true;          /*!< Parse `GGA` statement */
+    static constexpr bool gsa = true;          /*!< Parse `GSA` statement */
+    static constexpr bool gsv = true;          /*!< Parse `GSV` statement */
+    static constexpr bool gsv_sat_det = false; /*!< Parse satellite details of `GSV` statement */
+    static constexpr bool rmc = true;          /*!< Parse `RMC` statement */
+    static constexpr bool pubx_time = false;   /*!< Parse `PUBX,04` time statement (uBlox specific) */
+    static constexpr bool crc = true;          /*!< Check sentence checksum and drop sentences with wrong one */
+};
+
+/**
+ * \brief           Callback of parser without application notification, removed at compile time
+ */
+struct NoCallback {
+    void
+    operator()(lwgps_statement_t) const noexcept {}
+};
+
+namespace detail {
+
+/**
+ * \brief           Placeholder of disabled field group, each group has its own type to keep bases empty
+ */
+template <int N>
+struct Empty {};
+
+/**
+ * \brief           Field group, when enabled, or empty placeholder
+ */
+template <bool Enable, typename T, int N>
+using Group = std::conditional_t<Enable, T, Empty<N>>;
+
+/**
+ * \brief           Time fields, shared by `GGA` and `PUBX,04` statements
+ */
+struct TimeFields {
+    uint8_t hours;   /*!< Hours in UTC */
+    uint8_t minutes; /*!< Minutes in UTC */
+    uint8_t seconds; /*!< Seconds in UTC */
+};
+
+/**
+ * \brief           Date fields, shared by `RMC` and `PUBX,04` statements
+ */
+struct DateFields {
+    uint8_t date;  /*!< Fix date */
+    uint8_t month; /*!< Fix month */
+    uint8_t year;  /*!< Fix year */
+};
+
+/**
+ * \brief           Fields of `GGA` statement
+ */
+template <typename F>
+struct GgaFields {
+    F latitude;          /*!< Latitude in units of degrees */
+    F longitude;         /*!< Longitude in units of degrees */
+    F altitude;          /*!< Altitude in units of meters */
+    F geo_sep;           /*!< Geoid separation in units of meters */
+    F dgps_age;          /*!< Age of differential GPS correction data in units of seconds */
+    uint8_t sats_in_use; /*!< Number of satellites in use */
+    uint8_t fix;         /*!< Fix status. `0` = invalid, `1` = GPS fix, `2` = DGPS fix, `3` = PPS fix */
+};
+
+/**
+ * \brief           Fields of `GSA` statement
+ */
+template <typename F>
+struct GsaFields {
+    F dop_h;                    /*!< Dolution of precision, horizontal */
+    F dop_v;                    /*!< Dolution of precision, vertical */
+    F dop_p;                    /*!< Dolution of precision, position */
+    uint8_t fix_mode;           /*!< Fix mode. `1` = NO fix, `2` = 2D fix, `3` = 3D fix */
+    uint8_t satellites_ids[12]; /*!< List of satellite IDs in use. Valid range is `0` to `sats_in_use` */
+};
+
+/**
+ * \brief           Fields of `GSV` statement
+ */
+struct GsvFields {
+    uint8_t sats_in_view; /*!< Number of satellites in view */
+};
+
+/**
+ * \brief           Satellite details of `GSV` statement
+ */
+struct GsvSatFields {
+    lwgps_sat_t sats_in_view_desc[12]; /*!< Descriptors of satellites in view */
+};
+
+/**
+ * \brief           Fields of `RMC` statement
+ */
+template <typename F>
+struct RmcFields {
+    uint8_t is_valid; /*!< GPS valid status */
+    F speed;          /*!< Ground speed in knots */
+    F course;         /*!< Ground coarse */
+    F variation;      /*!< Magnetic variation */
+};
+
+/**
+ * \brief           Fields of `PUBX,04` statement
+ */
+template <typename F>
+struct PubxTimeFields {
+    F utc_tow;         /*!< UTC TimeOfWeek, eg 113851.00 */
+    uint16_t utc_wk;   /*!< UTC week number, continues beyond 1023 */
+    uint8_t leap_sec;  /*!< UTC leap seconds; UTC + leap_sec = TAI */
+    uint32_t clk_bias; /*!< Receiver clock bias, eg 1930035 */
+    F clk_drift;       /*!< Receiver clock drift, eg -2660.664 */
+    uint32_t tp_gran;  /*!< Time pulse granularity, eg 43 */
+};
+
+} // namespace detail
+
+/**
+ * \brief           Fix data of parser with configuration `Config`
+ *
+ *                  Only fields of enabled statements exist, access to disabled one fails at compile time
+ */
+template <typename Config>
+struct Fix : detail::Group<Config::gga, detail::GgaFields<typename Config::float_type>, 0>,
+             detail::Group<Config::gga || Config::pubx_time, detail::TimeFields, 1>,
+             detail::Group<Config::gsa, detail::GsaFields<typename Config::float_type>, 2>,
+             detail::Group<Config::gsv, detail::GsvFields, 3>,
+             detail::Group<Config::gsv && Config::gsv_sat_det, detail::GsvSatFields, 4>,
+             detail::Group<Config::rmc, detail::RmcFields<typename Config::float_type>, 5>,
+             detail::Group<Config::rmc || Config::pubx_time, detail::DateFields, 6>,
+             detail::Group<Config::pubx_time, detail::PubxTimeFields<typename Config::float_type>, 7> {};
+
+/**
+ * \brief           NMEA parser, specialized at compile time
+ *
+ *                  Statements, floating point type and checksum check are selected by `Config`,
+ *                  see \ref DefaultConfig. Parsing of disabled statements is removed by the compiler,
+ *                  sentences of statements, which are not enabled, are skipped up to next `$` character.
+ *
+ *                  `Callback` is called for every sentence with valid checksum, same as event function
+ *                  of \ref lwgps_process. Sentences, which commit no fields, are reported too:
+ *                  \ref STAT_UNKNOWN for unknown or not enabled statements and \ref STAT_UBX for `PUBX` messages
+ *                  other than `04`. Sentences with wrong checksum are reported with \ref STAT_CHECKSUM_FAIL.
+ *                  It is stored by value and called directly, so it can be inlined.
+ *
+ * \tparam          Config: Parser configuration
+ * \tparam          Callback: Function object, callable with \ref lwgps_statement_t
+ */
+template <typename Config = DefaultConfig, typename Callback = NoCallback>
+class Parser {
+  public:
+    using config_type = Config;                      /*!< Parser configuration */
+    using float_type = typename Config::float_type;  /*!< Floating point type of fix fields */
+    using fix_type = Fix<Config>;                    /*!< Fix data type */
+
+    Parser() = default;
+
+    /**
+     * \brief           Construct parser with callback
+     * \param[in]       cb: Callback function object
+     */
+    explicit Parser(Callback cb) : m_cb(std::move(cb)) {}
+
+    /**
+     * \brief           Process NMEA data from GPS receiver
+     * \param[in]       data: Received data
+     * \param[in]       len: Number of bytes to process
+     * \return          `1` on success, `0` otherwise
+     */
+    uint8_t
+    process(const void* data, size_t len) {
+        run<false>(static_cast<const uint8_t*>(data), len, nullptr);
+        return 1;
+    }
+
+    /**
+     * \brief           Process NMEA data up to the end of first sentence, which updates fix data
+     *
+     *                  Pull based consumers, such as coroutine fix stream,
+     *                  use it to handle every update before further data are parsed
+     *
+     * \param[in]       data: Received data
+     * \param[in]       len: Number of bytes to process
+     * \param[out]      stat: Statement of committed sentence, \ref STAT_UNKNOWN when all data are processed
+     *                      without update
+     * \return          Number of processed bytes
+     */
+    size_t
+    process_until_commit(const void* data, size_t len, lwgps_statement_t& stat) {
+        stat = STAT_UNKNOWN;
+        return run<true>(static_cast<const uint8_t*>(data), len, &stat);
+    }
+
+    /**
+     * \brief           Get fix data, updated by every committed sentence
+     * \return          Fix data
+     */
+    const fix_type&
+    fix() const noexcept {
+        return m_fix;
+    }
+
+    /**
+     * \brief           Get callback function object
+     * \return          Callback
+     */
+    Callback&
+    callback() noexcept {
+        return m_cb;
+    }
+
+  private:
+    static constexpr bool has_callback = !std::is_same_v<Callback, NoCallback>;
+
+    /**
+     * \brief           Private parser state, reset at the beginning of every sentence
+     */
+    struct State {
+        lwgps_statement_t stat; /*!< Statement index */
+        char term_str[13];      /*!< Current term in string format */
+        uint8_t term_pos;       /*!< Current index position in term */
+        uint8_t term_num;       /*!< Current term number */
+        uint8_t star;           /*!< Star detected flag */
+        uint8_t crc_calc;       /*!< Calculated CRC string */
+        uint8_t gsv_num;        /*!< Current `GSV` statement number */
+        uint8_t skip;           /*!< Sentence is skipped up to next `$` character */
+    };
+
+    fix_type m_fix{};   /*!< Public fix data */
+    fix_type m_stage{}; /*!< Fields of current sentence, copied to public data when checksum is valid */
+    State m_p{};        /*!< Parser state */
+    Callback m_cb{};    /*!< Application callback */
+
+    /**
+     * \brief           Process received data
+     * \tparam          Stop: Set to `true` to stop after first sentence, which updates fix data
+     * \param[in]       d: Received data
+     * \param[in]       len: Number of bytes to process
+     * \param[out]      stat: Statement of committed sentence when `Stop` is `true`
+     * \return          Number of processed bytes
+     */
+    template <bool Stop>
+    size_t
+    run(const uint8_t* d, size_t len, lwgps_statement_t* stat) {
+        const uint8_t* start = d;
+
+        for (; len > 0; ++d, --len) {
+            if (*d == '$') { /* Beginning of NMEA line */
+                m_p = {};
+                term_add(*d);
+            } else if (m_p.skip) { /* Statement is not enabled */
+                continue;
+            } else if (*d == ',') {
+                parse_term();
+                crc_add(*d);
+                term_next();
+            } else if (*d == '*') {
+                parse_term();
+                m_p.star = 1;
+                term_next();
+            } else if (*d == '\r') {
+                if (check_crc()) {
+                    bool updated = commit();
+
+                    if constexpr (has_callback) {
+                        m_cb(m_p.stat);
+                    }
+                    if constexpr (Stop) {
+                        if (updated) {
+                            *stat = m_p.stat;
+                            return (size_t)(d - start) + 1;
+                        }
+                    }
+                } else if constexpr (has_callback) {
+                    m_cb(STAT_CHECKSUM_FAIL);
+                }
+            } else {
+                if (!m_p.star) {
+                    crc_add(*d);
+                }
+                term_add(*d);
+            }
+        }
+        (void)stat;
+        return (size_t)(d - start);
+    }
+
+    static constexpr bool
+    is_digit(char c) {
+        return c >= '0' && c <= '9';
+    }
+
+    static constexpr uint8_t
+    hex_value(char c) {
+        return (uint8_t)(is_digit(c) ? c - '0'
+                                     : (c >= 'a' && c <= 'f') ? c - 'a' + 10
+                                     : (c >= 'A' && c <= 'F') ? c - 'A' + 10
+                                                              : 0);
+    }
+
+    /**
+     * \brief           Parse current term as integer
+     * \return          Parsed integer
+     */
+    int32_t
+    parse_number() const {
+        const char* t = m_p.term_str;
+        int32_t res = 0;
+        uint8_t minus;
+
+        for (; *t == ' '; ++t) {}
+        minus = (*t == '-' ? (++t, 1) : 0);
+        for (; is_digit(*t); ++t) {
+            res = 10L * res + (*t - '0');
+        }
+        return minus ? -res : res;
+    }
+
+    /**
+     * \brief           Parse current term as floating point number
+     * \return          Parsed number
+     */
+    float_type
+    parse_float() const {
+        const char* t = m_p.term_str;
+        float_type value = 0, power = 1;
+        int sign = 1;
+
+        for (; *t == ' '; ++t) {}
+        if (*t == '-') {
+            sign = -1;
+            ++t;
+        }
+        for (; is_digit(*t); ++t) {
+            value = value * 10 + (*t - '0');
+        }
+        if (*t == '.') {
+            ++t;
+        }
+        for (; is_digit(*t); ++t) {
+            value = value * 10 + (*t - '0');
+            power *= 10;
+        }
+        return sign * value / power;
+    }
+
+    /**
+     * \brief           Parse current term as latitude or longitude in `dddmm.mmmm` format
+     * \return          Value in units of degrees
+     */
+    float_type
+    parse_lat_long() const {
+        float_type llong = parse_float(), deg, min;
+
+        deg = (float_type)((int)llong / 100);
+        min = llong - deg * 100;
+        return deg + min / 60;
+    }
+
+    /**
+     * \brief           Parse current term as three 2-digit numbers, such as `hhmmss` or `ddmmyy`
+     * \param[out]      a: First number
+     * \param[out]      b: Second number
+     * \param[out]      c: Third number
+     */
+    void
+    parse_triplet(uint8_t& a, uint8_t& b, uint8_t& c) const {
+        const char* t = m_p.term_str;
+
+        a = (uint8_t)(10U * (t[0] - '0') + (t[1] - '0'));
+        b = (uint8_t)(10U * (t[2] - '0') + (t[3] - '0'));
+        c = (uint8_t)(10U * (t[4] - '0') + (t[5] - '0'));
+    }
+
+    /**
+     * \brief           Negate previously parsed value, when current term is `c` hemisphere or direction
+     * \param[in,out]   v: Value to negate
+     * \param[in]       c: Upper case hemisphere or direction character, such as `S` or `W`
+     */
+    void
+    negate_on(float_type& v, char c) const {
+        if (m_p.term_str[0] == c || m_p.term_str[0] == c - 'A' + 'a') {
+            v = -v;
+        }
+    }
+
+    /**
+     * \brief           Check if current term is talker and sentence formatter of built-in statement
+     * \param[in]       s: Sentence formatter, `3` characters
+     * \return          `true` for `$GP` or `$GN` talker and matching formatter
+     */
+    bool
+    is_statement(const char* s) const {
+        const char* t = m_p.term_str;
+
+        return t[1] == 'G' && (t[2] == 'P' || t[2] == 'N') && t[3] == s[0] && t[4] == s[1] && t[5] == s[2];
+    }
+
+    /**
+     * \brief           Reset staging field group of the statement, missing terms are committed as `0`
+     */
+    template <typename T>
+    void
+    stage_reset() {
+        static_cast<T&>(m_stage) = T{};
+    }
+
+    /**
+     * \brief           Copy staging field group to public fix data
+     */
+    template <typename T>
+    void
+    commit_group() {
+        static_cast<T&>(m_fix) = static_cast<const T&>(m_stage);
+    }
+
+    void
+    term_add(uint8_t ch) {
+        if (m_p.term_pos < sizeof(m_p.term_str) - 1) {
+            m_p.term_str[m_p.term_pos] = (char)ch;
+            m_p.term_str[++m_p.term_pos] = 0;
+        }
+    }
+
+    void
+    term_next() {
+        m_p.term_str[(m_p.term_pos = 0)] = 0;
+        ++m_p.term_num;
+    }
+
+    void
+    crc_add(uint8_t ch) {
+        if constexpr (Config::crc) {
+            m_p.crc_calc ^= ch;
+        } else {
+            (void)ch;
+        }
+    }
+
+    bool
+    check_crc() const {
+        if constexpr (Config::crc) {
+            return m_p.crc_calc == (uint8_t)((hex_value(m_p.term_str[0]) << 4) | hex_value(m_p.term_str[1]));
+        } else {
+            return true;
+        }
+    }
+
+    /**
+     * \brief           Detect statement from first term and reset its staging fields
+     */
+    void
+    parse_statement() {
+        m_p.stat = STAT_UNKNOWN;
+        if constexpr (Config::gga) {
+            if (is_statement("GGA")) {
+                m_p.stat = STAT_GGA;
+                stage_reset<detail::GgaFields<float_type>>();
+                stage_reset<detail::TimeFields>();
+            }
+        }
+        if constexpr (Config::gsa) {
+            if (is_statement("GSA")) {
+                m_p.stat = STAT_GSA;
+                stage_reset<detail::GsaFields<float_type>>();
+            }
+        }
+        if constexpr (Config::gsv) {
+            if (is_statement("GSV")) {
+                m_p.stat = STAT_GSV;
+                stage_reset<detail::GsvFields>();
+            }
+        }
+        if constexpr (Config::rmc) {
+            if (is_statement("RMC")) {
+                m_p.stat = STAT_RMC;
+                stage_reset<detail::RmcFields<float_type>>();
+                stage_reset<detail::DateFields>();
+            }
+        }
+        if constexpr (Config::pubx_time) {
+            if (m_p.term_str[1] == 'P' && m_p.term_str[2] == 'U' && m_p.term_str[3] == 'B' && m_p.term_str[4] == 'X') {
+                m_p.stat = STAT_UBX;
+            }
+        }
+        m_p.skip = m_p.stat == STAT_UNKNOWN && !has_callback; /* Unknown sentences are reported to callback */
+    }
+
+    /**
+     * \brief           Parse received term of enabled statement
+     */
+    void
+    parse_term() {
+        auto& s = m_stage;
+
+        if (m_p.term_num == 0) {
+            parse_statement();
+            return;
+        }
+        if constexpr (Config::gsv && Config::gsv_sat_det) {
+            if (m_p.stat == STAT_GSV && m_p.term_num >= 4 && m_p.term_num <= 19) {
+                uint8_t term_num = m_p.term_num - 4, index = ((m_p.gsv_num - 1) << 0x02) + (term_num >> 2);
+                uint16_t value;
+
+                if (index < sizeof(m_fix.sats_in_view_desc) / sizeof(m_fix.sats_in_view_desc[0])) {
+                    value = (uint16_t)parse_number();
+                    switch (term_num & 0x03) {
+                        case 0: m_fix.sats_in_view_desc[index].num = (uint8_t)value; break;
+                        case 1: m_fix.sats_in_view_desc[index].elevation = (uint8_t)value; break;
+                        case 2: m_fix.sats_in_view_desc[index].azimuth = value; break;
+                        default: m_fix.sats_in_view_desc[index].snr = (uint8_t)value; break;
+                    }
+                }
+                return;
+            }
+        }
+        if (m_p.term_str[0] == '\0') {
+            return; /* Empty term, field stays `0` */
+        }
+        if constexpr (Config::gga) {
+            if (m_p.stat == STAT_GGA) {
+                switch (m_p.term_num) {
+                    case 1: parse_triplet(s.hours, s.minutes, s.seconds); break;
+                    case 2: s.latitude = parse_lat_long(); break;
+                    case 3: negate_on(s.latitude, 'S'); break;
+                    case 4: s.longitude = parse_lat_long(); break;
+                    case 5: negate_on(s.longitude, 'W'); break;
+                    case 6: s.fix = (uint8_t)parse_number(); break;
+                    case 7: s.sats_in_use = (uint8_t)parse_number(); break;
+                    case 9: s.altitude = parse_float(); break;
+                    case 11: s.geo_sep = parse_float(); break;
+                    case 13: s.dgps_age = parse_float(); break;
+                    default: break;
+                }
+                return;
+            }
+        }
+        if constexpr (Config::gsa) {
+            if (m_p.stat == STAT_GSA) {
+                if (m_p.term_num == 2) {
+                    s.fix_mode = (uint8_t)parse_number();
+                } else if (m_p.term_num >= 3 && m_p.term_num <= 14) {
+                    s.satellites_ids[m_p.term_num - 3] = (uint8_t)parse_number();
+                } else if (m_p.term_num == 15) {
+                    s.dop_p = parse_float();
+                } else if (m_p.term_num == 16) {
+                    s.dop_h = parse_float();
+                } else if (m_p.term_num == 17) {
+                    s.dop_v = parse_float();
+                }
+                return;
+            }
+        }
+        if constexpr (Config::gsv) {
+            if (m_p.stat == STAT_GSV) {
+                if (m_p.term_num == 2) {
+                    m_p.gsv_num = (uint8_t)parse_number();
+                } else if (m_p.term_num == 3) {
+                    s.sats_in_view = (uint8_t)parse_number();
+                }
+                return;
+            }
+        }
+        if constexpr (Config::rmc) {
+            if (m_p.stat == STAT_RMC) {
+                switch (m_p.term_num) {
+                    case 2: s.is_valid = m_p.term_str[0] == 'A'; break;
+                    case 7: s.speed = parse_float(); break;
+                    case 8: s.course = parse_float(); break;
+                    case 9: parse_triplet(s.date, s.month, s.year); break;
+                    case 10: s.variation = parse_float(); break;
+                    case 11: negate_on(s.variation, 'W'); break;
+                    default: break;
+                }
+                return;
+            }
+        }
+        if constexpr (Config::pubx_time) {
+            if (m_p.stat == STAT_UBX) { /* Disambiguate generic PUBX statement */
+                if (m_p.term_str[0] == '0' && m_p.term_str[1] == '4') {
+                    m_p.stat = STAT_UBX_TIME;
+                    stage_reset<detail::PubxTimeFields<float_type>>();
+                    stage_reset<detail::TimeFields>();
+                    stage_reset<detail::DateFields>();
+                }
+            } else if (m_p.stat == STAT_UBX_TIME) {
+                const char* t = m_p.term_str;
+
+                switch (m_p.term_num) {
+                    case 2: parse_triplet(s.hours, s.minutes, s.seconds); break;
+                    case 3: parse_triplet(s.date, s.month, s.year); break;
+                    case 4: s.utc_tow = parse_float(); break;
+                    case 5: s.utc_wk = (uint16_t)parse_number(); break;
+                    case 6: /* 2- or 3-digit leap second count, trailing `D` means firmware default value */
+                        if (t[2] == 'D' || t[2] == '\0') {
+                            s.leap_sec = (uint8_t)(10U * (t[0] - '0') + (t[1] - '0'));
+                        } else {
+                            s.leap_sec = (uint8_t)(100U * (t[0] - '0') + 10U * (t[1] - '0') + (t[2] - '0'));
+                        }
+                        break;
+                    case 7: s.clk_bias = (uint32_t)parse_number(); break;
+                    case 8: s.clk_drift = parse_float(); break;
+                    case 9: s.tp_gran = (uint32_t)parse_number(); break;
+                    default: break;
+                }
+            }
+        }
+    }
+
+    /**
+     * \brief           Copy fields of current statement to public fix data
+     * \return          `true` when statement has fields, `false` for other sentences
+     */
+    bool
+    commit() {
+        if constexpr (Config::gga) {
+            if (m_p.stat == STAT_GGA) {
+                commit_group<detail::GgaFields<float_type>>();
+                commit_group<detail::TimeFields>();
+                return true;
+            }
+        }
+        if constexpr (Config::gsa) {
+            if (m_p.stat == STAT_GSA) {
+                commit_group<detail::GsaFields<float_type>>();
+                return true;
+            }
+        }
+        if constexpr (Config::gsv) {
+            if (m_p.stat == STAT_GSV) {
+                commit_group<detail::GsvFields>();
+                return true;
+            }
+        }
+        if constexpr (Config::rmc) {
+            if (m_p.stat == STAT_RMC) {
+                commit_group<detail::RmcFields<float_type>>();
+                commit_group<detail::DateFields>();
+                return true;
+            }
+        }
+        if constexpr (Config::pubx_time) {
+            if (m_p.stat == STAT_UBX_TIME) {
+                commit_group<detail::PubxTimeFields<float_type>>();
+                commit_group<detail::TimeFields>();
+                commit_group<detail::DateFields>();
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+/**
+ * \brief           Create parser with callback, deducing callback type
+ * \tparam          Config: Parser configuration
+ * \param[in]       cb: Callback function object
+ * \return          Parser
+ */
+template <typename Config = DefaultConfig, typename Callback>
+Parser<Config, Callback>
+make_parser(Callback cb) {
+    return Parser<Config, Callback>(std::move(cb));
+}
+
+}; // namespace Lwgps
+
+#endif /* LWGPS_HDR_PARSER_HPP */
@@ -34,7 +34,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include "lwgps/lwgps.h"
-#if LWESP_CFG_DISTANCE_BEARING
+#if LWESP_CFG_DISTANCE_BEARING || LWGPS_CFG_REPORT_FILTER || LWGPS_CFG_SIMPLIFY || LWGPS_CFG_HISTORY
 #include <math.h>
 #endif
 
@@ -43,24 +43,94 @@
 #define R2D(x)       FLT(FLT(x) * FLT(57.29577951308232)) /*!< Radians to degrees */
 #define EARTH_RADIUS FLT(6371.0)                          /*!< Earth radius in units of kilometers */
 
+/* Math functions in configured precision */
+#if LWGPS_CFG_DOUBLE
+#define FLT_COS(x)      FLT(cos(x))
+#define FLT_SQRT(x)     FLT(sqrt(x))
+#define FLT_ATAN2(y, x) FLT(atan2((y), (x)))
+#else /* LWGPS_CFG_DOUBLE */
+#define FLT_COS(x)      FLT(cosf(x))
+#define FLT_SQRT(x)     FLT(sqrtf(x))
+#define FLT_ATAN2(y, x) FLT(atan2f((y), (x)))
+#endif /* !LWGPS_CFG_DOUBLE */
+
+/* Time fields are available in user structure */
+#define LWGPS_HAS_TIME (LWGPS_CFG_STATEMENT_GPGGA || LWGPS_CFG_STATEMENT_PUBX_TIME)
+
+/* Statement carries position and fix information */
+#if LWGPS_CFG_STATEMENT_GPGGA
+#define STAT_HAS_POS(stat) ((stat) == STAT_GGA || (stat) == STAT_UBX_NAV_PVT)
+#else
+#define STAT_HAS_POS(stat) (0)
+#endif /* LWGPS_CFG_STATEMENT_GPGGA */
+
+/* Statement carries validity, speed and course information */
+#if LWGPS_CFG_STATEMENT_GPRMC
+#define STAT_HAS_VEL(stat) ((stat) == STAT_RMC || (stat) == STAT_UBX_NAV_PVT)
+#else
+#define STAT_HAS_VEL(stat) (0)
+#endif /* LWGPS_CFG_STATEMENT_GPRMC */
+
+/* AIS sentences start with exclamation mark instead of dollar sign */
+#if LWGPS_CFG_AIS
+#define LWGPS_IS_AIS_START(ch) ((ch) == '!')
+#else
+#define LWGPS_IS_AIS_START(ch) (0)
+#endif /* LWGPS_CFG_AIS */
+
+/* TAG blocks start and end with backslash */
+#if LWGPS_CFG_TAG
+#define LWGPS_IS_TAG_START(ch) ((ch) == '\\')
+#else
+#define LWGPS_IS_TAG_START(ch) (0)
+#endif /* LWGPS_CFG_TAG */
+
+/* Elapsed seconds between two times of day, handles midnight wrap */
+#define TIME_DIFF(now, prev) ((uint32_t)(((now) + 86400UL - (prev)) % 86400UL))
+
 #if LWGPS_CFG_CRC
-#define CRC_ADD(_gh, ch) (_gh)->p.crc_calc ^= (uint8_t)(ch)
+#define CRC_ADD(_gh, ch) (_gh)->p->crc_calc ^= (uint8_t)(ch)
 #else
 #define CRC_ADD(_gh, ch)
 #endif /* LWGPS_CFG_CRC */
 #define TERM_ADD(_gh, ch)                                                                                              \
     do {                                                                                                               \
-        if ((_gh)->p.term_pos < (sizeof((_gh)->p.term_str) - 1)) {                                                     \
-            (_gh)->p.term_str[(_gh)->p.term_pos] = (ch);                                                               \
-            (_gh)->p.term_str[++(_gh)->p.term_pos] = 0;                                                                \
+        if ((_gh)->p->term_pos < (sizeof((_gh)->p->term_str) - 1)) {                                                   \
+            (_gh)->p->term_str[(_gh)->p->term_pos] = (ch);                                                             \
+            (_gh)->p->term_str[++(_gh)->p->term_pos] = 0;                                                              \
         }                                                                                                              \
     } while (0)
+#if LWGPS_CFG_FIELD_MASK
+#define FIELDS_MARK(_gh, _upd, _pres)                                                                                  \
+    do {                                                                                                               \
+        (_gh)->fields_present = ((_gh)->fields_present & ~(uint32_t)(_upd)) | (uint32_t)(_pres);                       \
+        LWGPS_ATOMIC_OR_U32(&(_gh)->fields_updated, (uint32_t)(_upd));                                                 \
+    } while (0)
+#else
+#define FIELDS_MARK(_gh, _upd, _pres)                                                                                  \
+    do {                                                                                                               \
+        (void)(_upd);                                                                                                  \
+        (void)(_pres);                                                                                                 \
+    } while (0)
+#endif /* LWGPS_CFG_FIELD_MASK */
+#define SENTENCE_RESET(_gh)                                                                                            \
+    LWGPS_MEMSET((_gh)->p, 0x00, offsetof(lwgps_scratch_t, data)) /* Control header only */
 #define TERM_NEXT(_gh)                                                                                                 \
     do {                                                                                                               \
-        (_gh)->p.term_str[((_gh)->p.term_pos = 0)] = 0;                                                                \
-        ++(_gh)->p.term_num;                                                                                           \
+        (_gh)->p->term_str[((_gh)->p->term_pos = 0)] = 0;                                                              \
+        ++(_gh)->p->term_num;                                                                                          \
     } while (0)
 
+/* Little-endian field access at fixed offset of UBX payload */
+#define UBX_U1(_p, _o) ((uint8_t)(_p)[(_o)])
+#define UBX_U2(_p, _o) ((uint16_t)((uint16_t)(_p)[(_o)] | ((uint16_t)(_p)[(_o) + 1] << 8)))
+#define UBX_U4(_p, _o)                                                                                                 \
+    ((uint32_t)(_p)[(_o)] | ((uint32_t)(_p)[(_o) + 1] << 8) | ((uint32_t)(_p)[(_o) + 2] << 16)                         \
+     | ((uint32_t)(_p)[(_o) + 3] << 24))
+#define UBX_I1(_p, _o) ((int8_t)UBX_U1(_p, _o))
+#define UBX_I2(_p, _o) ((int16_t)UBX_U2(_p, _o))
+#define UBX_I4(_p, _o) ((int32_t)UBX_U4(_p, _o))
+
 #define CIN(x)  ((x) >= '0' && (x) <= '9')
 #define CIHN(x) (((x) >= '0' && (x) <= '9') || ((x) >= 'a' && (x) <= 'f') || ((x) >= 'A' && (x) <= 'F'))
 #define CTN(x)  ((x) - '0')
@@ -90,7 +160,7 @@ prv_parse_number(lwgps_t* ghandle, const char* text) {
     uint8_t minus = 0;
 
     if (text == NULL) {
-        text = ghandle->p.term_str;
+        text = ghandle->p->term_str;
     }
     for (; text != NULL && *text == ' '; ++text) {} /* Strip leading spaces */
 
@@ -122,7 +192,7 @@ prv_parse_float_number(lwgps_t* ghandle, const char* text) {
     int sign = 1;
 
     if (text == NULL) {
-        text = ghandle->p.term_str;
+        text = ghandle->p->term_str;
     }
     for (; text != NULL && *text == ' '; ++text) {} /* Strip leading spaces */
 
@@ -164,393 +234,1996 @@ prv_parse_lat_long(lwgps_t* ghandle) {
     return llong;
 }
 
+#if LWGPS_CFG_AIS
+
+#define AIS_SLOT_NONE    0xFF                      /*!< Sentence is not stored to any reassembly slot */
+#define AIS_SLOT_CNT     (LWGPS_CFG_AIS_SLOTS + 1) /*!< Reassembly slots, with free one for next first fragment */
+#define AIS_POS_REP_BITS 168                       /*!< Length of position report messages */
+
+/* 6-bit values of armored payload characters from `0` to `w`, `0xFF` for invalid ones */
+static const uint8_t ais_armor_table[] = {
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0x10, 0x11,
+    0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1A, 0x1B, 0x1C, 0x1D, 0x1E, 0x1F, 0x20, 0x21, 0x22, 0x23,
+    0x24, 0x25, 0x26, 0x27, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x28, 0x29, 0x2A, 0x2B, 0x2C, 0x2D,
+    0x2E, 0x2F, 0x30, 0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3A, 0x3B, 0x3C, 0x3D, 0x3E, 0x3F,
+};
+
 /**
- * \brief           Parse received term
+ * \brief           Get unsigned field from AIS message
+ *
+ *                  Whole 64-bit big-endian word is loaded at once,
+ *                  buffer must be padded with `8` bytes after the last message byte
+ *
+ * \param[in]       b: Message bits
+ * \param[in]       start: Index of first bit
+ * \param[in]       len: Field length in units of bits, up to `32`
+ * \return          Field value
+ */
+static uint32_t
+prv_ais_bits(const uint8_t* b, uint16_t start, uint8_t len) {
+    uint64_t w;
+
+    b += start >> 3;
+    w = ((uint64_t)b[0] << 56) | ((uint64_t)b[1] << 48) | ((uint64_t)b[2] << 40) | ((uint64_t)b[3] << 32)
+        | ((uint64_t)b[4] << 24) | ((uint64_t)b[5] << 16) | ((uint64_t)b[6] << 8) | (uint64_t)b[7];
+    return (uint32_t)((w << (start & 0x07)) >> (64 - len));
+}
+
+/**
+ * \brief           Get signed field from AIS message
+ * \param[in]       b: Message bits
+ * \param[in]       start: Index of first bit
+ * \param[in]       len: Field length in units of bits, up to `32`
+ * \return          Sign-extended field value
+ */
+static int32_t
+prv_ais_sbits(const uint8_t* b, uint16_t start, uint8_t len) {
+    uint32_t m = (uint32_t)1 << (len - 1);
+
+    return (int32_t)((prv_ais_bits(b, start, len) ^ m) - m);
+}
+
+/**
+ * \brief           Select reassembly slot for current sentence
+ *
+ *                  First fragment is written to free slot, which is claimed only on commit,
+ *                  so corrupted sentence never changes reassembly table. Following fragments must arrive in order
+ *
  * \param[in]       ghandle: GPS handle
- * \return          `1` on success, `0` otherwise
  */
-static uint8_t
-prv_parse_term(lwgps_t* ghandle) {
-    if (ghandle->p.term_num == 0) { /* Check string type */
-        if (0) {
-#if LWGPS_CFG_STATEMENT_GPGGA
-        } else if (!strncmp(ghandle->p.term_str, "$GPGGA", 6) || !strncmp(ghandle->p.term_str, "$GNGGA", 6)) {
-            ghandle->p.stat = STAT_GGA;
-#endif /* LWGPS_CFG_STATEMENT_GPGGA */
-#if LWGPS_CFG_STATEMENT_GPGSA
-        } else if (!strncmp(ghandle->p.term_str, "$GPGSA", 6) || !strncmp(ghandle->p.term_str, "$GNGSA", 6)) {
-            ghandle->p.stat = STAT_GSA;
-#endif /* LWGPS_CFG_STATEMENT_GPGSA */
-#if LWGPS_CFG_STATEMENT_GPGSV
-        } else if (!strncmp(ghandle->p.term_str, "$GPGSV", 6) || !strncmp(ghandle->p.term_str, "$GNGSV", 6)) {
-            ghandle->p.stat = STAT_GSV;
-#endif /* LWGPS_CFG_STATEMENT_GPGSV */
-#if LWGPS_CFG_STATEMENT_GPRMC
-        } else if (!strncmp(ghandle->p.term_str, "$GPRMC", 6) || !strncmp(ghandle->p.term_str, "$GNRMC", 6)) {
-            ghandle->p.stat = STAT_RMC;
-#endif /* LWGPS_CFG_STATEMENT_GPRMC */
-#if LWGPS_CFG_STATEMENT_PUBX
-        } else if (!strncmp(ghandle->p.term_str, "$PUBX", 5)) {
-            ghandle->p.stat = STAT_UBX;
-#endif /* LWGPS_CFG_STATEMENT_PUBX */
-        } else {
-            ghandle->p.stat = STAT_UNKNOWN; /* Invalid statement for library */
+static void
+prv_ais_select_slot(lwgps_t* ghandle) {
+    uint8_t i, slot = AIS_SLOT_NONE;
+
+    for (i = 0; i < AIS_SLOT_CNT; ++i) {
+        if (ghandle->p->data.ais.frag_num == 1 ? ghandle->ais_slot[i].frag_next == 0
+                                               : (ghandle->ais_slot[i].frag_next == ghandle->p->data.ais.frag_num
+                                                  && ghandle->ais_slot[i].frag_cnt == ghandle->p->data.ais.frag_cnt
+                                                  && ghandle->ais_slot[i].seq == ghandle->p->data.ais.seq
+                                                  && ghandle->ais_slot[i].channel == ghandle->p->data.ais.channel)) {
+            slot = i;
+            break;
         }
-        return 1;
     }
+    ghandle->p->data.ais.slot = slot;
+    ghandle->p->data.ais.bits = slot != AIS_SLOT_NONE && ghandle->p->data.ais.frag_num > 1
+                                    ? ghandle->ais_slot[slot].bits
+                                    : 0;
+}
 
-    /* Start parsing terms */
-    if (ghandle->p.stat == STAT_UNKNOWN) {
-#if LWGPS_CFG_STATEMENT_GPGGA
-    } else if (ghandle->p.stat == STAT_GGA) { /* Process GPGGA statement */
-        switch (ghandle->p.term_num) {
-            case 1: /* Process UTC time */
-                ghandle->p.data.gga.hours = 10 * CTN(ghandle->p.term_str[0]) + CTN(ghandle->p.term_str[1]);
-                ghandle->p.data.gga.minutes = 10 * CTN(ghandle->p.term_str[2]) + CTN(ghandle->p.term_str[3]);
-                ghandle->p.data.gga.seconds = 10 * CTN(ghandle->p.term_str[4]) + CTN(ghandle->p.term_str[5]);
-                break;
-            case 2:                                                         /* Latitude */
-                ghandle->p.data.gga.latitude = prv_parse_lat_long(ghandle); /* Parse latitude */
-                break;
-            case 3: /* Latitude north/south information */
-                if (ghandle->p.term_str[0] == 'S' || ghandle->p.term_str[0] == 's') {
-                    ghandle->p.data.gga.latitude = -ghandle->p.data.gga.latitude;
-                }
-                break;
-            case 4:                                                          /* Longitude */
-                ghandle->p.data.gga.longitude = prv_parse_lat_long(ghandle); /* Parse longitude */
-                break;
-            case 5: /* Longitude east/west information */
-                if (ghandle->p.term_str[0] == 'W' || ghandle->p.term_str[0] == 'w') {
-                    ghandle->p.data.gga.longitude = -ghandle->p.data.gga.longitude;
-                }
-                break;
-            case 6: /* Fix status */ ghandle->p.data.gga.fix = (uint8_t)prv_parse_number(ghandle, NULL); break;
-            case 7: /* Satellites in use */
-                ghandle->p.data.gga.sats_in_use = (uint8_t)prv_parse_number(ghandle, NULL);
-                break;
-            case 9: /* Altitude */ ghandle->p.data.gga.altitude = prv_parse_float_number(ghandle, NULL); break;
-            case 11: /* Altitude above ellipsoid */
-                ghandle->p.data.gga.geo_sep = prv_parse_float_number(ghandle, NULL);
-                break;
-            case 13: /* Age of differential GPS correction data */
-                ghandle->p.data.gga.dgps_age = prv_parse_float_number(ghandle, NULL);
-                break;
-            default: break;
-        }
-#endif /* LWGPS_CFG_STATEMENT_GPGGA */
-#if LWGPS_CFG_STATEMENT_GPGSA
-    } else if (ghandle->p.stat == STAT_GSA) { /* Process GPGSA statement */
-        switch (ghandle->p.term_num) {
-            case 2: ghandle->p.data.gsa.fix_mode = (uint8_t)prv_parse_number(ghandle, NULL); break;
-            case 15: ghandle->p.data.gsa.dop_p = prv_parse_float_number(ghandle, NULL); break;
-            case 16: ghandle->p.data.gsa.dop_h = prv_parse_float_number(ghandle, NULL); break;
-            case 17: ghandle->p.data.gsa.dop_v = prv_parse_float_number(ghandle, NULL); break;
-            default:
-                /* Parse satellite IDs */
-                if (ghandle->p.term_num >= 3 && ghandle->p.term_num <= 14) {
-                    ghandle->p.data.gsa.satellites_ids[ghandle->p.term_num - 3] =
-                        (uint8_t)prv_parse_number(ghandle, NULL);
-                }
-                break;
-        }
-#endif /* LWGPS_CFG_STATEMENT_GPGSA */
-#if LWGPS_CFG_STATEMENT_GPGSV
-    } else if (ghandle->p.stat == STAT_GSV) { /* Process GPGSV statement */
-        switch (ghandle->p.term_num) {
-            case 2: /* Current GPGSV statement number */
-                ghandle->p.data.gsv.stat_num = (uint8_t)prv_parse_number(ghandle, NULL);
-                break;
-            case 3: /* Process satellites in view */
-                ghandle->p.data.gsv.sats_in_view = (uint8_t)prv_parse_number(ghandle, NULL);
-                break;
-            default:
-#if LWGPS_CFG_STATEMENT_GPGSV_SAT_DET
-                if (ghandle->p.term_num >= 4 && ghandle->p.term_num <= 19) { /* Check current term number */
-                    uint8_t index, term_num = ghandle->p.term_num - 4; /* Normalize term number from 4-19 to 0-15 */
-                    uint16_t value;
-
-                    index = ((ghandle->p.data.gsv.stat_num - 1) << 0x02) + (term_num >> 2); /* Get array index */
-                    if (index < sizeof(ghandle->sats_in_view_desc) / sizeof(ghandle->sats_in_view_desc[0])) {
-                        value = (uint16_t)prv_parse_number(ghandle, NULL); /* Parse number as integer */
-                        switch (term_num & 0x03) {
-                            case 0: ghandle->sats_in_view_desc[index].num = value; break;
-                            case 1: ghandle->sats_in_view_desc[index].elevation = value; break;
-                            case 2: ghandle->sats_in_view_desc[index].azimuth = value; break;
-                            case 3: ghandle->sats_in_view_desc[index].snr = value; break;
-                            default: break;
-                        }
-                    }
-                }
-#endif /* LWGPS_CFG_STATEMENT_GPGSV_SAT_DET */
-                break;
-        }
-#endif /* LWGPS_CFG_STATEMENT_GPGSV */
-#if LWGPS_CFG_STATEMENT_GPRMC
-    } else if (ghandle->p.stat == STAT_RMC) { /* Process GPRMC statement */
-        switch (ghandle->p.term_num) {
-            case 2: /* Process valid status */ ghandle->p.data.rmc.is_valid = (ghandle->p.term_str[0] == 'A'); break;
-            case 7: /* Process ground speed in knots */
-                ghandle->p.data.rmc.speed = prv_parse_float_number(ghandle, NULL);
-                break;
-            case 8: /* Process true ground coarse */
-                ghandle->p.data.rmc.course = prv_parse_float_number(ghandle, NULL);
-                break;
-            case 9: /* Process date */
-                ghandle->p.data.rmc.date = (uint8_t)(10U * CTN(ghandle->p.term_str[0]) + CTN(ghandle->p.term_str[1]));
-                ghandle->p.data.rmc.month = (uint8_t)(10U * CTN(ghandle->p.term_str[2]) + CTN(ghandle->p.term_str[3]));
-                ghandle->p.data.rmc.year = (uint8_t)(10U * CTN(ghandle->p.term_str[4]) + CTN(ghandle->p.term_str[5]));
-                break;
-            case 10: /* Process magnetic variation */
-                ghandle->p.data.rmc.variation = prv_parse_float_number(ghandle, NULL);
-                break;
-            case 11: /* Process magnetic variation east/west */
-                if (ghandle->p.term_str[0] == 'W' || ghandle->p.term_str[0] == 'w') {
-                    ghandle->p.data.rmc.variation = -ghandle->p.data.rmc.variation;
-                }
-                break;
-            default: break;
-        }
-#endif /* LWGPS_CFG_STATEMENT_GPRMC */
-#if LWGPS_CFG_STATEMENT_PUBX
-    } else if (ghandle->p.stat == STAT_UBX) { /* Disambiguate generic PUBX statement */
-        if (ghandle->p.term_str[0] == '0' && ghandle->p.term_str[1] == '4') {
-            ghandle->p.stat = STAT_UBX_TIME;
-        }
-#if LWGPS_CFG_STATEMENT_PUBX_TIME
-    } else if (ghandle->p.stat == STAT_UBX_TIME) { /* Process PUBX (uBlox) TIME statement */
-        switch (ghandle->p.term_num) {
-            case 2: /* Process UTC time; ignore fractions of seconds */
-                ghandle->p.data.time.hours = 10U * CTN(ghandle->p.term_str[0]) + CTN(ghandle->p.term_str[1]);
-                ghandle->p.data.time.minutes = 10U * CTN(ghandle->p.term_str[2]) + CTN(ghandle->p.term_str[3]);
-                ghandle->p.data.time.seconds = 10U * CTN(ghandle->p.term_str[4]) + CTN(ghandle->p.term_str[5]);
-                break;
-            case 3: /* Process UTC date */
-                ghandle->p.data.time.date = 10U * CTN(ghandle->p.term_str[0]) + CTN(ghandle->p.term_str[1]);
-                ghandle->p.data.time.month = 10U * CTN(ghandle->p.term_str[2]) + CTN(ghandle->p.term_str[3]);
-                ghandle->p.data.time.year = 10U * CTN(ghandle->p.term_str[4]) + CTN(ghandle->p.term_str[5]);
-                break;
-            case 4: /* Process UTC TimeOfWeek */
-                ghandle->p.data.time.utc_tow = prv_parse_float_number(ghandle, NULL);
-                break;
-            case 5: /* Process UTC WeekNumber */ ghandle->p.data.time.utc_wk = prv_parse_number(ghandle, NULL); break;
-            case 6: /* Process UTC leap seconds */
-                /*
-				 * Accomodate a 2- or 3-digit leap second count
-                 * a trailing 'D' means this is the firmware's default value.
-                 */
-                if (ghandle->p.term_str[2] == 'D' || ghandle->p.term_str[2] == '\0') {
-                    ghandle->p.data.time.leap_sec = 10U * CTN(ghandle->p.term_str[0]) + CTN(ghandle->p.term_str[1]);
-                } else {
-                    ghandle->p.data.time.leap_sec = 100U * CTN(ghandle->p.term_str[0])
-                                                    + 10U * CTN(ghandle->p.term_str[1]) + CTN(ghandle->p.term_str[2]);
-                }
-                break;
-            case 7: /* Process clock bias */ ghandle->p.data.time.clk_bias = prv_parse_number(ghandle, NULL); break;
-            case 8: /* Process clock drift */
-                ghandle->p.data.time.clk_drift = prv_parse_float_number(ghandle, NULL);
-                break;
-            case 9: /* Process time pulse granularity */
-                ghandle->p.data.time.tp_gran = prv_parse_number(ghandle, NULL);
-                break;
-            default: break;
+/**
+ * \brief           Claim slot of valid first fragment
+ *
+ *                  Unfinished message with the same sequential ID and channel is restarted.
+ *                  When table is full, one message is evicted, to keep free slot for next first fragment
+ *
+ * \param[in]       ghandle: GPS handle
+ * \param[in]       slot: Slot with first fragment
+ */
+static void
+prv_ais_claim_slot(lwgps_t* ghandle, uint8_t slot) {
+    uint8_t i, used = 0;
+
+    for (i = 0; i < AIS_SLOT_CNT; ++i) {
+        if (i != slot && ghandle->ais_slot[i].frag_next > 0) {
+            if (ghandle->ais_slot[i].seq == ghandle->p->data.ais.seq
+                && ghandle->ais_slot[i].channel == ghandle->p->data.ais.channel) {
+                ghandle->ais_slot[i].frag_next = 0;
+            } else {
+                ++used;
+            }
         }
-#endif /* LWGPS_CFG_STATEMENT_PUBX_TIME */
-#endif /* LWGPS_CFG_STATEMENT_PUBX */
     }
-    return 1;
+    if (used >= LWGPS_CFG_AIS_SLOTS) {
+        do {
+            i = ghandle->ais_victim;
+            ghandle->ais_victim = (uint8_t)((i + 1) % AIS_SLOT_CNT);
+        } while (i == slot || ghandle->ais_slot[i].frag_next == 0);
+        ghandle->ais_slot[i].frag_next = 0;
+    }
+    ghandle->ais_slot[slot].frag_cnt = ghandle->p->data.ais.frag_cnt;
+    ghandle->ais_slot[slot].frag_next = 1;
+    ghandle->ais_slot[slot].seq = ghandle->p->data.ais.seq;
+    ghandle->ais_slot[slot].channel = ghandle->p->data.ais.channel;
 }
 
-#if LWGPS_CFG_CRC
 /**
- * \brief           Compare calculated CRC with received CRC
+ * \brief           De-armor payload character and append its 6 bits to reassembly slot
  * \param[in]       ghandle: GPS handle
- * \return          `1` on success, `0` otherwise
+ * \param[in]       ch: Payload character
  */
-static uint8_t
-prv_check_crc(lwgps_t* ghandle) {
-    uint8_t crc;
-    crc = (uint8_t)((CHTN(ghandle->p.term_str[0]) & 0x0FU) << 0x04U)
-          | (CHTN(ghandle->p.term_str[1]) & 0x0FU); /* Convert received CRC from string (hex) to number */
-    return ghandle->p.crc_calc == crc;              /* They must match! */
+static void
+prv_ais_add_char(lwgps_t* ghandle, uint8_t ch) {
+    uint8_t* b;
+    uint16_t v, pos = ghandle->p->data.ais.bits;
+    uint8_t sym;
+
+    if (ghandle->p->data.ais.slot == AIS_SLOT_NONE || ghandle->p->data.ais.err) {
+        return;
+    }
+    sym = (ch >= '0' && ch <= 'w') ? ais_armor_table[ch - '0'] : 0xFF;
+    if (sym == 0xFF || pos + 6 > LWGPS_CFG_AIS_BUFF_SIZE * 8) {
+        ghandle->p->data.ais.err = 1; /* Invalid character or message too long */
+        return;
+    }
+
+    /* Bits are written sequentially, 6 bits always fit to two bytes */
+    b = &ghandle->ais_slot[ghandle->p->data.ais.slot].buff[pos >> 3];
+    v = (uint16_t)((uint16_t)sym << (10 - (pos & 0x07)));
+    b[0] = (uint8_t)((b[0] & (uint8_t)(0xFF00U >> (pos & 0x07))) | (v >> 8));
+    b[1] = (uint8_t)v;
+    ghandle->p->data.ais.bits = (uint16_t)(pos + 6);
 }
-#else
-#define prv_check_crc(ghandle) (1)
-#endif /* LWGPS_CFG_CRC */
 
 /**
- * \brief           Copy temporary memory to user memory
+ * \brief           Commit received fragment and decode message when complete
  * \param[in]       ghandle: GPS handle
- * \return          `1` on success, `0` otherwise
+ * \return          `1` when position report has been decoded, `0` otherwise
  */
 static uint8_t
-prv_copy_from_tmp_memory(lwgps_t* ghandle) {
-    if (0) {
-#if LWGPS_CFG_STATEMENT_GPGGA
-    } else if (ghandle->p.stat == STAT_GGA) {
-        ghandle->latitude = ghandle->p.data.gga.latitude;
-        ghandle->longitude = ghandle->p.data.gga.longitude;
-        ghandle->altitude = ghandle->p.data.gga.altitude;
-        ghandle->geo_sep = ghandle->p.data.gga.geo_sep;
-        ghandle->sats_in_use = ghandle->p.data.gga.sats_in_use;
-        ghandle->fix = ghandle->p.data.gga.fix;
-        ghandle->hours = ghandle->p.data.gga.hours;
-        ghandle->minutes = ghandle->p.data.gga.minutes;
-        ghandle->seconds = ghandle->p.data.gga.seconds;
-        ghandle->dgps_age = ghandle->p.data.gga.dgps_age;
-#endif /* LWGPS_CFG_STATEMENT_GPGGA */
-#if LWGPS_CFG_STATEMENT_GPGSA
-    } else if (ghandle->p.stat == STAT_GSA) {
-        ghandle->dop_h = ghandle->p.data.gsa.dop_h;
-        ghandle->dop_p = ghandle->p.data.gsa.dop_p;
-        ghandle->dop_v = ghandle->p.data.gsa.dop_v;
-        ghandle->fix_mode = ghandle->p.data.gsa.fix_mode;
-        LWGPS_MEMCPY(ghandle->satellites_ids, ghandle->p.data.gsa.satellites_ids, sizeof(ghandle->satellites_ids));
-#endif /* LWGPS_CFG_STATEMENT_GPGSA */
-#if LWGPS_CFG_STATEMENT_GPGSV
-    } else if (ghandle->p.stat == STAT_GSV) {
-        ghandle->sats_in_view = ghandle->p.data.gsv.sats_in_view;
-#endif /* LWGPS_CFG_STATEMENT_GPGSV */
-#if LWGPS_CFG_STATEMENT_GPRMC
-    } else if (ghandle->p.stat == STAT_RMC) {
-        ghandle->course = ghandle->p.data.rmc.course;
-        ghandle->is_valid = ghandle->p.data.rmc.is_valid;
-        ghandle->speed = ghandle->p.data.rmc.speed;
-        ghandle->variation = ghandle->p.data.rmc.variation;
-        ghandle->date = ghandle->p.data.rmc.date;
-        ghandle->month = ghandle->p.data.rmc.month;
-        ghandle->year = ghandle->p.data.rmc.year;
-#endif /* LWGPS_CFG_STATEMENT_GPRMC */
-#if LWGPS_CFG_STATEMENT_PUBX_TIME
-    } else if (ghandle->p.stat == STAT_UBX_TIME) {
-        ghandle->hours = ghandle->p.data.time.hours;
-        ghandle->minutes = ghandle->p.data.time.minutes;
-        ghandle->seconds = ghandle->p.data.time.seconds;
-        ghandle->date = ghandle->p.data.time.date;
-        ghandle->month = ghandle->p.data.time.month;
-        ghandle->year = ghandle->p.data.time.year;
-        ghandle->utc_tow = ghandle->p.data.time.utc_tow;
-        ghandle->utc_wk = ghandle->p.data.time.utc_wk;
-        ghandle->leap_sec = ghandle->p.data.time.leap_sec;
-        ghandle->clk_bias = ghandle->p.data.time.clk_bias;
-        ghandle->clk_drift = ghandle->p.data.time.clk_drift;
-        ghandle->tp_gran = ghandle->p.data.time.tp_gran;
-#endif /* LWGPS_CFG_STATEMENT_PUBX_TIME */
+prv_ais_commit(lwgps_t* ghandle) {
+    const uint8_t* b;
+    uint16_t base, bits;
+    uint8_t type;
+
+    if (ghandle->p->data.ais.slot == AIS_SLOT_NONE) {
+        return 0;
+    }
+    if (ghandle->p->data.ais.err) { /* Message can not be completed any more */
+        ghandle->ais_slot[ghandle->p->data.ais.slot].frag_next = 0;
+        return 0;
+    }
+    if (ghandle->p->data.ais.frag_num < ghandle->p->data.ais.frag_cnt) {
+        if (ghandle->p->data.ais.frag_num == 1) {
+            prv_ais_claim_slot(ghandle, ghandle->p->data.ais.slot);
+        }
+        ghandle->ais_slot[ghandle->p->data.ais.slot].bits = ghandle->p->data.ais.bits;
+        ++ghandle->ais_slot[ghandle->p->data.ais.slot].frag_next;
+        return 0;
+    }
+
+    /* Last fragment, release the slot and decode directly from it, single fragment message never claims it */
+    ghandle->ais_slot[ghandle->p->data.ais.slot].frag_next = 0;
+    b = ghandle->ais_slot[ghandle->p->data.ais.slot].buff;
+    bits = ghandle->p->data.ais.bits - ghandle->p->data.ais.fill;
+    type = (uint8_t)prv_ais_bits(b, 0, 6);
+    if (bits < AIS_POS_REP_BITS || ghandle->p->data.ais.fill > 5 || !((type >= 1 && type <= 3) || type == 18)) {
+        return 0;
+    }
+    if (type == 18) {
+        base = 46;
+        ghandle->ais.nav_status = 15;
+        ghandle->ais.rot = -128;
+    } else {
+        base = 50;
+        ghandle->ais.nav_status = (uint8_t)prv_ais_bits(b, 38, 4);
+        ghandle->ais.rot = (int8_t)prv_ais_sbits(b, 42, 8);
     }
+    ghandle->ais.type = type;
+    ghandle->ais.mmsi = prv_ais_bits(b, 8, 30);
+    ghandle->ais.speed = FLT(prv_ais_bits(b, base, 10)) * FLT(0.1);
+    ghandle->ais.accuracy = (uint8_t)prv_ais_bits(b, base + 10, 1);
+    ghandle->ais.longitude = FLT(prv_ais_sbits(b, base + 11, 28)) / FLT(600000);
+    ghandle->ais.latitude = FLT(prv_ais_sbits(b, base + 39, 27)) / FLT(600000);
+    ghandle->ais.course = FLT(prv_ais_bits(b, base + 66, 12)) * FLT(0.1);
+    ghandle->ais.heading = (uint16_t)prv_ais_bits(b, base + 78, 9);
+    ghandle->ais.timestamp = (uint8_t)prv_ais_bits(b, base + 87, 6);
+    ghandle->ais.own = ghandle->p->data.ais.own;
+    ghandle->ais.channel = ghandle->p->data.ais.channel;
     return 1;
 }
 
+#endif /* LWGPS_CFG_AIS */
+
+#if LWGPS_CFG_TAG
+
 /**
- * \brief           Init GPS handle
- * \param[in]       ghandle: GPS handle structure
- * \return          `1` on success, `0` otherwise
+ * \brief           Start parsing new TAG block
+ * \param[in]       tp: TAG block parser
  */
-uint8_t
-lwgps_init(lwgps_t* ghandle) {
-    LWGPS_MEMSET(ghandle, 0x00, sizeof(*ghandle)); /* Reset structure */
-    return 1;
+static void
+prv_tag_start(lwgps_tag_parser_t* tp) {
+    LWGPS_MEMSET(tp, 0x00, sizeof(*tp));
+    tp->active = 1;
 }
 
 /**
- * \brief           Process NMEA data from GPS receiver
- * \param[in]       ghandle: GPS handle structure
- * \param[in]       data: Received data
- * \param[in]       len: Number of bytes to process
- * \param[in]       evt_fn: Event function to notify application layer.
- *                      This parameter is available only if \ref LWGPS_CFG_STATUS is enabled
- * \return          `1` on success, `0` otherwise
+ * \brief           Process single character of TAG block, after opening backslash
+ * \param[in]       tp: TAG block parser
+ * \param[in]       ch: Character to process
  */
-uint8_t
-#if LWGPS_CFG_STATUS || __DOXYGEN__
-lwgps_process(lwgps_t* ghandle, const void* data, size_t len, lwgps_process_fn evt_fn) {
-#else  /* LWGPS_CFG_STATUS */
-lwgps_process(lwgps_t* ghandle, const void* data, size_t len) {
-#endif /* !LWGPS_CFG_STATUS */
-    const uint8_t* d = data;
-
-    for (; len > 0; ++d, --len) {                                /* Process all bytes */
-        if (*d == '$') {                                         /* Check for beginning of NMEA line */
-            LWGPS_MEMSET(&ghandle->p, 0x00, sizeof(ghandle->p)); /* Reset private memory */
-            TERM_ADD(ghandle, *d);                               /* Add character to term */
-        } else if (*d == ',') {                                  /* Term separator character */
-            prv_parse_term(ghandle);                             /* Parse term we have currently in memory */
-            CRC_ADD(ghandle, *d);                                /* Add character to CRC computation */
-            TERM_NEXT(ghandle);                                  /* Start with next term */
-        } else if (*d == '*') {                                  /* Start indicates end of data for CRC computation */
-            prv_parse_term(ghandle);                             /* Parse term we have currently in memory */
-            ghandle->p.star = 1;                                 /* STAR detected */
-            TERM_NEXT(ghandle);                                  /* Start with next term */
-        } else if (*d == '\r') {
-            if (prv_check_crc(ghandle)) { /* Check for CRC result */
-                /* CRC is OK, in theory we can copy data from statements to user data */
-                prv_copy_from_tmp_memory(ghandle); /* Copy memory from temporary to user memory */
-#if LWGPS_CFG_STATUS
-                if (evt_fn != NULL) {
-                    evt_fn(ghandle->p.stat);
-                }
-            } else if (evt_fn != NULL) {
-                evt_fn(STAT_CHECKSUM_FAIL);
-#endif /* LWGPS_CFG_STATUS */
-            }
-        } else {
-            if (!ghandle->p.star) {   /* Add to CRC only if star not yet detected */
-                CRC_ADD(ghandle, *d); /* Add to CRC */
+static void
+prv_tag_add(lwgps_tag_parser_t* tp, uint8_t ch) {
+    if (ch == '\\') { /* End of TAG block */
+        tp->active = 0;
+        tp->tag.valid = tp->star == 3 && tp->crc_calc == tp->crc_rx;
+    } else if (tp->star) { /* Checksum characters */
+        tp->crc_rx = (uint8_t)((tp->crc_rx << 4) | (CHTN(ch) & 0x0F));
+        if (tp->star < UINT8_MAX) {
+            ++tp->star;
+        }
+    } else if (ch == '*') {
+        tp->star = 1;
+    } else {
+        tp->crc_calc ^= ch;
+        if (ch == ',') { /* Next field */
+            tp->pos = 0;
+            return;
+        }
+        if (tp->pos == 0) {
+            tp->field = (char)ch;
+        } else if (tp->pos >= 2) { /* Value follows field code and colon */
+            if (tp->field == 's' && tp->pos - 2 < (int)sizeof(tp->tag.src) - 1) {
+                tp->tag.src[tp->pos - 2] = (char)ch;
+            } else if (tp->field == 'c' && CIN(ch)) {
+                tp->tag.time = 10U * tp->tag.time + (uint64_t)CTN(ch);
             }
-            TERM_ADD(ghandle, *d); /* Add character to term */
+        }
+        if (tp->pos < UINT8_MAX) {
+            ++tp->pos;
         }
     }
-    return 1;
 }
 
-#if LWESP_CFG_DISTANCE_BEARING || __DOXYGEN__
+#endif /* LWGPS_CFG_TAG */
+
+#if LWGPS_CFG_CUSTOM
+
+#define CUSTOM_HASH_SIZE (2 * LWGPS_CFG_CUSTOM_MAX) /*!< Number of entries in custom statement hash table */
 
 /**
- * \brief           Calculate distance and bearing between `2` latitude and longitude coordinates
- * \param[in]       las: Latitude start coordinate, in units of degrees
- * \param[in]       los: Longitude start coordinate, in units of degrees
- * \param[in]       lae: Latitude end coordinate, in units of degrees
- * \param[in]       loe: Longitude end coordinate, in units of degrees
- * \param[out]      d: Pointer to output distance in units of meters
- * \param[out]      b: Pointer to output bearing between start and end coordinate in relation to north in units of degrees
- * \return          `1` on success, `0` otherwise
+ * \brief           Calculate hash table index of statement address
+ * \param[in]       addr: Address, `NULL` terminated
+ * \return          Index in hash table
  */
-uint8_t
-lwgps_distance_bearing(lwgps_float_t las, lwgps_float_t los, lwgps_float_t lae, lwgps_float_t loe, lwgps_float_t* d,
-                       lwgps_float_t* b) {
-    lwgps_float_t df, dfi, a;
+static uint8_t
+prv_custom_hash(const char* addr) {
+    uint32_t hash = 2166136261UL; /* FNV-1a */
 
-    if (d == NULL && b == NULL) {
-        return 0;
+    for (; *addr != '\0'; ++addr) {
+        hash = (hash ^ (uint8_t)*addr) * 16777619UL;
     }
+    return (uint8_t)(hash % CUSTOM_HASH_SIZE);
+}
 
-    /* Convert degrees to radians */
-    df = D2R(lae - las);
-    dfi = D2R(loe - los);
-    las = D2R(las);
-    los = D2R(los);
-    lae = D2R(lae);
-    loe = D2R(loe);
+/**
+ * \brief           Find custom statement descriptor by address
+ * \param[in]       ghandle: GPS handle
+ * \param[in]       addr: Address without start character, `NULL` terminated
+ * \return          Descriptor on success, `NULL` if statement is not registered
+ */
+static const lwgps_custom_t*
+prv_custom_find(lwgps_t* ghandle, const char* addr) {
+    uint8_t i, idx;
 
-    /*
-     * Calculate distance
-     *
-     * Calculated distance is absolute value in meters between 2 points on earth.
-     */
-    if (d != NULL) {
-        /*
-         * a = sin(df / 2)^2 + cos(las) * cos(lae) * sin(dfi / 2)^2
-         * *d = RADIUS * 2 * atan(sqrt(a) / sqrt(1 - a)) * 1000 (for meters)
-         */
-#if LWGPS_CFG_DOUBLE
-        a = FLT(sin(df * 0.5) * sin(df * 0.5) + sin(dfi * 0.5) * sin(dfi * 0.5) * cos(las) * cos(lae));
-        *d = FLT(EARTH_RADIUS * 2.0 * atan2(sqrt(a), sqrt(1.0 - a)) * 1000.0);
-#else  /* LWGPS_CFG_DOUBLE */
-        a = FLT(sinf(df * 0.5f) * sinf(df * 0.5f) + sinf(dfi * 0.5f) * sinf(dfi * 0.5f) * cosf(las) * cosf(lae));
-        *d = FLT(EARTH_RADIUS * 2.0f * atan2f(sqrtf(a), sqrtf(1.0f - a)) * 1000.0f);
-#endif /* !LWGPS_CFG_DOUBLE */
+    /* Linear probing, table is never full */
+    for (i = prv_custom_hash(addr); (idx = ghandle->custom_hash[i]) > 0; i = (uint8_t)((i + 1) % CUSTOM_HASH_SIZE)) {
+        if (!strcmp(ghandle->custom[idx - 1]->addr, addr)) {
+            return ghandle->custom[idx - 1];
+        }
     }
+    return NULL;
+}
 
-    /*
+#endif /* LWGPS_CFG_CUSTOM */
+
+/**
+ * \brief           Types of statement fields, each with its own decoding
+ */
+typedef enum {
+    FIELD_NONE = 0x00,  /*!< Field is ignored */
+    FIELD_U8,           /*!< Integer number, stored as `uint8_t` */
+    FIELD_U16,          /*!< Integer number, stored as `uint16_t` */
+    FIELD_U32,          /*!< Integer number, stored as `uint32_t` */
+    FIELD_FLOAT,        /*!< Floating point number */
+    FIELD_FLOAT_AUX,    /*!< Floating point number, stored as \ref lwgps_float_aux_t */
+    FIELD_LAT_LONG,     /*!< Latitude or longitude in `dddmm.mmmm` format, stored as degrees */
+    FIELD_NEG_SOUTH,    /*!< Negates previously parsed number on `S` */
+    FIELD_NEG_WEST,     /*!< Negates previously parsed number on `W` */
+    FIELD_NEG_WEST_AUX, /*!< Negates previously parsed \ref lwgps_float_aux_t number on `W` */
+    FIELD_TRIPLET,      /*!< Three 2-digit numbers, such as `hhmmss` or `ddmmyy`, stored to `3` consecutive bytes */
+    FIELD_STATUS,       /*!< Data status, `1` for `A` or `0` otherwise */
+    FIELD_LEAP_SEC,     /*!< PUBX leap seconds, 2 or 3 digits with optional `D` suffix */
+    FIELD_GSV_SAT,      /*!< Part of satellite description in GSV statement */
+} prv_field_type_t;
+
+/**
+ * \brief           Field descriptor, indexed by term number
+ */
+typedef struct {
+    uint8_t type;    /*!< Field type, member of \ref prv_field_type_t */
+    uint16_t offset; /*!< Offset of destination in staging memory */
+    uint32_t mask;   /*!< Public field group, member of \ref lwgps_field_t, `0` if field has no own storage */
+} prv_field_t;
+
+/**
+ * \brief           Field descriptors of single statement
+ */
+typedef struct {
+    const prv_field_t* fields; /*!< Array of fields, indexed by term number */
+    uint8_t count;             /*!< Number of entries in array */
+} prv_field_table_t;
+
+/**
+ * \brief           Contiguous block of public fields, copied from staging memory on commit
+ */
+typedef struct {
+    uint8_t stat;  /*!< Statement the block belongs to */
+    uint16_t dst;  /*!< Offset of first public field in GPS handle */
+    uint16_t src;  /*!< Offset of first staging field in staging memory */
+    uint16_t size; /*!< Size of the block in units of bytes */
+} prv_commit_block_t;
+
+#define STAGING_OFFSET(member) ((uint16_t)(offsetof(lwgps_scratch_t, data.member) - offsetof(lwgps_scratch_t, data)))
+#define MEMBER_SIZE(member)    sizeof(((lwgps_t*)0)->member)
+#define SPAN(first, last)      (offsetof(lwgps_t, last) + MEMBER_SIZE(last) - offsetof(lwgps_t, first))
+#define STAGING_SPAN(first, last)                                                                                      \
+    (STAGING_OFFSET(last) + sizeof(((lwgps_scratch_t*)0)->data.last) - STAGING_OFFSET(first))
+#define FIELD_ENTRY(term, type, member, mask) [term] = {type, STAGING_OFFSET(member), mask},
+#define STATIC_ASSERT(name, cond)       typedef char prv_static_assert_##name[(cond) ? 1 : -1]
+
+/*
+ * Field lists of built-in statements: term number, field type, staging member and public field mask.
+ * Parse and commit paths are both generated from these lists and the staging layouts
+ */
+#define GGA_FIELDS(X)                                                                                                  \
+    X(1, FIELD_TRIPLET, gga.hours, LWGPS_FIELD_TIME)                                                                   \
+    X(2, FIELD_LAT_LONG, gga.latitude, LWGPS_FIELD_LATITUDE)                                                           \
+    X(3, FIELD_NEG_SOUTH, gga.latitude, 0)                                                                             \
+    X(4, FIELD_LAT_LONG, gga.longitude, LWGPS_FIELD_LONGITUDE)                                                         \
+    X(5, FIELD_NEG_WEST, gga.longitude, 0)                                                                             \
+    X(6, FIELD_U8, gga.fix, LWGPS_FIELD_FIX)                                                                           \
+    X(7, FIELD_U8, gga.sats_in_use, LWGPS_FIELD_SATS_IN_USE)                                                           \
+    X(9, FIELD_FLOAT_AUX, gga.altitude, LWGPS_FIELD_ALTITUDE)                                                          \
+    X(11, FIELD_FLOAT_AUX, gga.geo_sep, LWGPS_FIELD_GEO_SEP)                                                           \
+    X(13, FIELD_FLOAT_AUX, gga.dgps_age, LWGPS_FIELD_DGPS_AGE)
+
+#define GSA_FIELDS(X)                                                                                                  \
+    X(2, FIELD_U8, gsa.fix_mode, LWGPS_FIELD_FIX_MODE)                                                                 \
+    X(3, FIELD_U8, gsa.satellites_ids[0], LWGPS_FIELD_SATELLITES_IDS)                                                  \
+    X(4, FIELD_U8, gsa.satellites_ids[1], LWGPS_FIELD_SATELLITES_IDS)                                                  \
+    X(5, FIELD_U8, gsa.satellites_ids[2], LWGPS_FIELD_SATELLITES_IDS)                                                  \
+    X(6, FIELD_U8, gsa.satellites_ids[3], LWGPS_FIELD_SATELLITES_IDS)                                                  \
+    X(7, FIELD_U8, gsa.satellites_ids[4], LWGPS_FIELD_SATELLITES_IDS)                                                  \
+    X(8, FIELD_U8, gsa.satellites_ids[5], LWGPS_FIELD_SATELLITES_IDS)                                                  \
+    X(9, FIELD_U8, gsa.satellites_ids[6], LWGPS_FIELD_SATELLITES_IDS)                                                  \
+    X(10, FIELD_U8, gsa.satellites_ids[7], LWGPS_FIELD_SATELLITES_IDS)                                                 \
+    X(11, FIELD_U8, gsa.satellites_ids[8], LWGPS_FIELD_SATELLITES_IDS)                                                 \
+    X(12, FIELD_U8, gsa.satellites_ids[9], LWGPS_FIELD_SATELLITES_IDS)                                                 \
+    X(13, FIELD_U8, gsa.satellites_ids[10], LWGPS_FIELD_SATELLITES_IDS)                                                \
+    X(14, FIELD_U8, gsa.satellites_ids[11], LWGPS_FIELD_SATELLITES_IDS)                                                \
+    X(15, FIELD_FLOAT_AUX, gsa.dop_p, LWGPS_FIELD_DOP_P)                                                               \
+    X(16, FIELD_FLOAT_AUX, gsa.dop_h, LWGPS_FIELD_DOP_H)                                                               \
+    X(17, FIELD_FLOAT_AUX, gsa.dop_v, LWGPS_FIELD_DOP_V)
+
+#if LWGPS_CFG_STATEMENT_GPGSV_SAT_DET
+#define GSV_SAT_FIELDS(X)                                                                                              \
+    X(4, FIELD_GSV_SAT, gsv, LWGPS_FIELD_SATS_IN_VIEW_DESC)                                                            \
+    X(5, FIELD_GSV_SAT, gsv, LWGPS_FIELD_SATS_IN_VIEW_DESC)                                                            \
+    X(6, FIELD_GSV_SAT, gsv, LWGPS_FIELD_SATS_IN_VIEW_DESC)                                                            \
+    X(7, FIELD_GSV_SAT, gsv, LWGPS_FIELD_SATS_IN_VIEW_DESC)                                                            \
+    X(8, FIELD_GSV_SAT, gsv, LWGPS_FIELD_SATS_IN_VIEW_DESC)                                                            \
+    X(9, FIELD_GSV_SAT, gsv, LWGPS_FIELD_SATS_IN_VIEW_DESC)                                                            \
+    X(10, FIELD_GSV_SAT, gsv, LWGPS_FIELD_SATS_IN_VIEW_DESC)                                                           \
+    X(11, FIELD_GSV_SAT, gsv, LWGPS_FIELD_SATS_IN_VIEW_DESC)                                                           \
+    X(12, FIELD_GSV_SAT, gsv, LWGPS_FIELD_SATS_IN_VIEW_DESC)                                                           \
+    X(13, FIELD_GSV_SAT, gsv, LWGPS_FIELD_SATS_IN_VIEW_DESC)                                                           \
+    X(14, FIELD_GSV_SAT, gsv, LWGPS_FIELD_SATS_IN_VIEW_DESC)                                                           \
+    X(15, FIELD_GSV_SAT, gsv, LWGPS_FIELD_SATS_IN_VIEW_DESC)                                                           \
+    X(16, FIELD_GSV_SAT, gsv, LWGPS_FIELD_SATS_IN_VIEW_DESC)                                                           \
+    X(17, FIELD_GSV_SAT, gsv, LWGPS_FIELD_SATS_IN_VIEW_DESC)                                                           \
+    X(18, FIELD_GSV_SAT, gsv, LWGPS_FIELD_SATS_IN_VIEW_DESC)                                                           \
+    X(19, FIELD_GSV_SAT, gsv, LWGPS_FIELD_SATS_IN_VIEW_DESC)
+#else
+#define GSV_SAT_FIELDS(X)
+#endif /* LWGPS_CFG_STATEMENT_GPGSV_SAT_DET */
+
+#define GSV_FIELDS(X)                                                                                                  \
+    X(2, FIELD_U8, gsv.stat_num, 0)                                                                                    \
+    X(3, FIELD_U8, gsv.sats_in_view, LWGPS_FIELD_SATS_IN_VIEW)                                                         \
+    GSV_SAT_FIELDS(X)
+
+#define RMC_FIELDS(X)                                                                                                  \
+    X(2, FIELD_STATUS, rmc.is_valid, LWGPS_FIELD_IS_VALID)                                                             \
+    X(7, FIELD_FLOAT_AUX, rmc.speed, LWGPS_FIELD_SPEED)                                                                \
+    X(8, FIELD_FLOAT_AUX, rmc.course, LWGPS_FIELD_COURSE)                                                              \
+    X(9, FIELD_TRIPLET, rmc.date, LWGPS_FIELD_DATE)                                                                    \
+    X(10, FIELD_FLOAT_AUX, rmc.variation, LWGPS_FIELD_VARIATION)                                                       \
+    X(11, FIELD_NEG_WEST_AUX, rmc.variation, 0)
+
+#define PUBX_TIME_FIELDS(X)                                                                                            \
+    X(2, FIELD_TRIPLET, time.hours, LWGPS_FIELD_TIME)                                                                  \
+    X(3, FIELD_TRIPLET, time.date, LWGPS_FIELD_DATE)                                                                   \
+    X(4, FIELD_FLOAT, time.utc_tow, LWGPS_FIELD_UTC_TOW)                                                               \
+    X(5, FIELD_U16, time.utc_wk, LWGPS_FIELD_UTC_WK)                                                                   \
+    X(6, FIELD_LEAP_SEC, time.leap_sec, LWGPS_FIELD_LEAP_SEC)                                                          \
+    X(7, FIELD_U32, time.clk_bias, LWGPS_FIELD_CLK_BIAS)                                                               \
+    X(8, FIELD_FLOAT_AUX, time.clk_drift, LWGPS_FIELD_CLK_DRIFT)                                                       \
+    X(9, FIELD_U32, time.tp_gran, LWGPS_FIELD_TP_GRAN)
+
+#if LWGPS_CFG_STATEMENT_GPGGA
+static const prv_field_t gga_fields[] = {GGA_FIELDS(FIELD_ENTRY)};
+STATIC_ASSERT(gga_layout, SPAN(latitude, seconds) == STAGING_SPAN(gga.latitude, gga.seconds)
+                              && SPAN(latitude, hours) == STAGING_SPAN(gga.latitude, gga.hours));
+#endif /* LWGPS_CFG_STATEMENT_GPGGA */
+#if LWGPS_CFG_STATEMENT_GPGSA
+static const prv_field_t gsa_fields[] = {GSA_FIELDS(FIELD_ENTRY)};
+STATIC_ASSERT(gsa_layout, SPAN(fix_mode, satellites_ids) == STAGING_SPAN(gsa.fix_mode, gsa.satellites_ids)
+                              && SPAN(dop_h, dop_p) == STAGING_SPAN(gsa.dop_h, gsa.dop_p));
+#endif /* LWGPS_CFG_STATEMENT_GPGSA */
+#if LWGPS_CFG_STATEMENT_GPGSV
+static const prv_field_t gsv_fields[] = {GSV_FIELDS(FIELD_ENTRY)};
+#endif /* LWGPS_CFG_STATEMENT_GPGSV */
+#if LWGPS_CFG_STATEMENT_GPRMC
+static const prv_field_t rmc_fields[] = {RMC_FIELDS(FIELD_ENTRY)};
+STATIC_ASSERT(rmc_layout, SPAN(speed, year) == STAGING_SPAN(rmc.speed, rmc.year)
+                              && SPAN(speed, date) == STAGING_SPAN(rmc.speed, rmc.date));
+#endif /* LWGPS_CFG_STATEMENT_GPRMC */
+#if LWGPS_CFG_STATEMENT_PUBX_TIME
+static const prv_field_t pubx_time_fields[] = {PUBX_TIME_FIELDS(FIELD_ENTRY)};
+STATIC_ASSERT(pubx_time_layout, SPAN(utc_tow, tp_gran) == STAGING_SPAN(time.utc_tow, time.tp_gran)
+                                    && SPAN(utc_tow, clk_bias) == STAGING_SPAN(time.utc_tow, time.clk_bias));
+#endif /* LWGPS_CFG_STATEMENT_PUBX_TIME */
+
+/* Field tables, indexed by statement */
+static const prv_field_table_t field_tables[] = {
+    [STAT_UNKNOWN] = {NULL, 0},
+#if LWGPS_CFG_STATEMENT_GPGGA
+    [STAT_GGA] = {gga_fields, sizeof(gga_fields) / sizeof(gga_fields[0])},
+#endif /* LWGPS_CFG_STATEMENT_GPGGA */
+#if LWGPS_CFG_STATEMENT_GPGSA
+    [STAT_GSA] = {gsa_fields, sizeof(gsa_fields) / sizeof(gsa_fields[0])},
+#endif /* LWGPS_CFG_STATEMENT_GPGSA */
+#if LWGPS_CFG_STATEMENT_GPGSV
+    [STAT_GSV] = {gsv_fields, sizeof(gsv_fields) / sizeof(gsv_fields[0])},
+#endif /* LWGPS_CFG_STATEMENT_GPGSV */
+#if LWGPS_CFG_STATEMENT_GPRMC
+    [STAT_RMC] = {rmc_fields, sizeof(rmc_fields) / sizeof(rmc_fields[0])},
+#endif /* LWGPS_CFG_STATEMENT_GPRMC */
+#if LWGPS_CFG_STATEMENT_PUBX_TIME
+    [STAT_UBX_TIME] = {pubx_time_fields, sizeof(pubx_time_fields) / sizeof(pubx_time_fields[0])},
+#endif /* LWGPS_CFG_STATEMENT_PUBX_TIME */
+};
+
+/* Blocks of public fields, each copied from its staging mirror with single copy */
+static const prv_commit_block_t commit_blocks[] = {
+#if LWGPS_CFG_STATEMENT_GPGGA
+    {STAT_GGA, offsetof(lwgps_t, latitude), STAGING_OFFSET(gga.latitude), SPAN(latitude, seconds)},
+#endif /* LWGPS_CFG_STATEMENT_GPGGA */
+#if LWGPS_CFG_STATEMENT_GPGSA
+    {STAT_GSA, offsetof(lwgps_t, fix_mode), STAGING_OFFSET(gsa.fix_mode), SPAN(fix_mode, satellites_ids)},
+    {STAT_GSA, offsetof(lwgps_t, dop_h), STAGING_OFFSET(gsa.dop_h), SPAN(dop_h, dop_p)},
+#endif /* LWGPS_CFG_STATEMENT_GPGSA */
+#if LWGPS_CFG_STATEMENT_GPGSV
+    {STAT_GSV, offsetof(lwgps_t, sats_in_view), STAGING_OFFSET(gsv.sats_in_view), MEMBER_SIZE(sats_in_view)},
+#endif /* LWGPS_CFG_STATEMENT_GPGSV */
+#if LWGPS_CFG_STATEMENT_GPRMC
+    {STAT_RMC, offsetof(lwgps_t, is_valid), STAGING_OFFSET(rmc.is_valid), MEMBER_SIZE(is_valid)},
+    {STAT_RMC, offsetof(lwgps_t, speed), STAGING_OFFSET(rmc.speed), SPAN(speed, year)},
+#endif /* LWGPS_CFG_STATEMENT_GPRMC */
+#if LWGPS_CFG_STATEMENT_PUBX_TIME
+    {STAT_UBX_TIME, offsetof(lwgps_t, hours), STAGING_OFFSET(time.hours), SPAN(hours, seconds)},
+    {STAT_UBX_TIME, offsetof(lwgps_t, date), STAGING_OFFSET(time.date), SPAN(date, year)},
+    {STAT_UBX_TIME, offsetof(lwgps_t, utc_tow), STAGING_OFFSET(time.utc_tow), SPAN(utc_tow, tp_gran)},
+#endif /* LWGPS_CFG_STATEMENT_PUBX_TIME */
+    {STAT_UNKNOWN, 0, 0, 0},
+};
+
+#if LWGPS_CFG_COMPACT
+/* Compact handle keeps time, position, validity and velocity of the fix in the first cache line */
+#if LWGPS_CFG_STATEMENT_GPGGA && LWGPS_CFG_STATEMENT_GPRMC
+STATIC_ASSERT(compact_hot_line, offsetof(lwgps_t, year) < 64);
+#if LWGPS_CFG_STATEMENT_GPGSA && LWGPS_CFG_STATEMENT_GPGSV
+/* Fields of all statements are packed, with padding only for alignment of floating point values */
+STATIC_ASSERT(compact_packed, SPAN(latitude, dop_p) - (2 * sizeof(lwgps_float_t) + 9 * sizeof(lwgps_float_aux_t) + 23)
+                                  < sizeof(lwgps_float_aux_t));
+#endif /* LWGPS_CFG_STATEMENT_GPGSA && LWGPS_CFG_STATEMENT_GPGSV */
+#endif /* LWGPS_CFG_STATEMENT_GPGGA && LWGPS_CFG_STATEMENT_GPRMC */
+#if !LWGPS_CFG_CUSTOM && !LWGPS_CFG_TAG && !LWGPS_CFG_LATENCY
+/* Scratch state of sentence being received fits single cache line */
+STATIC_ASSERT(compact_scratch, sizeof(lwgps_scratch_t) <= 64);
+#endif /* !LWGPS_CFG_CUSTOM && !LWGPS_CFG_TAG && !LWGPS_CFG_LATENCY */
+#define SCRATCH_READY(_gh) ((_gh)->p != NULL)
+#else
+#define SCRATCH_READY(_gh) 1
+#endif /* LWGPS_CFG_COMPACT */
+
+/**
+ * \brief           Parse current term according to field descriptor
+ * \param[in]       ghandle: GPS handle
+ * \param[in]       field: Field descriptor
+ */
+static void
+prv_parse_field(lwgps_t* ghandle, const prv_field_t* field) {
+    uint8_t* dst = (uint8_t*)&ghandle->p->data + field->offset;
+    const char* t = ghandle->p->term_str;
+
+    switch (field->type) {
+        case FIELD_U8: *dst = (uint8_t)prv_parse_number(ghandle, NULL); break;
+        case FIELD_U16: *(uint16_t*)dst = (uint16_t)prv_parse_number(ghandle, NULL); break;
+        case FIELD_U32: *(uint32_t*)dst = (uint32_t)prv_parse_number(ghandle, NULL); break;
+        case FIELD_FLOAT: *(lwgps_float_t*)dst = prv_parse_float_number(ghandle, NULL); break;
+        case FIELD_FLOAT_AUX:
+            *(lwgps_float_aux_t*)dst = (lwgps_float_aux_t)prv_parse_float_number(ghandle, NULL);
+            break;
+        case FIELD_LAT_LONG: *(lwgps_float_t*)dst = prv_parse_lat_long(ghandle); break;
+        case FIELD_NEG_SOUTH:
+            if (t[0] == 'S' || t[0] == 's') {
+                *(lwgps_float_t*)dst = -*(lwgps_float_t*)dst;
+            }
+            break;
+        case FIELD_NEG_WEST:
+            if (t[0] == 'W' || t[0] == 'w') {
+                *(lwgps_float_t*)dst = -*(lwgps_float_t*)dst;
+            }
+            break;
+        case FIELD_NEG_WEST_AUX:
+            if (t[0] == 'W' || t[0] == 'w') {
+                *(lwgps_float_aux_t*)dst = -*(lwgps_float_aux_t*)dst;
+            }
+            break;
+        case FIELD_TRIPLET: /* Fractions, such as of seconds, are ignored */
+            dst[0] = (uint8_t)(10U * CTN(t[0]) + CTN(t[1]));
+            dst[1] = (uint8_t)(10U * CTN(t[2]) + CTN(t[3]));
+            dst[2] = (uint8_t)(10U * CTN(t[4]) + CTN(t[5]));
+            break;
+        case FIELD_STATUS: *dst = t[0] == 'A'; break;
+        case FIELD_LEAP_SEC:
+            /*
+             * Accomodate a 2- or 3-digit leap second count
+             * a trailing 'D' means this is the firmware's default value.
+             */
+            if (t[2] == 'D' || t[2] == '\0') {
+                *dst = (uint8_t)(10U * CTN(t[0]) + CTN(t[1]));
+            } else {
+                *dst = (uint8_t)(100U * CTN(t[0]) + 10U * CTN(t[1]) + CTN(t[2]));
+            }
+            break;
+#if LWGPS_CFG_STATEMENT_GPGSV && LWGPS_CFG_STATEMENT_GPGSV_SAT_DET
+        case FIELD_GSV_SAT: {
+            uint8_t index, term_num = ghandle->p->term_num - 4; /* Normalize term number from 4-19 to 0-15 */
+            uint16_t value;
+
+            index = ((ghandle->p->data.gsv.stat_num - 1) << 0x02) + (term_num >> 2); /* Get array index */
+            if (index < sizeof(ghandle->sats_in_view_desc) / sizeof(ghandle->sats_in_view_desc[0])) {
+                value = (uint16_t)prv_parse_number(ghandle, NULL); /* Parse number as integer */
+                switch (term_num & 0x03) {
+                    case 0: ghandle->sats_in_view_desc[index].num = value; break;
+                    case 1: ghandle->sats_in_view_desc[index].elevation = value; break;
+                    case 2: ghandle->sats_in_view_desc[index].azimuth = value; break;
+                    case 3: ghandle->sats_in_view_desc[index].snr = value; break;
+                    default: break;
+                }
+            }
+            break;
+        }
+#endif /* LWGPS_CFG_STATEMENT_GPGSV && LWGPS_CFG_STATEMENT_GPGSV_SAT_DET */
+        default: break;
+    }
+}
+
+/* Size of staging memory written by each field type, `0` for fields without own storage */
+static const uint8_t field_sizes[] = {
+    [FIELD_U8] = 1,
+    [FIELD_U16] = 2,
+    [FIELD_U32] = 4,
+    [FIELD_FLOAT] = sizeof(lwgps_float_t),
+    [FIELD_FLOAT_AUX] = sizeof(lwgps_float_aux_t),
+    [FIELD_LAT_LONG] = sizeof(lwgps_float_t),
+    [FIELD_TRIPLET] = 3,
+    [FIELD_STATUS] = 1,
+    [FIELD_LEAP_SEC] = 1,
+    [FIELD_GSV_SAT] = 0,
+};
+
+/**
+ * \brief           Commit staging fields of built-in statement to user memory
+ *
+ *                  Staging memory is not reset at sentence start,
+ *                  fields of missing or empty terms are cleared first, to be committed as `0`
+ *
+ * \param[in]       ghandle: GPS handle
+ */
+static void
+prv_commit_fields(lwgps_t* ghandle) {
+    const prv_field_table_t* table;
+    const prv_commit_block_t* block;
+    uint32_t updated = 0, present = 0;
+    uint8_t i;
+
+    if (ghandle->p->stat >= sizeof(field_tables) / sizeof(field_tables[0])) {
+        return;
+    }
+    table = &field_tables[ghandle->p->stat];
+    for (i = 0; i < ghandle->p->field_cnt; ++i) {
+        updated |= table->fields[i].mask;
+        if (ghandle->p->present & ((uint32_t)1 << i)) {
+            present |= table->fields[i].mask;
+        } else if (field_sizes[table->fields[i].type] > 0) {
+            LWGPS_MEMSET((uint8_t*)&ghandle->p->data + table->fields[i].offset, 0x00,
+                         field_sizes[table->fields[i].type]);
+        }
+    }
+    for (block = commit_blocks; block->size > 0; ++block) {
+        if (block->stat == ghandle->p->stat) {
+            LWGPS_MEMCPY((uint8_t*)ghandle + block->dst, (uint8_t*)&ghandle->p->data + block->src, block->size);
+        }
+    }
+    FIELDS_MARK(ghandle, updated, present);
+}
+
+/**
+ * \brief           Resolve detected statement against runtime features
+ *                  and cache number of its generic fields
+ *
+ *                  Called once per sentence, so terms are processed without checking features again
+ *
+ * \param[in]       ghandle: GPS handle
+ */
+static void
+prv_dispatch(lwgps_t* ghandle) {
+#if LWGPS_CFG_RUNTIME_MASK
+    if (ghandle->features_off & ((uint32_t)1 << ghandle->p->stat)) {
+        ghandle->p->stat = STAT_UNKNOWN; /* Disabled for this handle, sentence is ignored */
+    }
+#endif /* LWGPS_CFG_RUNTIME_MASK */
+    if (ghandle->p->stat < sizeof(field_tables) / sizeof(field_tables[0])) {
+        ghandle->p->field_cnt = field_tables[ghandle->p->stat].count;
+    } else {
+        ghandle->p->field_cnt = 0;
+    }
+#if LWGPS_CFG_RUNTIME_MASK && LWGPS_CFG_STATEMENT_GPGSV && LWGPS_CFG_STATEMENT_GPGSV_SAT_DET
+    if (ghandle->p->stat == STAT_GSV && (ghandle->features_off & LWGPS_FEATURE_GSV_SAT_DET)) {
+        ghandle->p->field_cnt = 4; /* Satellite details start with term 4 */
+    }
+#endif /* LWGPS_CFG_RUNTIME_MASK && LWGPS_CFG_STATEMENT_GPGSV && LWGPS_CFG_STATEMENT_GPGSV_SAT_DET */
+}
+
+/**
+ * \brief           Parse received term
+ * \param[in]       ghandle: GPS handle
+ * \return          `1` on success, `0` otherwise
+ */
+static uint8_t
+prv_parse_term(lwgps_t* ghandle) {
+    if (ghandle->p->term_num == 0) { /* Check string type */
+        if (0) {
+#if LWGPS_CFG_STATEMENT_GPGGA
+        } else if (!strncmp(ghandle->p->term_str, "$GPGGA", 6) || !strncmp(ghandle->p->term_str, "$GNGGA", 6)) {
+            ghandle->p->stat = STAT_GGA;
+#endif /* LWGPS_CFG_STATEMENT_GPGGA */
+#if LWGPS_CFG_STATEMENT_GPGSA
+        } else if (!strncmp(ghandle->p->term_str, "$GPGSA", 6) || !strncmp(ghandle->p->term_str, "$GNGSA", 6)) {
+            ghandle->p->stat = STAT_GSA;
+#endif /* LWGPS_CFG_STATEMENT_GPGSA */
+#if LWGPS_CFG_STATEMENT_GPGSV
+        } else if (!strncmp(ghandle->p->term_str, "$GPGSV", 6) || !strncmp(ghandle->p->term_str, "$GNGSV", 6)) {
+            ghandle->p->stat = STAT_GSV;
+#endif /* LWGPS_CFG_STATEMENT_GPGSV */
+#if LWGPS_CFG_STATEMENT_GPRMC
+        } else if (!strncmp(ghandle->p->term_str, "$GPRMC", 6) || !strncmp(ghandle->p->term_str, "$GNRMC", 6)) {
+            ghandle->p->stat = STAT_RMC;
+#endif /* LWGPS_CFG_STATEMENT_GPRMC */
+#if LWGPS_CFG_STATEMENT_PUBX
+        } else if (!strncmp(ghandle->p->term_str, "$PUBX", 5)) {
+            ghandle->p->stat = STAT_UBX;
+#endif /* LWGPS_CFG_STATEMENT_PUBX */
+#if LWGPS_CFG_AIS
+        } else if (ghandle->p->term_str[0] == '!'
+                   && (!strncmp(&ghandle->p->term_str[3], "VDM", 3) || !strncmp(&ghandle->p->term_str[3], "VDO", 3))) {
+            ghandle->p->stat = STAT_AIS;
+            LWGPS_MEMSET(&ghandle->p->data.ais, 0x00, sizeof(ghandle->p->data.ais));
+            ghandle->p->data.ais.own = ghandle->p->term_str[5] == 'O';
+            ghandle->p->data.ais.slot = AIS_SLOT_NONE;
+#endif /* LWGPS_CFG_AIS */
+#if LWGPS_CFG_CUSTOM
+        } else if ((ghandle->p->custom = prv_custom_find(ghandle, &ghandle->p->term_str[1])) != NULL) {
+            ghandle->p->stat = STAT_CUSTOM;
+#endif /* LWGPS_CFG_CUSTOM */
+        } else {
+            ghandle->p->stat = STAT_UNKNOWN; /* Invalid statement for library */
+        }
+        prv_dispatch(ghandle);
+        return 1;
+    }
+
+    /* Start parsing terms */
+    if (ghandle->p->term_num < ghandle->p->field_cnt) { /* Built-in statement, generic decoding */
+        prv_parse_field(ghandle, &field_tables[ghandle->p->stat].fields[ghandle->p->term_num]);
+        if (ghandle->p->term_str[0] != '\0') {
+            ghandle->p->present |= (uint32_t)1 << ghandle->p->term_num;
+        }
+#if LWGPS_CFG_STATEMENT_PUBX
+    } else if (ghandle->p->stat == STAT_UBX) { /* Disambiguate generic PUBX statement */
+        if (ghandle->p->term_str[0] == '0' && ghandle->p->term_str[1] == '4') {
+            ghandle->p->stat = STAT_UBX_TIME;
+            prv_dispatch(ghandle);
+        }
+#endif /* LWGPS_CFG_STATEMENT_PUBX */
+#if LWGPS_CFG_CUSTOM
+    } else if (ghandle->p->stat == STAT_CUSTOM) { /* Process application registered statement */
+        if (ghandle->p->term_num <= ghandle->p->custom->field_cnt && ghandle->p->custom->term_fn != NULL) {
+            ghandle->p->custom->term_fn(ghandle, ghandle->p->custom, ghandle->p->term_num, ghandle->p->term_str);
+        }
+#endif /* LWGPS_CFG_CUSTOM */
+#if LWGPS_CFG_AIS
+    } else if (ghandle->p->stat == STAT_AIS) { /* Process AIS VDM or VDO sentence */
+        switch (ghandle->p->term_num) {
+            case 1: ghandle->p->data.ais.frag_cnt = (uint8_t)prv_parse_number(ghandle, NULL); break;
+            case 2: ghandle->p->data.ais.frag_num = (uint8_t)prv_parse_number(ghandle, NULL); break;
+            case 3: /* Sequential message ID, empty for single fragment messages */
+                ghandle->p->data.ais.seq = CIN(ghandle->p->term_str[0]) ? CTN(ghandle->p->term_str[0]) : 0xFF;
+                break;
+            case 4: /* Radio channel, fragment header is now complete */
+                ghandle->p->data.ais.channel = ghandle->p->term_str[0];
+                if (ghandle->p->data.ais.frag_num >= 1
+                    && ghandle->p->data.ais.frag_num <= ghandle->p->data.ais.frag_cnt) {
+                    prv_ais_select_slot(ghandle);
+                }
+                break;
+            case 6: /* Number of fill bits */
+                ghandle->p->data.ais.fill = (uint8_t)prv_parse_number(ghandle, NULL);
+                break;
+            default: break;
+        }
+#endif /* LWGPS_CFG_AIS */
+    }
+    return 1;
+}
+
+#if LWGPS_CFG_CRC
+/**
+ * \brief           Compare calculated CRC with received CRC
+ * \param[in]       ghandle: GPS handle
+ * \return          `1` on success, `0` otherwise
+ */
+static uint8_t
+prv_check_crc(lwgps_t* ghandle) {
+    uint8_t crc;
+    crc = (uint8_t)((CHTN(ghandle->p->term_str[0]) & 0x0FU) << 0x04U)
+          | (CHTN(ghandle->p->term_str[1]) & 0x0FU); /* Convert received CRC from string (hex) to number */
+    return ghandle->p->crc_calc == crc;              /* They must match! */
+}
+#else
+#define prv_check_crc(ghandle) (1)
+#endif /* LWGPS_CFG_CRC */
+
+#if LWGPS_CFG_RUNTIME_MASK
+#define CRC_OK(ghandle) (((ghandle)->features_off & LWGPS_FEATURE_CRC) || prv_check_crc(ghandle))
+#else
+#define CRC_OK(ghandle) prv_check_crc(ghandle)
+#endif /* LWGPS_CFG_RUNTIME_MASK */
+
+/**
+ * \brief           Copy temporary memory to user memory
+ * \param[in]       ghandle: GPS handle
+ * \return          `1` on success, `0` otherwise
+ */
+static uint8_t
+prv_copy_from_tmp_memory(lwgps_t* ghandle) {
+#if LWGPS_CFG_TAG
+    if (ghandle->p->tagged) {
+        ghandle->tag = ghandle->tag_p.tag;
+        ghandle->tag.valid = 1;
+    } else {
+        ghandle->tag.valid = 0;
+    }
+#endif /* LWGPS_CFG_TAG */
+    prv_commit_fields(ghandle);
+    if (0) {
+#if LWGPS_CFG_CUSTOM
+    } else if (ghandle->p->stat == STAT_CUSTOM) {
+        if (ghandle->p->custom->commit_fn != NULL) {
+            ghandle->p->custom->commit_fn(ghandle, ghandle->p->custom);
+        }
+#endif /* LWGPS_CFG_CUSTOM */
+#if LWGPS_CFG_AIS
+    } else if (ghandle->p->stat == STAT_AIS) {
+        if (prv_ais_commit(ghandle)) {
+            FIELDS_MARK(ghandle, LWGPS_FIELD_AIS, LWGPS_FIELD_AIS);
+        } else {
+            ghandle->p->stat = STAT_UNKNOWN; /* Incomplete or unsupported message */
+        }
+#endif /* LWGPS_CFG_AIS */
+    }
+    return 1;
+}
+
+#if LWGPS_HAS_TIME && (LWGPS_CFG_ODOMETER || LWGPS_CFG_REPORT_FILTER || LWGPS_CFG_HISTORY)
+/**
+ * \brief           Get UTC time of last committed statement
+ * \param[in]       ghandle: GPS handle
+ * \return          Time in units of seconds of day
+ */
+static uint32_t
+prv_time_of_day(lwgps_t* ghandle) {
+    return (uint32_t)ghandle->hours * 3600U + (uint32_t)ghandle->minutes * 60U + (uint32_t)ghandle->seconds;
+}
+#endif /* LWGPS_HAS_TIME && (LWGPS_CFG_ODOMETER || LWGPS_CFG_REPORT_FILTER || LWGPS_CFG_HISTORY) */
+
+#if LWGPS_CFG_ODOMETER
+
+/**
+ * \brief           Update odometer after statement has been copied to user memory
+ * \param[in]       ghandle: GPS handle
+ * \param[in]       stat: Committed statement
+ */
+static void
+prv_odometer_update(lwgps_t* ghandle, lwgps_statement_t stat) {
+    lwgps_odometer_t* odo = &ghandle->odo;
+    lwgps_float_t dist = 0, y, t;
+    uint32_t now;
+
+    if (STAT_HAS_POS(stat) && ghandle->fix > 0) {
+        now = prv_time_of_day(ghandle);
+        if (odo->has_ref) {
+            lwgps_distance_bearing(odo->latitude, odo->longitude, ghandle->latitude, ghandle->longitude, &dist, NULL);
+        }
+
+        /* Movements below threshold are jitter of stationary receiver, keep old reference */
+        if (!odo->has_ref || dist >= FLT(LWGPS_CFG_ODOMETER_STATIONARY_DIST)) {
+            if (odo->has_ref) {
+                /* Compensated (Kahan) summation, to not lose small steps once total distance gets large */
+                y = dist - odo->comp;
+                t = odo->distance + y;
+                odo->comp = (t - odo->distance) - y;
+                odo->distance = t;
+                odo->moving_time += TIME_DIFF(now, odo->time);
+            }
+            odo->latitude = ghandle->latitude;
+            odo->longitude = ghandle->longitude;
+            odo->time = now; /* Slow movement is credited at once, when reference finally moves */
+            odo->has_ref = 1;
+        }
+    }
+#if LWGPS_CFG_STATEMENT_GPRMC
+    if (STAT_HAS_VEL(stat) && ghandle->is_valid && ghandle->speed > odo->max_speed) {
+        odo->max_speed = ghandle->speed;
+    }
+#endif /* LWGPS_CFG_STATEMENT_GPRMC */
+}
+#endif /* LWGPS_CFG_ODOMETER */
+
+#if (LWGPS_CFG_REPORT_FILTER && LWGPS_CFG_STATEMENT_GPGGA) || LWGPS_CFG_HISTORY
+/**
+ * \brief           Calculate offset between `2` close coordinates
+ *
+ *                  Equirectangular approximation is used, which is accurate for short distances
+ *                  and much cheaper than \ref lwgps_distance_bearing
+ * \param[in]       las: Latitude start coordinate, in units of degrees
+ * \param[in]       los: Longitude start coordinate, in units of degrees
+ * \param[in]       lae: Latitude end coordinate, in units of degrees
+ * \param[in]       loe: Longitude end coordinate, in units of degrees
+ * \param[out]      n: Pointer to output offset towards north in units of meters
+ * \param[out]      e: Pointer to output offset towards east in units of meters
+ */
+static void
+prv_local_offset(lwgps_float_t las, lwgps_float_t los, lwgps_float_t lae, lwgps_float_t loe, lwgps_float_t* n,
+                 lwgps_float_t* e) {
+    lwgps_float_t dlon = loe - los;
+
+    if (dlon > FLT(180)) { /* Take shorter way around antimeridian */
+        dlon -= FLT(360);
+    } else if (dlon < FLT(-180)) {
+        dlon += FLT(360);
+    }
+    *e = D2R(dlon) * FLT_COS(D2R((las + lae) * FLT(0.5))) * EARTH_RADIUS * FLT(1000);
+    *n = D2R(lae - las) * EARTH_RADIUS * FLT(1000);
+}
+#endif /* (LWGPS_CFG_REPORT_FILTER && LWGPS_CFG_STATEMENT_GPGGA) || LWGPS_CFG_HISTORY */
+
+#if LWGPS_CFG_REPORT_FILTER
+#if LWGPS_CFG_STATEMENT_GPGGA
+/**
+ * \brief           Calculate squared distance between `2` close coordinates
+ *
+ *                  Squared value is compared against squared threshold, so no square root is needed
+ * \param[in]       las: Latitude start coordinate, in units of degrees
+ * \param[in]       los: Longitude start coordinate, in units of degrees
+ * \param[in]       lae: Latitude end coordinate, in units of degrees
+ * \param[in]       loe: Longitude end coordinate, in units of degrees
+ * \return          Squared distance in units of meters^2
+ */
+static lwgps_float_t
+prv_distance_sq_fast(lwgps_float_t las, lwgps_float_t los, lwgps_float_t lae, lwgps_float_t loe) {
+    lwgps_float_t n, e;
+
+    prv_local_offset(las, los, lae, loe, &n, &e);
+    return n * n + e * e;
+}
+#endif /* LWGPS_CFG_STATEMENT_GPGGA */
+
+/**
+ * \brief           Check if committed statement shall be reported to application
+ * \param[in]       ghandle: GPS handle
+ * \param[in]       stat: Committed statement
+ * \return          `1` if statement shall be reported, `0` otherwise
+ */
+static uint8_t
+prv_report_check(lwgps_t* ghandle, lwgps_statement_t stat) {
+    const lwgps_report_filter_t* cfg = &ghandle->filt.cfg;
+    uint8_t report = 0, pos, vel;
+    uint32_t now = 0;
+
+    pos = STAT_HAS_POS(stat) && (cfg->distance > 0 || cfg->interval > 0);
+    vel = STAT_HAS_VEL(stat) && (cfg->course > 0 || cfg->speed > 0 || cfg->interval > 0);
+    if (!pos && !vel) {
+        return 1; /* None of enabled criteria applies to the statement */
+    }
+#if LWGPS_HAS_TIME
+    now = prv_time_of_day(ghandle);
+#endif /* LWGPS_HAS_TIME */
+
+#if LWGPS_CFG_STATEMENT_GPGGA
+    if (pos) {
+        if (!ghandle->filt.has_pos || (cfg->interval > 0 && TIME_DIFF(now, ghandle->filt.pos_time) >= cfg->interval)
+            || (cfg->distance > 0
+                && prv_distance_sq_fast(ghandle->filt.latitude, ghandle->filt.longitude, ghandle->latitude,
+                                        ghandle->longitude)
+                       >= cfg->distance * cfg->distance)) {
+            ghandle->filt.latitude = ghandle->latitude;
+            ghandle->filt.longitude = ghandle->longitude;
+            ghandle->filt.pos_time = now;
+            ghandle->filt.has_pos = 1;
+            report = 1;
+        }
+    }
+#endif /* LWGPS_CFG_STATEMENT_GPGGA */
+#if LWGPS_CFG_STATEMENT_GPRMC
+    if (vel) {
+        lwgps_float_t dc = ghandle->course - ghandle->filt.course;
+        lwgps_float_t ds = ghandle->speed - ghandle->filt.speed;
+
+        dc = dc < 0 ? -dc : dc;
+        dc = dc > FLT(180) ? FLT(360) - dc : dc; /* Course wraps at north */
+        ds = ds < 0 ? -ds : ds;
+        if (!ghandle->filt.has_vel || (cfg->interval > 0 && TIME_DIFF(now, ghandle->filt.vel_time) >= cfg->interval)
+            || (cfg->course > 0 && dc >= cfg->course) || (cfg->speed > 0 && ds >= cfg->speed)) {
+            ghandle->filt.course = ghandle->course;
+            ghandle->filt.speed = ghandle->speed;
+            ghandle->filt.vel_time = now;
+            ghandle->filt.has_vel = 1;
+            report = 1;
+        }
+    }
+#endif /* LWGPS_CFG_STATEMENT_GPRMC */
+    (void)now;
+    return report;
+}
+#else
+#define prv_report_check(ghandle, stat) (1)
+#endif /* LWGPS_CFG_REPORT_FILTER */
+
+#if LWGPS_CFG_HISTORY
+/**
+ * \brief           Store committed fix to the history ring buffer
+ * \param[in]       ghandle: GPS handle
+ * \param[in]       stat: Committed statement
+ */
+static void
+prv_history_add(lwgps_t* ghandle, lwgps_statement_t stat) {
+    lwgps_fix_t* fix;
+
+    if (!STAT_HAS_POS(stat) || ghandle->fix == 0) {
+        return;
+    }
+    fix = &ghandle->hist.fix[ghandle->hist.head];
+    fix->latitude = ghandle->latitude;
+    fix->longitude = ghandle->longitude;
+    fix->altitude = ghandle->altitude;
+#if LWGPS_CFG_STATEMENT_GPRMC
+    fix->speed = ghandle->speed;
+    fix->course = ghandle->course;
+#else  /* LWGPS_CFG_STATEMENT_GPRMC */
+    fix->speed = 0;
+    fix->course = 0;
+#endif /* !LWGPS_CFG_STATEMENT_GPRMC */
+    fix->time = prv_time_of_day(ghandle);
+
+    ghandle->hist.head = (uint16_t)((ghandle->hist.head + 1U) % LWGPS_CFG_HISTORY_LEN);
+    if (ghandle->hist.count < LWGPS_CFG_HISTORY_LEN) {
+        ++ghandle->hist.count;
+    }
+}
+#endif /* LWGPS_CFG_HISTORY */
+
+/**
+ * \brief           Update features built on top of user data, after statement has been committed
+ * \param[in]       ghandle: GPS handle
+ * \param[in]       stat: Committed statement
+ */
+static void
+prv_post_commit(lwgps_t* ghandle, lwgps_statement_t stat) {
+#if LWGPS_CFG_ODOMETER
+    prv_odometer_update(ghandle, stat);
+#endif /* LWGPS_CFG_ODOMETER */
+#if LWGPS_CFG_HISTORY
+    prv_history_add(ghandle, stat);
+#endif /* LWGPS_CFG_HISTORY */
+    (void)ghandle;
+    (void)stat;
+}
+
+#if LWGPS_CFG_UBX || LWGPS_CFG_DEMUX
+
+#define UBX_SYNC_1  0xB5 /*!< First UBX sync character */
+#define UBX_SYNC_2  0x62 /*!< Second UBX sync character */
+#define UBX_HDR_LEN 6    /*!< Sync, class, ID and length */
+#define UBX_CRC_LEN 2    /*!< Checksum length */
+
+/**
+ * \brief           Calculate UBX 8-bit Fletcher checksum
+ * \param[in]       d: Data to calculate checksum for, starting with message class
+ * \param[in]       len: Length of data in units of bytes
+ * \return          Checksum, `CK_A` in lower and `CK_B` in upper byte
+ */
+static uint16_t
+prv_ubx_checksum(const uint8_t* d, size_t len) {
+    uint8_t ck_a = 0, ck_b = 0;
+
+    for (; len > 0; ++d, --len) {
+        ck_a += *d;
+        ck_b += ck_a;
+    }
+    return (uint16_t)(ck_a | ((uint16_t)ck_b << 8));
+}
+
+#endif /* LWGPS_CFG_UBX || LWGPS_CFG_DEMUX */
+
+#if LWGPS_CFG_UBX
+
+#define UBX_CLASS_NAV       0x01 /*!< NAV message class */
+#define UBX_ID_NAV_PVT      0x07 /*!< NAV-PVT message ID */
+#define UBX_ID_NAV_TIMEUTC  0x21 /*!< NAV-TIMEUTC message ID */
+#define UBX_ID_NAV_SAT      0x35 /*!< NAV-SAT message ID */
+#define UBX_LEN_NAV_PVT     92   /*!< NAV-PVT payload length */
+#define UBX_LEN_NAV_TIMEUTC 20   /*!< NAV-TIMEUTC payload length */
+#define UBX_LEN_NAV_SAT_HDR 8    /*!< NAV-SAT payload length without satellites */
+#define UBX_LEN_NAV_SAT_SV  12   /*!< NAV-SAT length of each satellite block */
+
+/**
+ * \brief           Decode NAV-PVT payload directly to user memory
+ * \param[in]       ghandle: GPS handle
+ * \param[in]       pl: Payload of the message
+ */
+static void
+prv_ubx_nav_pvt(lwgps_t* ghandle, const uint8_t* pl) {
+    uint8_t valid = UBX_U1(pl, 11), fix_type = UBX_U1(pl, 20), flags = UBX_U1(pl, 21);
+    uint8_t fix_ok = (flags & 0x01) && fix_type >= 2 && fix_type <= 4;
+    uint32_t updated = 0;
+
+#if LWGPS_HAS_TIME
+    if (valid & 0x02) { /* validTime */
+        ghandle->hours = UBX_U1(pl, 8);
+        ghandle->minutes = UBX_U1(pl, 9);
+        ghandle->seconds = UBX_U1(pl, 10);
+        updated |= LWGPS_FIELD_TIME;
+    }
+#endif /* LWGPS_HAS_TIME */
+#if LWGPS_CFG_STATEMENT_GPRMC || LWGPS_CFG_STATEMENT_PUBX_TIME
+    if (valid & 0x01) { /* validDate */
+        ghandle->date = UBX_U1(pl, 7);
+        ghandle->month = UBX_U1(pl, 6);
+        ghandle->year = (uint8_t)(UBX_U2(pl, 4) % 100U);
+        updated |= LWGPS_FIELD_DATE;
+    }
+#endif /* LWGPS_CFG_STATEMENT_GPRMC || LWGPS_CFG_STATEMENT_PUBX_TIME */
+#if LWGPS_CFG_STATEMENT_GPGGA
+    ghandle->longitude = FLT(UBX_I4(pl, 24)) * FLT(1e-7);
+    ghandle->latitude = FLT(UBX_I4(pl, 28)) * FLT(1e-7);
+    ghandle->altitude = FLT(UBX_I4(pl, 36)) * FLT(1e-3);                 /* Height above mean sea level */
+    ghandle->geo_sep = FLT(UBX_I4(pl, 32) - UBX_I4(pl, 36)) * FLT(1e-3); /* Ellipsoid minus MSL height */
+    ghandle->sats_in_use = UBX_U1(pl, 23);
+    ghandle->fix = fix_ok ? ((flags & 0x02) ? 2 : 1) : 0; /* diffSoln means DGPS fix */
+    updated |= LWGPS_FIELD_LATITUDE | LWGPS_FIELD_LONGITUDE | LWGPS_FIELD_ALTITUDE | LWGPS_FIELD_GEO_SEP
+               | LWGPS_FIELD_SATS_IN_USE | LWGPS_FIELD_FIX;
+#endif /* LWGPS_CFG_STATEMENT_GPGGA */
+#if LWGPS_CFG_STATEMENT_GPGSA
+    ghandle->fix_mode = fix_type == 2 ? 2 : (fix_type == 3 || fix_type == 4 ? 3 : 1);
+    ghandle->dop_p = FLT(UBX_U2(pl, 76)) * FLT(0.01);
+    updated |= LWGPS_FIELD_FIX_MODE | LWGPS_FIELD_DOP_P;
+#endif /* LWGPS_CFG_STATEMENT_GPGSA */
+#if LWGPS_CFG_STATEMENT_GPRMC
+    ghandle->is_valid = fix_ok;
+    ghandle->speed = FLT(UBX_I4(pl, 60)) * FLT(1e-3) * FLT(1.943844); /* mm/s to knots */
+    ghandle->course = FLT(UBX_I4(pl, 64)) * FLT(1e-5);
+    updated |= LWGPS_FIELD_IS_VALID | LWGPS_FIELD_SPEED | LWGPS_FIELD_COURSE;
+    if (valid & 0x08) { /* validMag */
+        ghandle->variation = FLT(UBX_I2(pl, 88)) * FLT(0.01);
+        updated |= LWGPS_FIELD_VARIATION;
+    }
+#endif /* LWGPS_CFG_STATEMENT_GPRMC */
+    FIELDS_MARK(ghandle, updated, updated);
+    (void)ghandle;
+    (void)valid;
+    (void)fix_ok;
+}
+
+#if LWGPS_CFG_STATEMENT_GPGSV
+/**
+ * \brief           Decode NAV-SAT payload directly to user memory
+ * \param[in]       ghandle: GPS handle
+ * \param[in]       pl: Payload of the message
+ * \param[in]       num: Number of satellites in the payload
+ */
+static void
+prv_ubx_nav_sat(lwgps_t* ghandle, const uint8_t* pl, uint8_t num) {
+#if LWGPS_CFG_STATEMENT_GPGSV_SAT_DET
+    const uint8_t* sv;
+    size_t i;
+#endif /* LWGPS_CFG_STATEMENT_GPGSV_SAT_DET */
+
+    ghandle->sats_in_view = num;
+#if LWGPS_CFG_STATEMENT_GPGSV_SAT_DET
+    for (i = 0; i < sizeof(ghandle->sats_in_view_desc) / sizeof(ghandle->sats_in_view_desc[0]); ++i) {
+        sv = &pl[UBX_LEN_NAV_SAT_HDR + i * UBX_LEN_NAV_SAT_SV];
+        if (i < num) {
+            ghandle->sats_in_view_desc[i].num = UBX_U1(sv, 1);
+            ghandle->sats_in_view_desc[i].snr = UBX_U1(sv, 2);
+            ghandle->sats_in_view_desc[i].elevation = (uint8_t)UBX_I1(sv, 3);
+            ghandle->sats_in_view_desc[i].azimuth = (uint16_t)UBX_I2(sv, 4);
+        } else {
+            LWGPS_MEMSET(&ghandle->sats_in_view_desc[i], 0x00, sizeof(ghandle->sats_in_view_desc[i]));
+        }
+    }
+    FIELDS_MARK(ghandle, LWGPS_FIELD_SATS_IN_VIEW | LWGPS_FIELD_SATS_IN_VIEW_DESC,
+                LWGPS_FIELD_SATS_IN_VIEW | LWGPS_FIELD_SATS_IN_VIEW_DESC);
+#else
+    FIELDS_MARK(ghandle, LWGPS_FIELD_SATS_IN_VIEW, LWGPS_FIELD_SATS_IN_VIEW);
+    (void)pl;
+#endif /* LWGPS_CFG_STATEMENT_GPGSV_SAT_DET */
+}
+#endif /* LWGPS_CFG_STATEMENT_GPGSV */
+
+/**
+ * \brief           Decode NAV-TIMEUTC payload directly to user memory
+ * \param[in]       ghandle: GPS handle
+ * \param[in]       pl: Payload of the message
+ */
+static void
+prv_ubx_nav_timeutc(lwgps_t* ghandle, const uint8_t* pl) {
+    if (!(UBX_U1(pl, 19) & 0x04)) { /* validUTC */
+        return;
+    }
+#if LWGPS_HAS_TIME
+    ghandle->hours = UBX_U1(pl, 16);
+    ghandle->minutes = UBX_U1(pl, 17);
+    ghandle->seconds = UBX_U1(pl, 18);
+#endif /* LWGPS_HAS_TIME */
+#if LWGPS_CFG_STATEMENT_GPRMC || LWGPS_CFG_STATEMENT_PUBX_TIME
+    ghandle->date = UBX_U1(pl, 15);
+    ghandle->month = UBX_U1(pl, 14);
+    ghandle->year = (uint8_t)(UBX_U2(pl, 12) % 100U);
+#endif /* LWGPS_CFG_STATEMENT_GPRMC || LWGPS_CFG_STATEMENT_PUBX_TIME */
+    FIELDS_MARK(ghandle, LWGPS_FIELD_TIME | LWGPS_FIELD_DATE, LWGPS_FIELD_TIME | LWGPS_FIELD_DATE);
+    (void)ghandle;
+}
+
+/**
+ * \brief           Validate UBX frame and decode supported message to user memory
+ * \param[in]       ghandle: GPS handle
+ * \param[in]       d: Frame, starting with sync characters
+ * \param[in]       len: Frame length in units of bytes
+ * \param[out]      stat: Pointer to output decoded statement, \ref STAT_UNKNOWN for unsupported messages
+ * \return          `1` when frame is valid, `0` otherwise
+ */
+static uint8_t
+prv_ubx_decode(lwgps_t* ghandle, const uint8_t* d, size_t len, lwgps_statement_t* stat) {
+    const uint8_t* pl = &d[UBX_HDR_LEN];
+    uint16_t pl_len;
+
+    *stat = STAT_UNKNOWN;
+    if (len < UBX_HDR_LEN + UBX_CRC_LEN || d[0] != UBX_SYNC_1 || d[1] != UBX_SYNC_2) {
+        return 0;
+    }
+    pl_len = UBX_U2(d, 4);
+    if (len < (size_t)UBX_HDR_LEN + pl_len + UBX_CRC_LEN
+        || prv_ubx_checksum(&d[2], (size_t)pl_len + 4) != UBX_U2(d, UBX_HDR_LEN + pl_len)) {
+        *stat = STAT_CHECKSUM_FAIL;
+        return 0;
+    }
+
+    /* Payload is decoded in place, at fixed offsets */
+    if (d[2] == UBX_CLASS_NAV) {
+        if (d[3] == UBX_ID_NAV_PVT && pl_len >= UBX_LEN_NAV_PVT) {
+            prv_ubx_nav_pvt(ghandle, pl);
+            *stat = STAT_UBX_NAV_PVT;
+#if LWGPS_CFG_STATEMENT_GPGSV
+        } else if (d[3] == UBX_ID_NAV_SAT && pl_len >= UBX_LEN_NAV_SAT_HDR
+                   && pl_len >= UBX_LEN_NAV_SAT_HDR + UBX_LEN_NAV_SAT_SV * (size_t)UBX_U1(pl, 5)) {
+            prv_ubx_nav_sat(ghandle, pl, UBX_U1(pl, 5));
+            *stat = STAT_UBX_NAV_SAT;
+#endif /* LWGPS_CFG_STATEMENT_GPGSV */
+        } else if (d[3] == UBX_ID_NAV_TIMEUTC && pl_len >= UBX_LEN_NAV_TIMEUTC) {
+            prv_ubx_nav_timeutc(ghandle, pl);
+            *stat = STAT_UBX_NAV_TIMEUTC;
+        }
+    }
+    return 1;
+}
+
+#endif /* LWGPS_CFG_UBX */
+
+/**
+ * \brief           Init GPS handle
+ * \param[in]       ghandle: GPS handle structure
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+lwgps_init(lwgps_t* ghandle) {
+    LWGPS_MEMSET(ghandle, 0x00, sizeof(*ghandle)); /* Reset structure */
+    return 1;
+}
+
+#if LWGPS_CFG_COMPACT || __DOXYGEN__
+
+/**
+ * \brief           Attach parser scratch state to GPS handle
+ *
+ *                  Scratch state must be attached after \ref lwgps_init, before data are processed,
+ *                  and stay valid while handle is used. Each handle needs its own scratch state,
+ *                  which can be kept in separate array, away from fix data of the handles
+ *
+ * \param[in]       ghandle: GPS handle
+ * \param[in]       scratch: Scratch state memory
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+lwgps_set_scratch(lwgps_t* ghandle, lwgps_scratch_t* scratch) {
+    if (ghandle == NULL || scratch == NULL) {
+        return 0;
+    }
+    LWGPS_MEMSET(scratch, 0x00, sizeof(*scratch));
+    ghandle->p = scratch;
+    return 1;
+}
+
+#endif /* LWGPS_CFG_COMPACT || __DOXYGEN__ */
+
+#if LWGPS_CFG_LATENCY
+
+/**
+ * \brief           Get histogram bin of duration
+ * \param[in]       ticks: Duration in units of ticks
+ * \return          Bin index
+ */
+static uint8_t
+prv_latency_bin(uint32_t ticks) {
+    uint8_t bin = 0;
+
+    while (ticks > 0 && bin < LWGPS_CFG_LATENCY_BINS - 1) {
+        ticks >>= 1;
+        ++bin;
+    }
+    return bin;
+}
+
+/**
+ * \brief           Record timings of committed sentence
+ * \param[in]       ghandle: GPS handle
+ * \param[in]       t_end: Tick of end of line
+ */
+static void
+prv_latency_add(lwgps_t* ghandle, uint32_t t_end) {
+    lwgps_latency_t* lat = &ghandle->lat;
+
+    if (ghandle->p->stat == STAT_UNKNOWN) {
+        return; /* Ignored sentences are not traced */
+    }
+    lat->start = ghandle->p->t_start;
+    lat->end = t_end;
+    lat->commit = LWGPS_CFG_LATENCY_GET_TICK();
+    ++lat->line_hist[prv_latency_bin(lat->end - lat->start)];
+    ++lat->parse_hist[prv_latency_bin(lat->commit - lat->end)];
+    ++lat->total_hist[prv_latency_bin(lat->commit - lat->start)];
+}
+
+#endif /* LWGPS_CFG_LATENCY */
+
+#define BUDGET_POLL_LEN 82 /*!< Maximal NMEA sentence length, deadline is polled at least that often within line */
+
+/**
+ * \brief           Check if processing budget is spent
+ * \param[in]       budget: Processing budget
+ * \param[in]       lines: Number of lines processed so far
+ * \param[in]       bytes: Number of bytes processed so far
+ * \return          `1` when processing shall stop, `0` otherwise
+ */
+static uint8_t
+prv_budget_spent(const lwgps_budget_t* budget, size_t lines, size_t bytes) {
+    return (budget->max_sentences > 0 && lines >= budget->max_sentences)
+           || (budget->max_bytes > 0 && bytes >= budget->max_bytes)
+           || (budget->expired_fn != NULL && budget->expired_fn(budget->arg));
+}
+
+/**
+ * \brief           Check if processing shall stop before next character
+ *
+ *                  Full budget is checked at the end of the line and at the start of new sentence.
+ *                  Inside the line, byte limit is hard and deadline is polled every \ref BUDGET_POLL_LEN bytes,
+ *                  so that input without line end cannot exceed the budget
+ *
+ * \param[in]       budget: Processing budget
+ * \param[in]       d: Pointer to next character, must not be the first one
+ * \param[in,out]   lines: Number of lines processed so far
+ * \param[in]       bytes: Number of bytes processed so far
+ * \param[in,out]   poll: Number of bytes since last full budget check
+ * \return          `1` when processing shall stop, `0` otherwise
+ */
+static uint8_t
+prv_budget_stop(const lwgps_budget_t* budget, const uint8_t* d, size_t* lines, size_t bytes, size_t* poll) {
+    if (d[-1] == '\n' || *d == '$' || LWGPS_IS_AIS_START(*d)) {
+        *poll = 0;
+        return prv_budget_spent(budget, ++(*lines), bytes);
+    } else if (++(*poll) >= BUDGET_POLL_LEN) {
+        *poll = 0;
+        return prv_budget_spent(budget, *lines, bytes);
+    }
+    return budget->max_bytes > 0 && bytes >= budget->max_bytes;
+}
+
+/**
+ * \brief           Process NMEA data, until data or budget runs out
+ * \param[in]       ghandle: GPS handle structure
+ * \param[in]       data: Received data
+ * \param[in]       len: Number of bytes to process
+ * \param[in]       budget: Processing budget, see \ref prv_budget_stop.
+ *                      Set to `NULL` to process all data
+ * \param[in]       evt_fn: Event function to notify application layer
+ * \return          Number of processed bytes
+ */
+static size_t
+prv_process(lwgps_t* ghandle, const void* data, size_t len, const lwgps_budget_t* budget, lwgps_process_fn evt_fn) {
+    const uint8_t *d = data, *start = data;
+    size_t lines = 0, poll = 0;
+#if LWGPS_CFG_LATENCY
+    uint32_t t_end;
+#endif /* LWGPS_CFG_LATENCY */
+
+    if (!SCRATCH_READY(ghandle)) {
+        return 0;
+    }
+    for (; len > 0; ++d, --len) { /* Process all bytes */
+        if (budget != NULL && d > start && prv_budget_stop(budget, d, &lines, (size_t)(d - start), &poll)) {
+            break; /* Stop at line boundary or at hard limit */
+        }
+#if LWGPS_CFG_TAG
+        if (ghandle->tag_p.active) {
+            if (*d != '$' && !LWGPS_IS_AIS_START(*d) && *d != '\r' && *d != '\n') {
+                prv_tag_add(&ghandle->tag_p, *d);
+                continue;
+            }
+            ghandle->tag_p.active = 0; /* Unterminated TAG block is dropped */
+        }
+        if (*d == '\\') { /* Beginning of TAG block */
+            prv_tag_start(&ghandle->tag_p);
+            continue;
+        }
+#endif                                                           /* LWGPS_CFG_TAG */
+        if (*d == '$' || LWGPS_IS_AIS_START(*d)) {               /* Check for beginning of NMEA line */
+            SENTENCE_RESET(ghandle);                             /* Reset private memory */
+#if LWGPS_CFG_LATENCY
+            ghandle->p->t_start = LWGPS_CFG_LATENCY_GET_TICK();
+#endif /* LWGPS_CFG_LATENCY */
+#if LWGPS_CFG_TAG
+            ghandle->p->tagged = ghandle->tag_p.tag.valid; /* TAG block belongs to this sentence only */
+            ghandle->tag_p.tag.valid = 0;
+#endif                             /* LWGPS_CFG_TAG */
+            TERM_ADD(ghandle, *d); /* Add character to term */
+        } else if (*d == ',') {                                  /* Term separator character */
+            prv_parse_term(ghandle);                             /* Parse term we have currently in memory */
+            CRC_ADD(ghandle, *d);                                /* Add character to CRC computation */
+            TERM_NEXT(ghandle);                                  /* Start with next term */
+        } else if (*d == '*') {                                  /* Start indicates end of data for CRC computation */
+            prv_parse_term(ghandle);                             /* Parse term we have currently in memory */
+            ghandle->p->star = 1;                                 /* STAR detected */
+            TERM_NEXT(ghandle);                                  /* Start with next term */
+        } else if (*d == '\r') {
+#if LWGPS_CFG_LATENCY
+            t_end = LWGPS_CFG_LATENCY_GET_TICK();
+#endif                                    /* LWGPS_CFG_LATENCY */
+            if (CRC_OK(ghandle)) {        /* Check for CRC result */
+                /* CRC is OK, in theory we can copy data from statements to user data */
+                prv_copy_from_tmp_memory(ghandle); /* Copy memory from temporary to user memory */
+                prv_post_commit(ghandle, ghandle->p->stat);
+#if LWGPS_CFG_LATENCY
+                prv_latency_add(ghandle, t_end);
+#endif /* LWGPS_CFG_LATENCY */
+#if LWGPS_CFG_STATUS
+                if (evt_fn != NULL && prv_report_check(ghandle, ghandle->p->stat)) {
+                    evt_fn(ghandle->p->stat);
+                }
+            } else if (evt_fn != NULL) {
+                evt_fn(STAT_CHECKSUM_FAIL);
+#endif /* LWGPS_CFG_STATUS */
+            }
+        } else {
+            if (!ghandle->p->star) {   /* Add to CRC only if star not yet detected */
+                CRC_ADD(ghandle, *d); /* Add to CRC */
+            }
+#if LWGPS_CFG_AIS
+            if (ghandle->p->stat == STAT_AIS && ghandle->p->term_num == 5) {
+                prv_ais_add_char(ghandle, *d); /* Payload is decoded on the fly, not stored to term */
+                continue;
+            }
+#endif                             /* LWGPS_CFG_AIS */
+            TERM_ADD(ghandle, *d); /* Add character to term */
+        }
+    }
+    (void)evt_fn;
+    return (size_t)(d - start);
+}
+
+/**
+ * \brief           Process NMEA data from GPS receiver
+ * \param[in]       ghandle: GPS handle structure
+ * \param[in]       data: Received data
+ * \param[in]       len: Number of bytes to process
+ * \param[in]       evt_fn: Event function to notify application layer.
+ *                      This parameter is available only if \ref LWGPS_CFG_STATUS is enabled
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+#if LWGPS_CFG_STATUS || __DOXYGEN__
+lwgps_process(lwgps_t* ghandle, const void* data, size_t len, lwgps_process_fn evt_fn) {
+    prv_process(ghandle, data, len, NULL, evt_fn);
+#else  /* LWGPS_CFG_STATUS */
+lwgps_process(lwgps_t* ghandle, const void* data, size_t len) {
+    prv_process(ghandle, data, len, NULL, NULL);
+#endif /* !LWGPS_CFG_STATUS */
+    return SCRATCH_READY(ghandle);
+}
+
+/**
+ * \brief           Process NMEA data with limited budget
+ *
+ *                  Processing stops at the end of the line or at the start of next sentence,
+ *                  where any of budget limits is reached, to bound time spent in single call.
+ *                  Byte limit and deadline are hard limits: input without line end, such as line noise,
+ *                  is cut inside the line, once byte limit is reached or deadline expires.
+ *                  Remaining data shall be passed to next call, parser state is kept in the handle
+ *
+ * \param[in]       ghandle: GPS handle structure
+ * \param[in]       data: Received data
+ * \param[in]       len: Number of bytes to process
+ * \param[in]       budget: Processing budget
+ * \param[in]       evt_fn: Event function to notify application layer.
+ *                      This parameter is available only if \ref LWGPS_CFG_STATUS is enabled
+ * \return          Number of processed bytes, equal to `len` when all data has been processed
+ */
+size_t
+#if LWGPS_CFG_STATUS || __DOXYGEN__
+lwgps_process_budget(lwgps_t* ghandle, const void* data, size_t len, const lwgps_budget_t* budget,
+                     lwgps_process_fn evt_fn) {
+    return prv_process(ghandle, data, len, budget, evt_fn);
+#else  /* LWGPS_CFG_STATUS */
+lwgps_process_budget(lwgps_t* ghandle, const void* data, size_t len, const lwgps_budget_t* budget) {
+    return prv_process(ghandle, data, len, budget, NULL);
+#endif /* !LWGPS_CFG_STATUS */
+}
+
+/**
+ * \brief           Process NMEA data, scattered over multiple memory segments
+ *
+ *                  Segments are processed in order, as single contiguous stream.
+ *                  Use it to parse both linear regions of ring buffer or chain of DMA blocks in place
+ *
+ * \param[in]       ghandle: GPS handle structure
+ * \param[in]       iov: Array of data segments
+ * \param[in]       iovcnt: Number of entries in `iov` array
+ * \param[in]       evt_fn: Event function to notify application layer.
+ *                      This parameter is available only if \ref LWGPS_CFG_STATUS is enabled
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+#if LWGPS_CFG_STATUS || __DOXYGEN__
+lwgps_processv(lwgps_t* ghandle, const lwgps_iovec_t* iov, size_t iovcnt, lwgps_process_fn evt_fn) {
+#else  /* LWGPS_CFG_STATUS */
+lwgps_processv(lwgps_t* ghandle, const lwgps_iovec_t* iov, size_t iovcnt) {
+#endif /* !LWGPS_CFG_STATUS */
+    if (!SCRATCH_READY(ghandle)) {
+        return 0;
+    }
+    for (; iovcnt > 0; ++iov, --iovcnt) {
+        if (iov->len == 0) {
+            continue;
+        }
+#if LWGPS_CFG_STATUS
+        if (!lwgps_process(ghandle, iov->data, iov->len, evt_fn)) {
+#else  /* LWGPS_CFG_STATUS */
+        if (!lwgps_process(ghandle, iov->data, iov->len)) {
+#endif /* !LWGPS_CFG_STATUS */
+            return 0;
+        }
+    }
+    return 1;
+}
+
+#if LWGPS_CFG_FIELD_MASK || __DOXYGEN__
+
+/**
+ * \brief           Get fields updated since last call and acknowledge them
+ *
+ *                  Update bits are read and cleared with single atomic operation,
+ *                  when \ref LWGPS_ATOMIC_XCHG_U32 is available.
+ *                  Check \ref lwgps_t.fields_present to find out which of them carry received value
+ *
+ * \param[in]       ghandle: GPS handle
+ * \return          Bitmask of updated fields, bits of \ref lwgps_field_t
+ */
+uint32_t
+lwgps_fields_ack(lwgps_t* ghandle) {
+#if defined(LWGPS_ATOMIC_XCHG_U32)
+    return LWGPS_ATOMIC_XCHG_U32(&ghandle->fields_updated, 0);
+#else
+    uint32_t updated = ghandle->fields_updated;
+
+    ghandle->fields_updated = 0;
+    return updated;
+#endif /* defined(LWGPS_ATOMIC_XCHG_U32) */
+}
+
+#endif /* LWGPS_CFG_FIELD_MASK || __DOXYGEN__ */
+
+#if LWGPS_CFG_TAG || __DOXYGEN__
+
+/**
+ * \brief           Parse TAG block at the beginning of the line
+ *
+ *                  Function can be used ahead of \ref lwgps_process,
+ *                  to route sentences to different GPS handles by their source
+ *
+ * \param[in]       data: Line data, starting with TAG block opening backslash
+ * \param[in]       len: Length of data in units of bytes
+ * \param[out]      tag: Pointer to output TAG block information
+ * \return          Length of TAG block including both backslashes,
+ *                      `0` when block is not complete or checksum is invalid
+ */
+size_t
+lwgps_tag_parse(const void* data, size_t len, lwgps_tag_t* tag) {
+    lwgps_tag_parser_t tp;
+    const uint8_t* d = data;
+    size_t i;
+
+    if (data == NULL || tag == NULL || len == 0 || d[0] != '\\') {
+        return 0;
+    }
+    prv_tag_start(&tp);
+    for (i = 1; i < len && tp.active; ++i) {
+        prv_tag_add(&tp, d[i]);
+    }
+    if (tp.active || !tp.tag.valid) {
+        return 0;
+    }
+    *tag = tp.tag;
+    return i;
+}
+
+#endif /* LWGPS_CFG_TAG || __DOXYGEN__ */
+
+#if LWGPS_CFG_CUSTOM || __DOXYGEN__
+
+/**
+ * \brief           Register custom statement to GPS handle
+ *
+ *                  Statements not known to the library are looked up by their address
+ *                  and passed field by field to the descriptor decode function.
+ *                  Registration must be done after \ref lwgps_init
+ *
+ * \param[in]       ghandle: GPS handle
+ * \param[in]       desc: Statement descriptor. It must stay valid while GPS handle is in use
+ * \return          `1` on success, `0` when table is full or address is already registered
+ */
+uint8_t
+lwgps_custom_register(lwgps_t* ghandle, const lwgps_custom_t* desc) {
+    uint8_t i, idx;
+
+    if (ghandle == NULL || desc == NULL || desc->addr == NULL || prv_custom_find(ghandle, desc->addr) != NULL) {
+        return 0;
+    }
+    for (idx = 0; idx < LWGPS_CFG_CUSTOM_MAX; ++idx) {
+        if (ghandle->custom[idx] == NULL) {
+            break;
+        }
+    }
+    if (idx == LWGPS_CFG_CUSTOM_MAX) {
+        return 0;
+    }
+    i = prv_custom_hash(desc->addr);
+    while (ghandle->custom_hash[i] > 0) { /* Linear probing */
+        i = (uint8_t)((i + 1) % CUSTOM_HASH_SIZE);
+    }
+    ghandle->custom[idx] = desc;
+    ghandle->custom_hash[i] = (uint8_t)(idx + 1);
+    return 1;
+}
+
+#endif /* LWGPS_CFG_CUSTOM || __DOXYGEN__ */
+
+#if LWGPS_CFG_UBX || __DOXYGEN__
+
+/**
+ * \brief           Process single UBX binary frame from GPS receiver
+ *
+ *                  Frame is validated and supported messages are decoded
+ *                  in place to the same fields as NMEA statements.
+ *                  Data are not copied, frame must start with sync characters.
+ *
+ * \param[in]       ghandle: GPS handle structure
+ * \param[in]       frame: Complete UBX frame, including sync characters and checksum
+ * \param[in]       len: Length of frame in units of bytes
+ * \param[in]       evt_fn: Event function to notify application layer.
+ *                      This parameter is available only if \ref LWGPS_CFG_STATUS is enabled
+ * \return          `1` when frame is valid, `0` otherwise
+ */
+uint8_t
+#if LWGPS_CFG_STATUS || __DOXYGEN__
+lwgps_process_ubx(lwgps_t* ghandle, const void* frame, size_t len, lwgps_process_fn evt_fn) {
+#else  /* LWGPS_CFG_STATUS */
+lwgps_process_ubx(lwgps_t* ghandle, const void* frame, size_t len) {
+#endif /* !LWGPS_CFG_STATUS */
+    lwgps_statement_t stat;
+    uint8_t res;
+
+    if (ghandle == NULL || frame == NULL) {
+        return 0;
+    }
+    res = prv_ubx_decode(ghandle, frame, len, &stat);
+    if (res) {
+        prv_post_commit(ghandle, stat);
+    }
+#if LWGPS_CFG_STATUS
+    if (evt_fn != NULL && (stat == STAT_CHECKSUM_FAIL || (res && prv_report_check(ghandle, stat)))) {
+        evt_fn(stat);
+    }
+#endif /* LWGPS_CFG_STATUS */
+    return res;
+}
+
+#endif /* LWGPS_CFG_UBX || __DOXYGEN__ */
+
+#if LWGPS_CFG_DEMUX || __DOXYGEN__
+
+#define RTCM3_PREAMBLE 0xD3 /*!< RTCM3 frame preamble */
+#define RTCM3_HDR_LEN  3    /*!< Preamble, reserved bits and length */
+#define RTCM3_CRC_LEN  3    /*!< CRC-24Q length */
+
+/* CRC-24Q lookup table, processed one nibble at a time */
+static const uint32_t crc24q_table[16] = {
+    0x000000, 0x864CFB, 0x8AD50D, 0x0C99F6, 0x93E6E1, 0x15AA1A, 0x1933EC, 0x9F7F17,
+    0xA18139, 0x27CDC2, 0x2B5434, 0xAD18CF, 0x3267D8, 0xB42B23, 0xB8B2D5, 0x3EFE2E,
+};
+
+/**
+ * \brief           Calculate RTCM3 CRC-24Q
+ * \param[in]       d: Data to calculate CRC for, starting with preamble
+ * \param[in]       len: Length of data in units of bytes
+ * \return          24-bit CRC
+ */
+static uint32_t
+prv_crc24q(const uint8_t* d, size_t len) {
+    uint32_t crc = 0;
+
+    for (; len > 0; ++d, --len) {
+        crc = ((crc << 4) ^ crc24q_table[((crc >> 20) ^ (*d >> 4)) & 0x0F]) & 0xFFFFFFUL;
+        crc = ((crc << 4) ^ crc24q_table[((crc >> 20) ^ *d) & 0x0F]) & 0xFFFFFFUL;
+    }
+    return crc;
+}
+
+/**
+ * \brief           Check binary frame header and get full frame length
+ * \param[in]       proto: Protocol of the frame
+ * \param[in]       d: Frame data, starting with sync character
+ * \param[in]       len: Number of bytes available
+ * \param[out]      frame_len: Full frame length, set to `0` until header is complete
+ * \return          `1` when header is valid so far, `0` otherwise
+ */
+static uint8_t
+prv_demux_header(lwgps_proto_t proto, const uint8_t* d, size_t len, size_t* frame_len) {
+    *frame_len = 0;
+    if (proto == LWGPS_PROTO_UBX) {
+        if (len > 1 && d[1] != UBX_SYNC_2) {
+            return 0;
+        }
+        if (len >= UBX_HDR_LEN) {
+            *frame_len = (size_t)UBX_HDR_LEN + UBX_U2(d, 4) + UBX_CRC_LEN;
+        }
+    } else {
+        if (len > 1 && (d[1] & 0xFC) != 0) { /* Reserved bits must be zero */
+            return 0;
+        }
+        if (len >= RTCM3_HDR_LEN) {
+            *frame_len = (size_t)RTCM3_HDR_LEN + (((size_t)(d[1] & 0x03) << 8) | d[2]) + RTCM3_CRC_LEN;
+        }
+    }
+    return 1;
+}
+
+/**
+ * \brief           Pass part of NMEA sentence to GPS handle
+ * \param[in]       dh: Demultiplexer handle
+ * \param[in]       d: Sentence data
+ * \param[in]       len: Length of data in units of bytes
+ * \param[in]       evt_fn: Event function to notify application layer
+ */
+static void
+prv_demux_nmea(lwgps_demux_t* dh, const uint8_t* d, size_t len, lwgps_process_fn evt_fn) {
+    if (dh->gps != NULL) {
+#if LWGPS_CFG_STATUS
+        lwgps_process(dh->gps, d, len, evt_fn);
+#else  /* LWGPS_CFG_STATUS */
+        lwgps_process(dh->gps, d, len);
+#endif /* !LWGPS_CFG_STATUS */
+    }
+    (void)evt_fn;
+}
+
+/**
+ * \brief           Validate complete binary frame and pass it to consumers
+ * \param[in]       dh: Demultiplexer handle
+ * \param[in]       d: Complete frame
+ * \param[in]       len: Frame length in units of bytes
+ * \param[in]       evt_fn: Event function to notify application layer
+ * \return          `1` when frame is valid, `0` otherwise
+ */
+static uint8_t
+prv_demux_frame(lwgps_demux_t* dh, const uint8_t* d, size_t len, lwgps_process_fn evt_fn) {
+    uint8_t valid;
+
+    if (dh->proto == LWGPS_PROTO_RTCM3) {
+        valid = prv_crc24q(d, len - RTCM3_CRC_LEN)
+                == (((uint32_t)d[len - 3] << 16) | ((uint32_t)d[len - 2] << 8) | (uint32_t)d[len - 1]);
+#if LWGPS_CFG_UBX
+    } else if (dh->gps != NULL) {
+        /* Decoder validates the frame and notifies application on its own */
+#if LWGPS_CFG_STATUS
+        valid = lwgps_process_ubx(dh->gps, d, len, evt_fn);
+#else  /* LWGPS_CFG_STATUS */
+        valid = lwgps_process_ubx(dh->gps, d, len);
+#endif /* !LWGPS_CFG_STATUS */
+        evt_fn = NULL;
+#endif /* LWGPS_CFG_UBX */
+    } else {
+        valid = prv_ubx_checksum(&d[2], len - UBX_CRC_LEN - 2) == UBX_U2(d, len - UBX_CRC_LEN);
+    }
+    if (!valid) {
+        ++dh->crc_err;
+        if (evt_fn != NULL) {
+            evt_fn(STAT_CHECKSUM_FAIL);
+        }
+    } else if (dh->frame_fn != NULL) {
+        dh->frame_fn(dh, dh->proto, d, len);
+    }
+    return valid;
+}
+
+/**
+ * \brief           Init protocol demultiplexer
+ * \param[in]       dh: Demultiplexer handle
+ * \param[in]       ghandle: GPS handle for NMEA sentences and UBX frames. Set to `NULL` if not used
+ * \param[in]       frame_fn: Callback for validated UBX and RTCM3 frames. Set to `NULL` if not used
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+lwgps_demux_init(lwgps_demux_t* dh, lwgps_t* ghandle, lwgps_frame_fn frame_fn) {
+    if (dh == NULL) {
+        return 0;
+    }
+    LWGPS_MEMSET(dh, 0x00, sizeof(*dh));
+    dh->gps = ghandle;
+    dh->frame_fn = frame_fn;
+    return 1;
+}
+
+/**
+ * \brief           Process raw receiver data with interleaved NMEA, UBX and RTCM3 frames
+ *
+ *                  NMEA bytes are passed to \ref lwgps_process as they arrive,
+ *                  binary frames are validated and passed to UBX decoder and frame callback.
+ *                  Frames fully contained in input data are passed without copy,
+ *                  only frames split across multiple calls are collected to internal buffer.
+ *                  Invalid frame is rescanned from the byte after its sync character,
+ *                  so that false sync character or corrupted length does not drop following NMEA data.
+ *
+ * \param[in]       dh: Demultiplexer handle
+ * \param[in]       data: Received data
+ * \param[in]       len: Number of bytes to process
+ * \param[in]       evt_fn: Event function to notify application layer.
+ *                      This parameter is available only if \ref LWGPS_CFG_STATUS is enabled
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+#if LWGPS_CFG_STATUS || __DOXYGEN__
+lwgps_demux_process(lwgps_demux_t* dh, const void* data, size_t len, lwgps_process_fn evt_fn) {
+#else  /* LWGPS_CFG_STATUS */
+lwgps_demux_process(lwgps_demux_t* dh, const void* data, size_t len) {
+    const lwgps_process_fn evt_fn = NULL;
+#endif /* !LWGPS_CFG_STATUS */
+    const uint8_t *d = data, *nmea = NULL, *ud = NULL;
+    size_t n, ulen = 0;
+
+    if (dh == NULL || (data == NULL && len > 0)) {
+        return 0;
+    }
+    while (len > 0 || ud != NULL) {
+        if (len == 0) { /* Rescan of buffered bytes is done, continue with input data */
+            if (nmea != NULL) {
+                prv_demux_nmea(dh, nmea, (size_t)(d - nmea), evt_fn);
+                nmea = NULL;
+            }
+            d = ud;
+            len = ulen;
+            ud = NULL;
+            continue;
+        }
+        if (dh->proto == LWGPS_PROTO_NMEA) {
+            if ((*d >= 0x20 && *d < 0x7F) || *d == '\r' || *d == '\n') {
+                if (nmea == NULL) {
+                    nmea = d;
+                }
+                if (*d == '\n') { /* End of sentence */
+                    prv_demux_nmea(dh, nmea, (size_t)(d - nmea) + 1, evt_fn);
+                    nmea = NULL;
+                    dh->proto = LWGPS_PROTO_NONE;
+                }
+                ++d;
+                --len;
+                continue;
+            }
+
+            /* Binary data interrupted the sentence, drop what was parsed so far */
+            if (nmea != NULL) {
+                prv_demux_nmea(dh, nmea, (size_t)(d - nmea), evt_fn);
+                nmea = NULL;
+            }
+            if (dh->gps != NULL && SCRATCH_READY(dh->gps)) {
+                SENTENCE_RESET(dh->gps);
+            }
+            dh->proto = LWGPS_PROTO_NONE; /* Byte may start another frame */
+        }
+        if (dh->proto == LWGPS_PROTO_NONE) {
+            if (*d == '$' || LWGPS_IS_AIS_START(*d) || LWGPS_IS_TAG_START(*d)) {
+                dh->proto = LWGPS_PROTO_NMEA;
+                continue;
+            } else if (*d == UBX_SYNC_1) {
+                dh->proto = LWGPS_PROTO_UBX;
+            } else if (*d == RTCM3_PREAMBLE) {
+                dh->proto = LWGPS_PROTO_RTCM3;
+            } else { /* Ignore data between frames */
+                ++d;
+                --len;
+                continue;
+            }
+            dh->len = 0;
+            dh->frame_len = 0;
+
+            /* Complete frame is available, pass it without copy */
+            if (prv_demux_header(dh->proto, d, len, &n) && n > 0 && n <= len) {
+                if (!prv_demux_frame(dh, d, n, evt_fn)) {
+                    n = 1; /* Rescan from the byte after sync character */
+                }
+                dh->proto = LWGPS_PROTO_NONE;
+                d += n;
+                len -= n;
+                continue;
+            }
+        }
+
+        /* Frame is split across input chunks, collect it to buffer */
+        if (dh->frame_len == 0) {
+            dh->buff[dh->len++] = *d;
+            if (!prv_demux_header(dh->proto, dh->buff, dh->len, &dh->frame_len)
+                || dh->frame_len > LWGPS_CFG_DEMUX_BUFF_SIZE) {
+                dh->proto = LWGPS_PROTO_NONE; /* Not a frame or frame does not fit, byte may start another one */
+                continue;
+            }
+            ++d;
+            --len;
+        } else {
+            n = dh->frame_len - dh->len;
+            if (n > len) {
+                n = len;
+            }
+            LWGPS_MEMMOVE(&dh->buff[dh->len], d, n); /* Data may come from the buffer itself, when rescanned */
+            dh->len += n;
+            d += n;
+            len -= n;
+        }
+        if (dh->frame_len > 0 && dh->len == dh->frame_len) {
+            n = prv_demux_frame(dh, dh->buff, dh->len, evt_fn);
+            dh->proto = LWGPS_PROTO_NONE;
+            if (!n) {
+                /* Rescan buffer from the byte after sync character, followed by not yet processed data */
+                if (ud == NULL) {
+                    ud = d;
+                    ulen = len;
+                    len = 0;
+                } else {
+                    LWGPS_MEMMOVE(&dh->buff[dh->len], d, len); /* Rescan is in progress, keep its rest contiguous */
+                }
+                d = &dh->buff[1];
+                len += dh->len - 1;
+            }
+        }
+    }
+    if (nmea != NULL) {
+        prv_demux_nmea(dh, nmea, (size_t)(d - nmea), evt_fn);
+    }
+    return 1;
+}
+
+#endif /* LWGPS_CFG_DEMUX || __DOXYGEN__ */
+
+#if LWESP_CFG_DISTANCE_BEARING || __DOXYGEN__
+
+/**
+ * \brief           Calculate distance and bearing between `2` latitude and longitude coordinates
+ * \param[in]       las: Latitude start coordinate, in units of degrees
+ * \param[in]       los: Longitude start coordinate, in units of degrees
+ * \param[in]       lae: Latitude end coordinate, in units of degrees
+ * \param[in]       loe: Longitude end coordinate, in units of degrees
+ * \param[out]      d: Pointer to output distance in units of meters
+ * \param[out]      b: Pointer to output bearing between start and end coordinate in relation to north in units of degrees
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+lwgps_distance_bearing(lwgps_float_t las, lwgps_float_t los, lwgps_float_t lae, lwgps_float_t loe, lwgps_float_t* d,
+                       lwgps_float_t* b) {
+    lwgps_float_t df, dfi, a;
+
+    if (d == NULL && b == NULL) {
+        return 0;
+    }
+
+    /* Convert degrees to radians */
+    df = D2R(lae - las);
+    dfi = D2R(loe - los);
+    las = D2R(las);
+    los = D2R(los);
+    lae = D2R(lae);
+    loe = D2R(loe);
+
+    /*
+     * Calculate distance
+     *
+     * Calculated distance is absolute value in meters between 2 points on earth.
+     */
+    if (d != NULL) {
+        /*
+         * a = sin(df / 2)^2 + cos(las) * cos(lae) * sin(dfi / 2)^2
+         * *d = RADIUS * 2 * atan(sqrt(a) / sqrt(1 - a)) * 1000 (for meters)
+         */
+#if LWGPS_CFG_DOUBLE
+        a = FLT(sin(df * 0.5) * sin(df * 0.5) + sin(dfi * 0.5) * sin(dfi * 0.5) * cos(las) * cos(lae));
+        *d = FLT(EARTH_RADIUS * 2.0 * atan2(sqrt(a), sqrt(1.0 - a)) * 1000.0);
+#else  /* LWGPS_CFG_DOUBLE */
+        a = FLT(sinf(df * 0.5f) * sinf(df * 0.5f) + sinf(dfi * 0.5f) * sinf(dfi * 0.5f) * cosf(las) * cosf(lae));
+        *d = FLT(EARTH_RADIUS * 2.0f * atan2f(sqrtf(a), sqrtf(1.0f - a)) * 1000.0f);
+#endif /* !LWGPS_CFG_DOUBLE */
+    }
+
+    /*
      * Calculate bearing
      *
      * Bearing is calculated from point 1 to point 2.
@@ -568,21 +2241,863 @@ lwgps_distance_bearing(lwgps_float_t las, lwgps_float_t los, lwgps_float_t lae,
         df = FLT(sin(loe - los) * cos(lae));
         dfi = FLT(cos(las) * sin(lae) - sin(las) * cos(lae) * cos(loe - los));
 
-        *b = R2D(atan2(df, dfi)); /* Calculate bearing and convert to degrees */
-#else                             /* LWGPS_CFG_DOUBLE */
-        df = FLT(sinf(loe - los) * cosf(lae));
-        dfi = FLT(cosf(las) * sinf(lae) - sinf(las) * cosf(lae) * cosf(loe - los));
+        *b = R2D(atan2(df, dfi)); /* Calculate bearing and convert to degrees */
+#else                             /* LWGPS_CFG_DOUBLE */
+        df = FLT(sinf(loe - los) * cosf(lae));
+        dfi = FLT(cosf(las) * sinf(lae) - sinf(las) * cosf(lae) * cosf(loe - los));
+
+        *b = R2D(atan2f(df, dfi)); /* Calculate bearing and convert to degrees */
+#endif                            /* !LWGPS_CFG_DOUBLE */
+        if (*b < 0) {             /* Check for negative angle */
+            *b += FLT(360);       /* Make bearing always positive */
+        }
+    }
+    return 1;
+}
+
+#endif /* LWESP_CFG_DISTANCE_BEARING || __DOXYGEN__ */
+
+#if LWGPS_CFG_LATENCY || __DOXYGEN__
+
+/**
+ * \brief           Reset latency histograms
+ * \param[in]       ghandle: GPS handle
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+lwgps_latency_reset(lwgps_t* ghandle) {
+    if (ghandle == NULL) {
+        return 0;
+    }
+    LWGPS_MEMSET(&ghandle->lat, 0x00, sizeof(ghandle->lat));
+    return 1;
+}
+
+/**
+ * \brief           Get latency percentile from histogram
+ *
+ *                  Result is upper bound of the bin, where percentile falls into.
+ *                  `UINT32_MAX` is returned when it falls into last, open ended bin
+ *
+ * \param[in]       hist: Histogram with \ref LWGPS_CFG_LATENCY_BINS bins,
+ *                      such as \ref lwgps_latency_t.total_hist
+ * \param[in]       percent: Percentile, from `0` to `100`
+ * \return          Latency in units of ticks, `0` for empty histogram
+ */
+uint32_t
+lwgps_latency_percentile(const uint32_t* hist, uint8_t percent) {
+    uint64_t total = 0, target, sum = 0;
+    uint8_t i;
+
+    for (i = 0; i < LWGPS_CFG_LATENCY_BINS; ++i) {
+        total += hist[i];
+    }
+    if (total == 0) {
+        return 0;
+    }
+    target = (total * (percent > 100 ? 100 : percent) + 99) / 100;
+    for (i = 0; i < LWGPS_CFG_LATENCY_BINS - 1; ++i) {
+        sum += hist[i];
+        if (sum >= target && sum > 0) {
+            return (uint32_t)((1UL << i) - 1);
+        }
+    }
+    return UINT32_MAX;
+}
+
+#endif /* LWGPS_CFG_LATENCY || __DOXYGEN__ */
+
+#if LWGPS_CFG_CHECKPOINT || __DOXYGEN__
+
+/*
+ * Checkpoint format, all multi-byte values are little endian:
+ *
+ * - Header: magic `LGCP`, 16-bit format version, 16-bit reserved value
+ * - Sections: 8-bit section ID, 16-bit payload length, payload
+ *
+ * Floating point values are stored as IEEE 754 binary64, regardless of `LWGPS_CFG_DOUBLE`.
+ * Sections of features, disabled at load time, and unknown sections are skipped.
+ * Payload of existing section never changes, new data get new section ID
+ */
+#define CKPT_VERSION      1
+#define CKPT_HDR_SIZE     8
+#define CKPT_SEC_GGA      1
+#define CKPT_SEC_GSA      2
+#define CKPT_SEC_GSV      3
+#define CKPT_SEC_RMC      4
+#define CKPT_SEC_PUBX     5
+#define CKPT_SEC_ODOMETER 6
+#define CKPT_SEC_HISTORY  7
+#define CKPT_SEC_AIS      8
+#define CKPT_SEC_FIELDS   9
+#define CKPT_SAT_SIZE     5  /* Size of each satellite in GSV section */
+#define CKPT_FIX_SIZE     44 /* Size of each fix in history section */
+
+/* Section length is 16-bit value */
+#if LWGPS_CFG_HISTORY
+STATIC_ASSERT(ckpt_history_size, 2 + (unsigned long)LWGPS_CFG_HISTORY_LEN * CKPT_FIX_SIZE <= 0xFFFF);
+#endif /* LWGPS_CFG_HISTORY */
 
-        *b = R2D(atan2f(df, dfi)); /* Calculate bearing and convert to degrees */
-#endif                            /* !LWGPS_CFG_DOUBLE */
-        if (*b < 0) {             /* Check for negative angle */
-            *b += FLT(360);       /* Make bearing always positive */
+/**
+ * \brief           Checkpoint writer
+ */
+typedef struct {
+    uint8_t* buff; /*!< Output buffer */
+    size_t len;    /*!< Length of output buffer, `0` to only calculate size */
+    size_t pos;    /*!< Write position, continues past the end to calculate required size */
+} prv_ckpt_wr_t;
+
+/**
+ * \brief           Checkpoint reader
+ */
+typedef struct {
+    const uint8_t* d; /*!< Input data */
+    size_t len;       /*!< Length of input data */
+    size_t pos;       /*!< Read position */
+} prv_ckpt_rd_t;
+
+/**
+ * \brief           Write little endian value
+ * \param[in]       w: Writer
+ * \param[in]       val: Value
+ * \param[in]       size: Size of value in units of bytes
+ */
+static void
+prv_ckpt_put(prv_ckpt_wr_t* w, uint64_t val, uint8_t size) {
+    for (; size > 0; --size, val >>= 8, ++w->pos) {
+        if (w->pos < w->len) {
+            w->buff[w->pos] = (uint8_t)val;
+        }
+    }
+}
+
+/**
+ * \brief           Write floating point value as binary64
+ * \param[in]       w: Writer
+ * \param[in]       val: Value
+ */
+static void
+prv_ckpt_put_flt(prv_ckpt_wr_t* w, lwgps_float_t val) {
+    double d = (double)val;
+    uint64_t u;
+
+    LWGPS_MEMCPY(&u, &d, sizeof(u));
+    prv_ckpt_put(w, u, 8);
+}
+
+/**
+ * \brief           Start new section, its length is written by \ref prv_ckpt_end
+ * \param[in]       w: Writer
+ * \param[in]       id: Section ID
+ * \return          Position of section length
+ */
+static size_t
+prv_ckpt_begin(prv_ckpt_wr_t* w, uint8_t id) {
+    prv_ckpt_put(w, id, 1);
+    prv_ckpt_put(w, 0, 2);
+    return w->pos - 2;
+}
+
+/**
+ * \brief           Finish section and write its length
+ * \param[in]       w: Writer
+ * \param[in]       at: Position of section length, returned by \ref prv_ckpt_begin
+ */
+static void
+prv_ckpt_end(prv_ckpt_wr_t* w, size_t at) {
+    size_t pos = w->pos;
+
+    w->pos = at;
+    prv_ckpt_put(w, pos - at - 2, 2);
+    w->pos = pos;
+}
+
+/**
+ * \brief           Read little endian value
+ * \param[in]       r: Reader
+ * \param[in]       size: Size of value in units of bytes
+ * \return          Value, missing bytes past the end are read as `0`
+ */
+static uint64_t
+prv_ckpt_get(prv_ckpt_rd_t* r, uint8_t size) {
+    uint64_t val = 0;
+    uint8_t i;
+
+    for (i = 0; i < size; ++i, ++r->pos) {
+        if (r->pos < r->len) {
+            val |= (uint64_t)r->d[r->pos] << (8U * i);
+        }
+    }
+    return val;
+}
+
+/**
+ * \brief           Read binary64 floating point value
+ * \param[in]       r: Reader
+ * \return          Value
+ */
+static lwgps_float_t
+prv_ckpt_get_flt(prv_ckpt_rd_t* r) {
+    uint64_t u = prv_ckpt_get(r, 8);
+    double d;
+
+    LWGPS_MEMCPY(&d, &u, sizeof(d));
+    return (lwgps_float_t)d;
+}
+
+/**
+ * \brief           Check payload length of single section
+ * \param[in]       id: Section ID
+ * \param[in]       r: Reader, limited to section payload
+ * \return          `1` when length matches section format or section is unknown, `0` otherwise
+ */
+static uint8_t
+prv_ckpt_check_section(uint8_t id, prv_ckpt_rd_t* r) {
+    switch (id) {
+        case CKPT_SEC_GGA: return r->len == 45;
+        case CKPT_SEC_GSA: return r->len == 37;
+        case CKPT_SEC_GSV: return r->len >= 2 && r->len == 2 + (size_t)r->d[1] * CKPT_SAT_SIZE;
+        case CKPT_SEC_RMC: return r->len == 28;
+        case CKPT_SEC_PUBX: return r->len == 33;
+        case CKPT_SEC_ODOMETER: return r->len == 49;
+        case CKPT_SEC_HISTORY: return r->len >= 2 && r->len == 2 + (size_t)prv_ckpt_get(r, 2) * CKPT_FIX_SIZE;
+        case CKPT_SEC_AIS: return r->len == 45;
+        case CKPT_SEC_FIELDS: return r->len == 4;
+        default: return 1;
+    }
+}
+
+/**
+ * \brief           Restore single section, its length is checked by \ref prv_ckpt_check_section
+ * \param[in]       ghandle: GPS handle
+ * \param[in]       id: Section ID
+ * \param[in]       r: Reader, limited to section payload
+ */
+static void
+prv_ckpt_load_section(lwgps_t* ghandle, uint8_t id, prv_ckpt_rd_t* r) {
+    size_t i, cnt;
+
+    switch (id) {
+#if LWGPS_CFG_STATEMENT_GPGGA
+        case CKPT_SEC_GGA: {
+            ghandle->latitude = prv_ckpt_get_flt(r);
+            ghandle->longitude = prv_ckpt_get_flt(r);
+            ghandle->altitude = prv_ckpt_get_flt(r);
+            ghandle->geo_sep = prv_ckpt_get_flt(r);
+            ghandle->dgps_age = prv_ckpt_get_flt(r);
+            ghandle->sats_in_use = (uint8_t)prv_ckpt_get(r, 1);
+            ghandle->fix = (uint8_t)prv_ckpt_get(r, 1);
+            ghandle->hours = (uint8_t)prv_ckpt_get(r, 1);
+            ghandle->minutes = (uint8_t)prv_ckpt_get(r, 1);
+            ghandle->seconds = (uint8_t)prv_ckpt_get(r, 1);
+            break;
+        }
+#endif /* LWGPS_CFG_STATEMENT_GPGGA */
+#if LWGPS_CFG_STATEMENT_GPGSA
+        case CKPT_SEC_GSA: {
+            ghandle->dop_h = prv_ckpt_get_flt(r);
+            ghandle->dop_v = prv_ckpt_get_flt(r);
+            ghandle->dop_p = prv_ckpt_get_flt(r);
+            ghandle->fix_mode = (uint8_t)prv_ckpt_get(r, 1);
+            for (i = 0; i < sizeof(ghandle->satellites_ids) / sizeof(ghandle->satellites_ids[0]); ++i) {
+                ghandle->satellites_ids[i] = (uint8_t)prv_ckpt_get(r, 1);
+            }
+            break;
+        }
+#endif /* LWGPS_CFG_STATEMENT_GPGSA */
+#if LWGPS_CFG_STATEMENT_GPGSV
+        case CKPT_SEC_GSV: {
+            ghandle->sats_in_view = (uint8_t)prv_ckpt_get(r, 1);
+            cnt = (size_t)prv_ckpt_get(r, 1);
+#if LWGPS_CFG_STATEMENT_GPGSV_SAT_DET
+            for (i = 0; i < cnt && i < sizeof(ghandle->sats_in_view_desc) / sizeof(ghandle->sats_in_view_desc[0]); ++i) {
+                ghandle->sats_in_view_desc[i].num = (uint8_t)prv_ckpt_get(r, 1);
+                ghandle->sats_in_view_desc[i].elevation = (uint8_t)prv_ckpt_get(r, 1);
+                ghandle->sats_in_view_desc[i].azimuth = (uint16_t)prv_ckpt_get(r, 2);
+                ghandle->sats_in_view_desc[i].snr = (uint8_t)prv_ckpt_get(r, 1);
+            }
+#endif /* LWGPS_CFG_STATEMENT_GPGSV_SAT_DET */
+            break;
+        }
+#endif /* LWGPS_CFG_STATEMENT_GPGSV */
+#if LWGPS_CFG_STATEMENT_GPRMC
+        case CKPT_SEC_RMC: {
+            ghandle->is_valid = (uint8_t)prv_ckpt_get(r, 1);
+            ghandle->speed = prv_ckpt_get_flt(r);
+            ghandle->course = prv_ckpt_get_flt(r);
+            ghandle->variation = prv_ckpt_get_flt(r);
+            ghandle->date = (uint8_t)prv_ckpt_get(r, 1);
+            ghandle->month = (uint8_t)prv_ckpt_get(r, 1);
+            ghandle->year = (uint8_t)prv_ckpt_get(r, 1);
+            break;
+        }
+#endif /* LWGPS_CFG_STATEMENT_GPRMC */
+#if LWGPS_CFG_STATEMENT_PUBX_TIME
+        case CKPT_SEC_PUBX: {
+            ghandle->hours = (uint8_t)prv_ckpt_get(r, 1);
+            ghandle->minutes = (uint8_t)prv_ckpt_get(r, 1);
+            ghandle->seconds = (uint8_t)prv_ckpt_get(r, 1);
+            ghandle->date = (uint8_t)prv_ckpt_get(r, 1);
+            ghandle->month = (uint8_t)prv_ckpt_get(r, 1);
+            ghandle->year = (uint8_t)prv_ckpt_get(r, 1);
+            ghandle->utc_tow = prv_ckpt_get_flt(r);
+            ghandle->utc_wk = (uint16_t)prv_ckpt_get(r, 2);
+            ghandle->leap_sec = (uint8_t)prv_ckpt_get(r, 1);
+            ghandle->clk_bias = (uint32_t)prv_ckpt_get(r, 4);
+            ghandle->clk_drift = prv_ckpt_get_flt(r);
+            ghandle->tp_gran = (uint32_t)prv_ckpt_get(r, 4);
+            break;
+        }
+#endif /* LWGPS_CFG_STATEMENT_PUBX_TIME */
+#if LWGPS_CFG_ODOMETER
+        case CKPT_SEC_ODOMETER: {
+            ghandle->odo.distance = prv_ckpt_get_flt(r);
+            ghandle->odo.max_speed = prv_ckpt_get_flt(r);
+            ghandle->odo.moving_time = (uint32_t)prv_ckpt_get(r, 4);
+            ghandle->odo.comp = prv_ckpt_get_flt(r);
+            ghandle->odo.latitude = prv_ckpt_get_flt(r);
+            ghandle->odo.longitude = prv_ckpt_get_flt(r);
+            ghandle->odo.time = (uint32_t)prv_ckpt_get(r, 4);
+            ghandle->odo.has_ref = (uint8_t)prv_ckpt_get(r, 1);
+            break;
+        }
+#endif /* LWGPS_CFG_ODOMETER */
+#if LWGPS_CFG_HISTORY
+        case CKPT_SEC_HISTORY: {
+            cnt = (size_t)prv_ckpt_get(r, 2);
+            if (cnt > LWGPS_CFG_HISTORY_LEN) { /* Keep only the most recent fixes */
+                r->pos += (cnt - LWGPS_CFG_HISTORY_LEN) * CKPT_FIX_SIZE;
+                cnt = LWGPS_CFG_HISTORY_LEN;
+            }
+            for (i = 0; i < cnt; ++i) { /* Stored from oldest to newest */
+                lwgps_fix_t* fix = &ghandle->hist.fix[i];
+
+                fix->latitude = prv_ckpt_get_flt(r);
+                fix->longitude = prv_ckpt_get_flt(r);
+                fix->altitude = prv_ckpt_get_flt(r);
+                fix->speed = prv_ckpt_get_flt(r);
+                fix->course = prv_ckpt_get_flt(r);
+                fix->time = (uint32_t)prv_ckpt_get(r, 4);
+            }
+            ghandle->hist.count = (uint16_t)cnt;
+            ghandle->hist.head = (uint16_t)(cnt % LWGPS_CFG_HISTORY_LEN);
+            break;
+        }
+#endif /* LWGPS_CFG_HISTORY */
+#if LWGPS_CFG_AIS
+        case CKPT_SEC_AIS: {
+            ghandle->ais.type = (uint8_t)prv_ckpt_get(r, 1);
+            ghandle->ais.mmsi = (uint32_t)prv_ckpt_get(r, 4);
+            ghandle->ais.nav_status = (uint8_t)prv_ckpt_get(r, 1);
+            ghandle->ais.rot = (int8_t)prv_ckpt_get(r, 1);
+            ghandle->ais.speed = prv_ckpt_get_flt(r);
+            ghandle->ais.latitude = prv_ckpt_get_flt(r);
+            ghandle->ais.longitude = prv_ckpt_get_flt(r);
+            ghandle->ais.course = prv_ckpt_get_flt(r);
+            ghandle->ais.heading = (uint16_t)prv_ckpt_get(r, 2);
+            ghandle->ais.accuracy = (uint8_t)prv_ckpt_get(r, 1);
+            ghandle->ais.timestamp = (uint8_t)prv_ckpt_get(r, 1);
+            ghandle->ais.own = (uint8_t)prv_ckpt_get(r, 1);
+            ghandle->ais.channel = (char)prv_ckpt_get(r, 1);
+            break;
+        }
+#endif /* LWGPS_CFG_AIS */
+#if LWGPS_CFG_FIELD_MASK
+        case CKPT_SEC_FIELDS: {
+            ghandle->fields_present = (uint32_t)prv_ckpt_get(r, 4);
+            ghandle->fields_updated = ghandle->fields_present; /* Restored fields are new to the application */
+            break;
+        }
+#endif /* LWGPS_CFG_FIELD_MASK */
+        default: break;
+    }
+    (void)ghandle;
+    (void)r;
+    (void)i;
+    (void)cnt;
+}
+
+/**
+ * \brief           Save fix and accumulated state of GPS handle to checkpoint
+ *
+ *                  Checkpoint contains public fix fields of all enabled statements,
+ *                  odometer, history of fixes, last AIS report and field presence mask.
+ *                  Parser state of sentence in progress is not saved.
+ *
+ * \param[in]       ghandle: GPS handle
+ * \param[out]      buff: Output buffer. Set to `NULL` to get required size only
+ * \param[in]       len: Length of output buffer in units of bytes
+ * \return          Number of bytes written or required, `0` when buffer is too small
+ */
+size_t
+lwgps_checkpoint_save(const lwgps_t* ghandle, void* buff, size_t len) {
+    prv_ckpt_wr_t w = {0};
+    size_t at, i;
+
+    if (ghandle == NULL) {
+        return 0;
+    }
+    w.buff = buff;
+    w.len = buff != NULL ? len : 0;
+    prv_ckpt_put(&w, 0x5043474CUL, 4); /* "LGCP" */
+    prv_ckpt_put(&w, CKPT_VERSION, 2);
+    prv_ckpt_put(&w, 0, 2);
+
+#if LWGPS_CFG_STATEMENT_GPGGA
+    at = prv_ckpt_begin(&w, CKPT_SEC_GGA);
+    prv_ckpt_put_flt(&w, ghandle->latitude);
+    prv_ckpt_put_flt(&w, ghandle->longitude);
+    prv_ckpt_put_flt(&w, ghandle->altitude);
+    prv_ckpt_put_flt(&w, ghandle->geo_sep);
+    prv_ckpt_put_flt(&w, ghandle->dgps_age);
+    prv_ckpt_put(&w, ghandle->sats_in_use, 1);
+    prv_ckpt_put(&w, ghandle->fix, 1);
+    prv_ckpt_put(&w, ghandle->hours, 1);
+    prv_ckpt_put(&w, ghandle->minutes, 1);
+    prv_ckpt_put(&w, ghandle->seconds, 1);
+    prv_ckpt_end(&w, at);
+#endif /* LWGPS_CFG_STATEMENT_GPGGA */
+#if LWGPS_CFG_STATEMENT_GPGSA
+    at = prv_ckpt_begin(&w, CKPT_SEC_GSA);
+    prv_ckpt_put_flt(&w, ghandle->dop_h);
+    prv_ckpt_put_flt(&w, ghandle->dop_v);
+    prv_ckpt_put_flt(&w, ghandle->dop_p);
+    prv_ckpt_put(&w, ghandle->fix_mode, 1);
+    for (i = 0; i < sizeof(ghandle->satellites_ids) / sizeof(ghandle->satellites_ids[0]); ++i) {
+        prv_ckpt_put(&w, ghandle->satellites_ids[i], 1);
+    }
+    prv_ckpt_end(&w, at);
+#endif /* LWGPS_CFG_STATEMENT_GPGSA */
+#if LWGPS_CFG_STATEMENT_GPGSV
+    at = prv_ckpt_begin(&w, CKPT_SEC_GSV);
+    prv_ckpt_put(&w, ghandle->sats_in_view, 1);
+#if LWGPS_CFG_STATEMENT_GPGSV_SAT_DET
+    prv_ckpt_put(&w, sizeof(ghandle->sats_in_view_desc) / sizeof(ghandle->sats_in_view_desc[0]), 1);
+    for (i = 0; i < sizeof(ghandle->sats_in_view_desc) / sizeof(ghandle->sats_in_view_desc[0]); ++i) {
+        prv_ckpt_put(&w, ghandle->sats_in_view_desc[i].num, 1);
+        prv_ckpt_put(&w, ghandle->sats_in_view_desc[i].elevation, 1);
+        prv_ckpt_put(&w, ghandle->sats_in_view_desc[i].azimuth, 2);
+        prv_ckpt_put(&w, ghandle->sats_in_view_desc[i].snr, 1);
+    }
+#else
+    prv_ckpt_put(&w, 0, 1);
+#endif /* LWGPS_CFG_STATEMENT_GPGSV_SAT_DET */
+    prv_ckpt_end(&w, at);
+#endif /* LWGPS_CFG_STATEMENT_GPGSV */
+#if LWGPS_CFG_STATEMENT_GPRMC
+    at = prv_ckpt_begin(&w, CKPT_SEC_RMC);
+    prv_ckpt_put(&w, ghandle->is_valid, 1);
+    prv_ckpt_put_flt(&w, ghandle->speed);
+    prv_ckpt_put_flt(&w, ghandle->course);
+    prv_ckpt_put_flt(&w, ghandle->variation);
+    prv_ckpt_put(&w, ghandle->date, 1);
+    prv_ckpt_put(&w, ghandle->month, 1);
+    prv_ckpt_put(&w, ghandle->year, 1);
+    prv_ckpt_end(&w, at);
+#endif /* LWGPS_CFG_STATEMENT_GPRMC */
+#if LWGPS_CFG_STATEMENT_PUBX_TIME
+    at = prv_ckpt_begin(&w, CKPT_SEC_PUBX);
+    prv_ckpt_put(&w, ghandle->hours, 1);
+    prv_ckpt_put(&w, ghandle->minutes, 1);
+    prv_ckpt_put(&w, ghandle->seconds, 1);
+    prv_ckpt_put(&w, ghandle->date, 1);
+    prv_ckpt_put(&w, ghandle->month, 1);
+    prv_ckpt_put(&w, ghandle->year, 1);
+    prv_ckpt_put_flt(&w, ghandle->utc_tow);
+    prv_ckpt_put(&w, ghandle->utc_wk, 2);
+    prv_ckpt_put(&w, ghandle->leap_sec, 1);
+    prv_ckpt_put(&w, ghandle->clk_bias, 4);
+    prv_ckpt_put_flt(&w, ghandle->clk_drift);
+    prv_ckpt_put(&w, ghandle->tp_gran, 4);
+    prv_ckpt_end(&w, at);
+#endif /* LWGPS_CFG_STATEMENT_PUBX_TIME */
+#if LWGPS_CFG_ODOMETER
+    at = prv_ckpt_begin(&w, CKPT_SEC_ODOMETER);
+    prv_ckpt_put_flt(&w, ghandle->odo.distance);
+    prv_ckpt_put_flt(&w, ghandle->odo.max_speed);
+    prv_ckpt_put(&w, ghandle->odo.moving_time, 4);
+    prv_ckpt_put_flt(&w, ghandle->odo.comp);
+    prv_ckpt_put_flt(&w, ghandle->odo.latitude);
+    prv_ckpt_put_flt(&w, ghandle->odo.longitude);
+    prv_ckpt_put(&w, ghandle->odo.time, 4);
+    prv_ckpt_put(&w, ghandle->odo.has_ref, 1);
+    prv_ckpt_end(&w, at);
+#endif /* LWGPS_CFG_ODOMETER */
+#if LWGPS_CFG_HISTORY
+    at = prv_ckpt_begin(&w, CKPT_SEC_HISTORY);
+    prv_ckpt_put(&w, ghandle->hist.count, 2);
+    for (i = ghandle->hist.count; i > 0; --i) { /* From oldest to newest */
+        const lwgps_fix_t* fix = lwgps_history_get(ghandle, i - 1);
+
+        prv_ckpt_put_flt(&w, fix->latitude);
+        prv_ckpt_put_flt(&w, fix->longitude);
+        prv_ckpt_put_flt(&w, fix->altitude);
+        prv_ckpt_put_flt(&w, fix->speed);
+        prv_ckpt_put_flt(&w, fix->course);
+        prv_ckpt_put(&w, fix->time, 4);
+    }
+    prv_ckpt_end(&w, at);
+#endif /* LWGPS_CFG_HISTORY */
+#if LWGPS_CFG_AIS
+    at = prv_ckpt_begin(&w, CKPT_SEC_AIS);
+    prv_ckpt_put(&w, ghandle->ais.type, 1);
+    prv_ckpt_put(&w, ghandle->ais.mmsi, 4);
+    prv_ckpt_put(&w, ghandle->ais.nav_status, 1);
+    prv_ckpt_put(&w, (uint8_t)ghandle->ais.rot, 1);
+    prv_ckpt_put_flt(&w, ghandle->ais.speed);
+    prv_ckpt_put_flt(&w, ghandle->ais.latitude);
+    prv_ckpt_put_flt(&w, ghandle->ais.longitude);
+    prv_ckpt_put_flt(&w, ghandle->ais.course);
+    prv_ckpt_put(&w, ghandle->ais.heading, 2);
+    prv_ckpt_put(&w, ghandle->ais.accuracy, 1);
+    prv_ckpt_put(&w, ghandle->ais.timestamp, 1);
+    prv_ckpt_put(&w, ghandle->ais.own, 1);
+    prv_ckpt_put(&w, (uint8_t)ghandle->ais.channel, 1);
+    prv_ckpt_end(&w, at);
+#endif /* LWGPS_CFG_AIS */
+#if LWGPS_CFG_FIELD_MASK
+    at = prv_ckpt_begin(&w, CKPT_SEC_FIELDS);
+    prv_ckpt_put(&w, ghandle->fields_present, 4);
+    prv_ckpt_end(&w, at);
+#endif /* LWGPS_CFG_FIELD_MASK */
+    (void)at;
+    (void)i;
+    return buff == NULL || w.pos <= len ? w.pos : 0;
+}
+
+/**
+ * \brief           Restore fix and accumulated state of GPS handle from checkpoint
+ *
+ *                  GPS handle must be initialized with \ref lwgps_init first.
+ *                  Checkpoint is validated before any field is restored.
+ *                  Sections of features, not enabled in current configuration, are skipped
+ *
+ * \param[in]       ghandle: GPS handle
+ * \param[in]       buff: Checkpoint, written by \ref lwgps_checkpoint_save
+ * \param[in]       len: Length of checkpoint in units of bytes
+ * \return          `1` on success, `0` when checkpoint is not valid or its version is not supported
+ */
+uint8_t
+lwgps_checkpoint_load(lwgps_t* ghandle, const void* buff, size_t len) {
+    prv_ckpt_rd_t r = {0}, sec;
+    size_t slen;
+    uint8_t id, pass;
+
+    if (ghandle == NULL || buff == NULL || len < CKPT_HDR_SIZE) {
+        return 0;
+    }
+    r.d = buff;
+    r.len = len;
+    if (prv_ckpt_get(&r, 4) != 0x5043474CUL || prv_ckpt_get(&r, 2) != CKPT_VERSION) {
+        return 0;
+    }
+
+    /* First pass validates section framing and lengths, second pass restores the fields */
+    for (pass = 0; pass < 2; ++pass) {
+        for (r.pos = CKPT_HDR_SIZE; r.pos < len; r.pos += slen) {
+            if (len - r.pos < 3) {
+                return 0;
+            }
+            id = (uint8_t)prv_ckpt_get(&r, 1);
+            slen = (size_t)prv_ckpt_get(&r, 2);
+            if (slen > len - r.pos) {
+                return 0;
+            }
+            sec.d = &r.d[r.pos];
+            sec.len = slen;
+            sec.pos = 0;
+            if (pass == 0) {
+                if (!prv_ckpt_check_section(id, &sec)) {
+                    return 0;
+                }
+            } else {
+                prv_ckpt_load_section(ghandle, id, &sec);
+            }
         }
     }
     return 1;
 }
 
-#endif /* LWESP_CFG_DISTANCE_BEARING || __DOXYGEN__ */
+#endif /* LWGPS_CFG_CHECKPOINT || __DOXYGEN__ */
+
+#if LWGPS_CFG_ODOMETER || __DOXYGEN__
+
+/**
+ * \brief           Reset odometer and trip information to start new trip
+ * \param[in]       ghandle: GPS handle
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+lwgps_odometer_reset(lwgps_t* ghandle) {
+    if (ghandle == NULL) {
+        return 0;
+    }
+    LWGPS_MEMSET(&ghandle->odo, 0x00, sizeof(ghandle->odo));
+    return 1;
+}
+
+#endif /* LWGPS_CFG_ODOMETER || __DOXYGEN__ */
+
+#if LWGPS_CFG_REPORT_FILTER || __DOXYGEN__
+
+/**
+ * \brief           Set report filter policy for status callback
+ *
+ *                  Reference values are reset, so next `GGA` and `RMC` statements are always reported.
+ * \param[in]       ghandle: GPS handle
+ * \param[in]       filter: Report policy. Set to `NULL` to report all statements
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+lwgps_set_report_filter(lwgps_t* ghandle, const lwgps_report_filter_t* filter) {
+    if (ghandle == NULL) {
+        return 0;
+    }
+    LWGPS_MEMSET(&ghandle->filt, 0x00, sizeof(ghandle->filt));
+    if (filter != NULL) {
+        ghandle->filt.cfg = *filter;
+    }
+    return 1;
+}
+
+#endif /* LWGPS_CFG_REPORT_FILTER || __DOXYGEN__ */
+
+#if LWGPS_CFG_RUNTIME_MASK || __DOXYGEN__
+
+/**
+ * \brief           Set runtime features of GPS handle
+ *
+ *                  New features apply from next sentence on, sentence being received is finished with old ones.
+ *                  All features are enabled by \ref lwgps_init
+ *
+ * \param[in]       ghandle: GPS handle
+ * \param[in]       features: Bitwise OR of \ref lwgps_feature_t values
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+lwgps_set_features(lwgps_t* ghandle, uint32_t features) {
+    if (ghandle == NULL) {
+        return 0;
+    }
+    ghandle->features_off = ~features & LWGPS_FEATURE_ALL;
+    return 1;
+}
+
+#endif /* LWGPS_CFG_RUNTIME_MASK || __DOXYGEN__ */
+
+#if LWGPS_CFG_SIMPLIFY || __DOXYGEN__
+
+/**
+ * \brief           Set new anchor point of the simplifier
+ * \param[in]       sh: Simplifier handle
+ * \param[in]       pt: New anchor point
+ */
+static void
+prv_simplify_set_anchor(lwgps_simplify_t* sh, const lwgps_point_t* pt) {
+    sh->anchor = *pt;
+    sh->anchor_scale = FLT_COS(D2R(pt->latitude));
+    sh->has_anchor = 1;
+}
+
+/**
+ * \brief           Check if all points in the window are within tolerance
+ *                  of the segment from anchor to new point
+ *
+ *                  Points are projected to local plane around anchor,
+ *                  so no trigonometric function is called per point.
+ * \param[in]       sh: Simplifier handle
+ * \param[in]       pt: New segment end point
+ * \return          `1` if all points are within tolerance, `0` otherwise
+ */
+static uint8_t
+prv_simplify_in_tolerance(lwgps_simplify_t* sh, const lwgps_point_t* pt) {
+    lwgps_float_t m = EARTH_RADIUS * FLT(1000), tol2 = sh->tolerance * sh->tolerance;
+    lwgps_float_t px, py, plen2, bx, by, t, dx, dy;
+    uint16_t i;
+
+    px = D2R(pt->longitude - sh->anchor.longitude) * sh->anchor_scale * m;
+    py = D2R(pt->latitude - sh->anchor.latitude) * m;
+    plen2 = px * px + py * py;
+    for (i = 0; i < sh->win_len; ++i) {
+        bx = D2R(sh->win[i].longitude - sh->anchor.longitude) * sh->anchor_scale * m;
+        by = D2R(sh->win[i].latitude - sh->anchor.latitude) * m;
+
+        /* Closest point on the segment */
+        t = plen2 > 0 ? (bx * px + by * py) / plen2 : 0;
+        t = t < 0 ? 0 : (t > 1 ? 1 : t);
+        dx = bx - t * px;
+        dy = by - t * py;
+        if (dx * dx + dy * dy > tol2) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/**
+ * \brief           Initialize streaming track simplifier
+ * \param[in]       sh: Simplifier handle
+ * \param[in]       tolerance: Maximum distance of dropped point from simplified track, in units of meters
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+lwgps_simplify_init(lwgps_simplify_t* sh, lwgps_float_t tolerance) {
+    if (sh == NULL || tolerance < 0) {
+        return 0;
+    }
+    LWGPS_MEMSET(sh, 0x00, sizeof(*sh));
+    sh->tolerance = tolerance;
+    return 1;
+}
+
+/**
+ * \brief           Add new point to the simplifier
+ *
+ *                  Function keeps new point in the window for as long as all pending points
+ *                  can be replaced by single segment from last output point.
+ *                  First point of the track is always output.
+ *
+ * \param[in]       sh: Simplifier handle
+ * \param[in]       pt: New track point, usually latitude and longitude of recently committed fix
+ * \param[out]      out: Pointer to output point, written only when function returns `1`
+ * \return          `1` when point has been written to `out` and shall be stored/sent, `0` otherwise
+ */
+uint8_t
+lwgps_simplify_add(lwgps_simplify_t* sh, const lwgps_point_t* pt, lwgps_point_t* out) {
+    if (sh == NULL || pt == NULL || out == NULL) {
+        return 0;
+    }
+    if (!sh->has_anchor) { /* First point of the track */
+        prv_simplify_set_anchor(sh, pt);
+        *out = *pt;
+        return 1;
+    }
+    if (sh->win_len < LWGPS_CFG_SIMPLIFY_WINDOW && prv_simplify_in_tolerance(sh, pt)) {
+        sh->win[sh->win_len++] = *pt;
+        return 0;
+    }
+
+    /* Last pending point becomes part of simplified track */
+    *out = sh->win[sh->win_len - 1];
+    prv_simplify_set_anchor(sh, out);
+    sh->win[0] = *pt;
+    sh->win_len = 1;
+    return 1;
+}
+
+/**
+ * \brief           Output last pending point, typically at the end of the track
+ * \param[in]       sh: Simplifier handle
+ * \param[out]      out: Pointer to output point, written only when function returns `1`
+ * \return          `1` when point has been written to `out`, `0` if there is no pending point
+ */
+uint8_t
+lwgps_simplify_flush(lwgps_simplify_t* sh, lwgps_point_t* out) {
+    if (sh == NULL || out == NULL || sh->win_len == 0) {
+        return 0;
+    }
+    *out = sh->win[sh->win_len - 1];
+    prv_simplify_set_anchor(sh, out);
+    sh->win_len = 0;
+    return 1;
+}
+
+#endif /* LWGPS_CFG_SIMPLIFY || __DOXYGEN__ */
+
+#if LWGPS_CFG_HISTORY || __DOXYGEN__
+
+/**
+ * \brief           Get number of fixes in the history
+ * \param[in]       ghandle: GPS handle
+ * \return          Number of fixes available for \ref lwgps_history_get
+ */
+size_t
+lwgps_history_count(const lwgps_t* ghandle) {
+    return ghandle != NULL ? ghandle->hist.count : 0;
+}
+
+/**
+ * \brief           Get fix from the history
+ * \param[in]       ghandle: GPS handle
+ * \param[in]       idx: Fix index, `0` is the most recent fix
+ * \return          Pointer to fix, or `NULL` if index is out of range.
+ *                  Returned fix is overwritten after \ref LWGPS_CFG_HISTORY_LEN new fixes
+ */
+const lwgps_fix_t*
+lwgps_history_get(const lwgps_t* ghandle, size_t idx) {
+    if (ghandle == NULL || idx >= ghandle->hist.count) {
+        return NULL;
+    }
+    return &ghandle->hist.fix[(ghandle->hist.head + LWGPS_CFG_HISTORY_LEN - 1U - idx) % LWGPS_CFG_HISTORY_LEN];
+}
+
+/**
+ * \brief           Calculate kinematics from the history of fixes
+ *
+ *                  Velocity is derived from last `2` fixes, acceleration and turn rate need `3` fixes
+ *                  and are set to `0` otherwise. Heading is smoothed from oldest to newest fix in the history.
+ *
+ * \param[in]       ghandle: GPS handle
+ * \param[out]      kin: Pointer to output kinematics
+ * \return          `1` on success, `0` if there are not enough fixes with different time
+ */
+uint8_t
+lwgps_history_kinematics(const lwgps_t* ghandle, lwgps_kinematics_t* kin) {
+    const lwgps_fix_t *f0, *f1, *f2, *fo;
+    lwgps_float_t n, e, dt, dt1, h0, h1, dh;
+
+    if (ghandle == NULL || kin == NULL || ghandle->hist.count < 2) {
+        return 0;
+    }
+    f0 = lwgps_history_get(ghandle, 0);
+    f1 = lwgps_history_get(ghandle, 1);
+    dt = FLT(TIME_DIFF(f0->time, f1->time));
+    if (dt <= 0) {
+        return 0;
+    }
+
+    /* Velocity vector from last displacement */
+    prv_local_offset(f1->latitude, f1->longitude, f0->latitude, f0->longitude, &n, &e);
+    kin->vel_north = n / dt;
+    kin->vel_east = e / dt;
+    kin->accel = 0;
+    kin->turn_rate = 0;
+
+    /* Acceleration and turn rate from difference of last two velocity vectors */
+    if (ghandle->hist.count >= 3) {
+        f2 = lwgps_history_get(ghandle, 2);
+        dt1 = FLT(TIME_DIFF(f1->time, f2->time));
+        if (dt1 > 0) {
+            prv_local_offset(f2->latitude, f2->longitude, f1->latitude, f1->longitude, &n, &e);
+            n /= dt1;
+            e /= dt1;
+            dt1 = (dt + dt1) * FLT(0.5); /* Time between centers of both displacements */
+            kin->accel = (FLT_SQRT(kin->vel_north * kin->vel_north + kin->vel_east * kin->vel_east)
+                          - FLT_SQRT(n * n + e * e))
+                         / dt1;
+            h0 = R2D(FLT_ATAN2(kin->vel_east, kin->vel_north));
+            h1 = R2D(FLT_ATAN2(e, n));
+            dh = h0 - h1;
+            if (dh > FLT(180)) {
+                dh -= FLT(360);
+            } else if (dh < FLT(-180)) {
+                dh += FLT(360);
+            }
+            kin->turn_rate = dh / dt1;
+        }
+    }
+
+    /* Smoothed heading is direction of total displacement over the history */
+    fo = lwgps_history_get(ghandle, ghandle->hist.count - 1);
+    prv_local_offset(fo->latitude, fo->longitude, f0->latitude, f0->longitude, &n, &e);
+    kin->heading = R2D(FLT_ATAN2(e, n));
+    if (kin->heading < 0) {
+        kin->heading += FLT(360);
+    }
+    return 1;
+}
+
+#endif /* LWGPS_CFG_HISTORY || __DOXYGEN__ */
 
 /**
  * \brief           Convert NMEA GPS speed (in knots = nautical mile per hour) to different speed format